@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/* Minimum items_per_second per benchmark name, one "name value" pair per
+ * line, '#' starts a comment */
+using Thresholds = std::map<std::string, double>;
+
+bool readThresholds(const std::string &path, Thresholds &out) {
+  std::ifstream file{path};
+  if (!file) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields{line};
+    std::string name;
+    double minimum{0};
+    if (fields >> name >> minimum) {
+      out[name] = minimum;
+    }
+  }
+  return true;
+}
+
+/* Console output as usual, plus a check of every run against its minimum */
+class ThresholdReporter : public benchmark::ConsoleReporter {
+ public:
+  explicit ThresholdReporter(Thresholds thresholds)
+      : thresholds_(std::move(thresholds)) {}
+
+  void ReportRuns(const std::vector<Run> &runs) override {
+    ConsoleReporter::ReportRuns(runs);
+    for (const auto &run : runs) {
+      const auto threshold = thresholds_.find(run.benchmark_name());
+      if (run.run_type != Run::RT_Iteration ||
+          threshold == thresholds_.end()) {
+        continue;
+      }
+      seen_[threshold->first] = true;
+      const auto rate = run.counters.find("items_per_second");
+      const double value = rate == run.counters.end() ? 0 : rate->second.value;
+      if (value < threshold->second) {
+        std::cerr << "FAILED " << threshold->first << ": " << value
+                  << " items/s, expected at least " << threshold->second
+                  << '\n';
+        ++failures_;
+      }
+    }
+  }
+
+  /* Regressions plus thresholds whose benchmark never ran */
+  [[nodiscard]] int failures() const {
+    int missing{0};
+    for (const auto &threshold : thresholds_) {
+      if (seen_.count(threshold.first) == 0) {
+        std::cerr << "MISSING " << threshold.first << '\n';
+        ++missing;
+      }
+    }
+    return failures_ + missing;
+  }
+
+  /* Runs only the benchmarks that have a threshold */
+  [[nodiscard]] std::string filter() const {
+    if (thresholds_.empty()) {
+      return ".";
+    }
+    std::string pattern{"^("};
+    for (const auto &threshold : thresholds_) {
+      pattern += threshold.first + '|';
+    }
+    pattern.back() = ')';
+    return pattern + '$';
+  }
+
+ private:
+  Thresholds thresholds_;
+  std::map<std::string, bool> seen_;
+  int failures_{0};
+};
+
+}  // namespace
+
+/* Google Benchmark main, with an extra --thresholds=<file> option that
+ * turns the run into a pass/fail regression check */
+int main(int argc, char **argv) {
+  constexpr const char *option = "--thresholds=";
+  std::string thresholdsPath;
+  bool filtered{false};
+  std::vector<char *> args;
+  for (int i = 0; i < argc; ++i) {
+    if (std::strncmp(argv[i], option, std::strlen(option)) == 0) {
+      thresholdsPath = argv[i] + std::strlen(option);
+      continue;
+    }
+    filtered = filtered ||
+               std::strncmp(argv[i], "--benchmark_filter=", 19) == 0;
+    args.push_back(argv[i]);
+  }
+
+  Thresholds thresholds;
+  if (!thresholdsPath.empty() &&
+      (!readThresholds(thresholdsPath, thresholds) || thresholds.empty())) {
+    std::cerr << "cannot read thresholds from " << thresholdsPath << '\n';
+    return 1;
+  }
+  const bool checked = !thresholds.empty();
+  ThresholdReporter reporter{std::move(thresholds)};
+  std::string filter = "--benchmark_filter=" + reporter.filter();
+  if (checked && !filtered) {
+    args.push_back(filter.data());
+  }
+
+  int count = static_cast<int>(args.size());
+  benchmark::Initialize(&count, args.data());
+  if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks(&reporter);
+  benchmark::Shutdown();
+  return reporter.failures() == 0 ? 0 : 1;
+}
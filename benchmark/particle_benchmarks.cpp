@@ -0,0 +1,379 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Emitter.hpp"
+#include "ForceField.hpp"
+#include "ParticleSnapshot.hpp"
+#include "ParticleSystem.hpp"
+#include "Rasterizer.hpp"
+#include "detail/ThreadPool.hpp"
+
+namespace {
+
+constexpr float STEP = 1.0F / 50.0F; /*< App step length */
+const sf::Vector2u CANVAS{1400, 1000};
+
+/* 1k to 10M particles, with the flags of each case appended */
+void particleCounts(benchmark::internal::Benchmark *bench,
+                    const std::vector<std::vector<std::int64_t>> &flags) {
+  for (std::int64_t count = 1000; count <= 10000000; count *= 10) {
+    if (flags.empty()) {
+      bench->Args({count});
+    }
+    for (const auto &flag : flags) {
+      std::vector<std::int64_t> args{count};
+      args.insert(args.end(), flag.begin(), flag.end());
+      bench->Args(args);
+    }
+  }
+}
+
+app::ParticleSystem makeSystem(std::size_t count, bool compact = false) {
+  app::ParticleSystem system{CANVAS};
+  system.setSeed(42);
+  system.setCompact(compact);
+  system.emit(count);
+  return system;
+}
+
+/* Particles flung from one point across a wrapping canvas, so emission
+ * order says nothing about where they are, as after a while of play */
+app::ParticleSystem spreadSystem(std::size_t count) {
+  app::ParticleSystem system = makeSystem(count);
+  system.setBoundsMode(app::BoundsMode::WRAP);
+  system.setParticleSpeed(30000.0F);
+  system.update(STEP);
+  system.setParticleSpeed(100.0F);
+  return system;
+}
+
+std::size_t live(const app::ParticleSystem &system) {
+  return static_cast<std::size_t>(system.getNumberOfParticles());
+}
+
+}  // namespace
+
+/* Work is spread over the thread pool, so every case is timed in wall-clock
+ * time; CPU time of the calling thread would overstate throughput */
+
+/* Bulk emission into an empty system */
+void BM_Emit(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  app::ParticleSystem system{CANVAS};
+  system.setSeed(42);
+  for (auto _ : state) {
+    state.PauseTiming();
+    system.clear();
+    state.ResumeTiming();
+    system.emit(count);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(count));
+}
+BENCHMARK(BM_Emit)
+    ->Apply([](auto *bench) { particleCounts(bench, {}); })
+    ->ArgNames({"particles"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/* Steady-state update, refilled off the clock once a quarter has died;
+ * optionally on the compact, quantized particle state */
+void BM_Update(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  auto system = makeSystem(count, state.range(3) != 0);
+  if (state.range(1) != 0) {
+    system.setDissolve();
+    system.setDissolutionRate(1);
+  }
+  if (state.range(2) != 0) {
+    system.setGravity(0.0F, 0.5F);
+  }
+  std::int64_t processed{0};
+  for (auto _ : state) {
+    processed += static_cast<std::int64_t>(live(system));
+    system.update(STEP);
+    if (live(system) < count - count / 4) {
+      state.PauseTiming();
+      system.emit(count - live(system));
+      state.ResumeTiming();
+    }
+  }
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(BM_Update)
+    ->Apply([](auto *bench) {
+      particleCounts(bench, {{0, 0, 0},
+                             {1, 0, 0},
+                             {0, 1, 0},
+                             {1, 1, 0},
+                             {0, 0, 1},
+                             {1, 1, 1}});
+    })
+    ->ArgNames({"particles", "dissolve", "gravity", "compact"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/* Most particles leave a tiny canvas within one step */
+void BM_UpdateCulling(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  app::ParticleSystem system{sf::Vector2u{16, 16}};
+  system.setSeed(42);
+  system.setParticleSpeed(4000.0F);
+  std::int64_t processed{0};
+  for (auto _ : state) {
+    state.PauseTiming();
+    system.emit(count - live(system));
+    state.ResumeTiming();
+    processed += static_cast<std::int64_t>(count);
+    system.update(STEP);
+  }
+  state.counters["survivors"] = static_cast<double>(live(system));
+  state.SetItemsProcessed(processed);
+}
+BENCHMARK(BM_UpdateCulling)
+    ->Apply([](auto *bench) { particleCounts(bench, {}); })
+    ->ArgNames({"particles"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/* The same number of particles split over 1 to 1000 emitters; time should
+ * follow the particle count, not the emitter count */
+void BM_EmitterCount(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const auto sources = static_cast<std::size_t>(state.range(1));
+  std::vector<app::Emitter> emitters(sources);
+  for (std::size_t i = 0; i < sources; ++i) {
+    emitters[i].position = {static_cast<float>(i % CANVAS.x),
+                            static_cast<float>(i / CANVAS.x)};
+  }
+  const std::vector<std::size_t> counts(sources, count / sources);
+  app::ParticleSystem system{CANVAS};
+  system.setSeed(42);
+  for (auto _ : state) {
+    state.PauseTiming();
+    system.clear();
+    state.ResumeTiming();
+    system.emit(emitters, counts);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(count));
+}
+BENCHMARK(BM_EmitterCount)
+    ->ArgsProduct({{100000, 1000000}, {1, 10, 100, 1000}})
+    ->ArgNames({"particles", "emitters"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/* One step with a pairwise force, particles spread over the whole canvas;
+ * compare with BM_Update for the cost of the grid and the force pass */
+void BM_PairForces(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  app::ParticleSystem reference{CANVAS};
+  reference.setSeed(42);
+  for (unsigned blob = 0; blob < 100; ++blob) {
+    reference.setPosition(static_cast<float>(70 + 140 * (blob % 10)),
+                          static_cast<float>(50 + 100 * (blob / 10)));
+    reference.emit(count / 100);
+  }
+  reference.setParticleSpeed(1500.0F);
+  reference.update(STEP);
+  reference.setParticleSpeed(100.0F);
+  reference.addPairForce(
+      {static_cast<app::PairForceType>(state.range(1)), 4.0F, 1.0F});
+  if (state.range(2) != 0) {
+    reference.sortSpatially();
+  }
+
+  app::ParticleSystem system{reference};
+  for (auto _ : state) {
+    state.PauseTiming();
+    system = reference;
+    state.ResumeTiming();
+    system.update(STEP);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(live(reference)));
+}
+BENCHMARK(BM_PairForces)
+    ->ArgsProduct({{1000, 10000, 100000, 200000, 1000000}, {0, 1, 2}, {0, 1}})
+    ->ArgNames({"particles", "force", "sorted"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/* One step with N fields of one type; field_cost is the time per field
+ * and million particles, including the integration the fields share */
+void BM_ForceFields(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const auto type = static_cast<app::ForceFieldType>(state.range(1));
+  const auto fields = static_cast<std::size_t>(state.range(2));
+  app::ParticleSystem reference = makeSystem(count);
+  reference.setParticleSpeed(0.0F); /* Nobody leaves, nothing is culled */
+  for (std::size_t i = 0; i < fields; ++i) {
+    const auto offset = static_cast<float>(i * 50);
+    reference.addForceField({type, {200.0F + offset, 300.0F + offset},
+                             1.0F, 0.0F, 0.01F});
+  }
+  app::ParticleSystem system{reference};
+  for (auto _ : state) {
+    system.update(STEP);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(live(system)));
+  state.counters["field_cost"] = benchmark::Counter(
+      static_cast<double>(fields) * static_cast<double>(count) / 1e6,
+      benchmark::Counter::kIsIterationInvariantRate |
+          benchmark::Counter::kInvert);
+}
+BENCHMARK(BM_ForceFields)
+    ->ArgsProduct({{1000000}, {0, 1, 2, 3}, {1, 4, 16}})
+    ->ArgNames({"particles", "type", "fields"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/* Vertex hand-off from the simulation to the render thread, packed when
+ * compact */
+void BM_Snapshot(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  auto system = makeSystem(count, state.range(1) != 0);
+  system.update(STEP);
+  app::ParticleSnapshot snapshot;
+  for (auto _ : state) {
+    system.snapshot(snapshot);
+    benchmark::DoNotOptimize(snapshot.size());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(live(system)));
+}
+BENCHMARK(BM_Snapshot)
+    ->Apply([](auto *bench) { particleCounts(bench, {{0}, {1}}); })
+    ->ArgNames({"particles", "compact"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/* Render-side vertex buffer preparation between two steps, which expands
+ * packed snapshots */
+void BM_Interpolate(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  auto system = makeSystem(count, state.range(1) != 0);
+  system.update(STEP);
+  app::ParticleSnapshot snapshot;
+  system.snapshot(snapshot);
+  std::vector<sf::Vertex> vertices;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(snapshot.interpolate(0.5F, vertices).data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(snapshot.size()));
+}
+BENCHMARK(BM_Interpolate)
+    ->Apply([](auto *bench) { particleCounts(bench, {{0}, {1}}); })
+    ->ArgNames({"particles", "compact"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/* CPU splatting of the live particles into a window-sized framebuffer,
+ * optionally after a spatial sort */
+void BM_Rasterize(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  auto system = spreadSystem(count);
+  if (state.range(1) != 0) {
+    system.sortSpatially();
+  }
+  app::Rasterizer rasterizer{CANVAS};
+  for (auto _ : state) {
+    rasterizer.clear();
+    rasterizer.draw(system.getParticles());
+    benchmark::DoNotOptimize(rasterizer.getPixels().data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(live(system)));
+}
+BENCHMARK(BM_Rasterize)
+    ->Apply([](auto *bench) { particleCounts(bench, {{0}, {1}}); })
+    ->ArgNames({"particles", "sorted"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/* One spatial sort of spread out particles; compare with the sorted:1
+ * cases of BM_PairForces and BM_Rasterize for what it buys them */
+void BM_SpatialSort(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const app::ParticleSystem reference = spreadSystem(count);
+  app::ParticleSystem system{reference};
+  for (auto _ : state) {
+    state.PauseTiming();
+    system = reference;
+    state.ResumeTiming();
+    system.sortSpatially();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(live(reference)));
+  state.counters["disorder"] = static_cast<double>(reference.getDisorder());
+}
+BENCHMARK(BM_SpatialSort)
+    ->Apply([](auto *bench) { particleCounts(bench, {}); })
+    ->ArgNames({"particles"})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/* Steady-state steps with a repulsion force on a pool of each size, once
+ * over the whole canvas and once sharded into one strip per worker;
+ * efficiency is throughput per thread relative to the 1-thread case */
+void BM_ShardScaling(benchmark::State &state) {
+  const auto count = static_cast<std::size_t>(state.range(0));
+  const auto threads = static_cast<std::size_t>(state.range(1));
+  const bool sharded = state.range(2) != 0;
+  app::ThreadPool pool{threads};
+  app::ParticleSystem system = spreadSystem(count);
+  system.setThreadPool(pool);
+  system.addPairForce({app::PairForceType::REPULSION, 4.0F, 1.0F});
+  system.setShards(sharded ? std::max<std::size_t>(threads, 2) : 0);
+  system.update(STEP);
+
+  using Clock = std::chrono::steady_clock;
+  std::int64_t processed{0};
+  const auto start = Clock::now();
+  for (auto _ : state) {
+    processed += static_cast<std::int64_t>(live(system));
+    system.update(STEP);
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  state.SetItemsProcessed(processed);
+
+  /* Filled by the 1-thread case, which runs first */
+  static std::map<std::pair<std::size_t, bool>, double> baseline;
+  const double rate = static_cast<double>(processed) / elapsed.count();
+  if (threads == 1) {
+    baseline[{count, sharded}] = rate;
+  }
+  const auto single = baseline.find({count, sharded});
+  if (single != baseline.end()) {
+    state.counters["efficiency"] =
+        rate / (static_cast<double>(threads) * single->second);
+  }
+}
+BENCHMARK(BM_ShardScaling)
+    ->Apply([](auto *bench) {
+      /* Powers of two up to all cores, and all cores */
+      const auto cores = static_cast<std::int64_t>(
+          std::max(1U, std::thread::hardware_concurrency()));
+      for (std::int64_t threads = 1; threads < cores * 2; threads *= 2) {
+        const std::int64_t used = std::min(threads, cores);
+        for (const std::int64_t sharded : {0, 1}) {
+          bench->Args({1000000, used, sharded});
+        }
+      }
+    })
+    ->ArgNames({"particles", "threads", "sharded"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -6,37 +6,62 @@
 
 #include "App.hpp"
 
+#include <spdlog/fmt/fmt.h>  // for format_to
+
+#include <SFML/Graphics/PrimitiveType.hpp>  // for Points
+#include <SFML/System/Sleep.hpp>            // for sleep
+#include <algorithm>                        // for clamp, max, min
+#include <array>                            // for array
+#include <chrono>                           // for system_clock
 #include <cmath>
-#include <future>
+#include <cstddef>  // for size_t
+#include <cstdlib>  // for getenv, strtof, strtoul
+#include <iterator>  // for back_inserter
 #include <memory>
-#include <sstream>  // for operator<<, basic_ostream
+#include <string>  // for string
 
 #include "detail/Core.hpp"  // for create_ref
 #include "detail/Log.hpp"
+#include "detail/Profiler.hpp"  // for Profiler, APP_PROFILE_SCOPE
+#include "detail/ThreadPool.hpp"  // for ThreadPool
 
 namespace app {
 
 int App::Run() {
-  sf::Clock timer;
-  sf::Uint32 nextUpdate =
-      static_cast<unsigned int>(timer.getElapsedTime().asMilliseconds());
+  /* Simulation runs on its own thread; this thread handles the window */
+  simThread_ = std::thread([this]() { Simulate(); });
+  APP_PROFILE_THREAD("main");
   while (running_) {
+    APP_PROFILE_SCOPE("App::frame");
     UpdateFPS();
-    sf::Uint32 frameSkips = 0;
-    while (timer.getElapsedTime().asMilliseconds() >
-               static_cast<sf::Uint8>(nextUpdate) &&
-           frameSkips < MAX_UPDATE_SKIP) {
-      UpdateSFMLEvents();
-      Update();
-      frameSkips++;
-      nextUpdate += UPDATE_STEP;
-    }
+    UpdateSFMLEvents();
     Draw();
+    frameArena_.reset();
   }
+  simThread_.join();
   return 0;
 }
 
+void App::Simulate() {
+  APP_PROFILE_THREAD("simulation");
+  sf::Clock timer;
+  while (running_) {
+    const sf::Uint32 steps = scheduler_.advance(timer.restart());
+    for (sf::Uint32 i = 0; i < steps; ++i) {
+      Update();
+    }
+    pendingSteps_ += steps;
+    droppedMicros_ = scheduler_.getDroppedTime().asMicroseconds();
+    if (steps == 0) {
+      sf::sleep(scheduler_.getTimeToNextStep());
+    }
+  }
+}
+
 void App::UpdateSFMLEvents() {
+  APP_PROFILE_SCOPE("App::events");
+  /* Input never touches the simulation: it reads inputView_ and queues
+   * commands the simulation thread applies at its next step */
   sf::Event event{};
   while (window_->pollEvent(event)) {
     switch (event.type) {
@@ -58,7 +83,7 @@ void App::UpdateSFMLEvents() {
         }
         if (event.key.code == sf::Keyboard::F) {
           static bool fullscreen{true};
-          std::vector<sf::VideoMode> modes =
+          const std::vector<sf::VideoMode> &modes =
               sf::VideoMode::getFullscreenModes();
           window_->create(
               sf::VideoMode{modes[0].width, modes[0].height,
@@ -72,31 +97,124 @@ void App::UpdateSFMLEvents() {
           window_->setVerticalSyncEnabled(true);
         }
         if (event.key.code == sf::Keyboard::Space) {
-          particleSystem_->setDissolve();
+          Send(Command::setDissolve(!inputView_->getDissolve()));
         }
         if (event.key.code == sf::Keyboard::A) {
-          if (particleSystem_->getDissolutionRate() > 0) {
-            particleSystem_->setDissolutionRate(static_cast<sf::Uint8>(
-                particleSystem_->getDissolutionRate() - 1));
+          if (inputView_->getDissolutionRate() > 0) {
+            Send(Command::setDissolutionRate(static_cast<sf::Uint8>(
+                inputView_->getDissolutionRate() - 1)));
           }
         }
         if (event.key.code == sf::Keyboard::S) {
-          particleSystem_->setDissolutionRate(static_cast<sf::Uint8>(
-              particleSystem_->getDissolutionRate() + 1));
+          Send(Command::setDissolutionRate(static_cast<sf::Uint8>(
+              inputView_->getDissolutionRate() + 1)));
         }
         if (event.key.code == sf::Keyboard::W) {
-          particleSystem_->setParticleSpeed(
-              particleSystem_->getParticleSpeed() +
-              particleSystem_->getParticleSpeed() * 0.1F);
+          Send(Command::setSpeed(inputView_->getParticleSpeed() +
+                                 inputView_->getParticleSpeed() * 0.1F));
         }
         if (event.key.code == sf::Keyboard::Q &&
-            particleSystem_->getParticleSpeed() > 0) {
-          particleSystem_->setParticleSpeed(
-              particleSystem_->getParticleSpeed() -
-              particleSystem_->getParticleSpeed() * 0.1F);
+            inputView_->getParticleSpeed() > 0) {
+          Send(Command::setSpeed(inputView_->getParticleSpeed() -
+                                 inputView_->getParticleSpeed() * 0.1F));
         }
         if (event.key.code == sf::Keyboard::E) {
-          particleSystem_->setDistribution();
+          Send(Command::setShape(static_cast<Shape>(
+              (static_cast<int>(inputView_->getShape()) + 1) % 2)));
+        }
+        if (event.key.code == sf::Keyboard::R) {
+          recordToggle_ = true;
+        }
+        if (event.key.code == sf::Keyboard::V) {
+          ToggleCapture();
+        }
+        if (event.key.code == sf::Keyboard::G) {
+          ToggleBudget();
+        }
+        if (event.key.code == sf::Keyboard::L) {
+          /* Cycle fade -> fire -> ice over the particle lifetime */
+          const LifetimeCurves &curves = inputView_->getLifetimeCurves();
+          Send(Command::setCurves(curves == LifetimeCurves::fade()
+                                      ? LifetimeCurves::fire()
+                                  : curves == LifetimeCurves::fire()
+                                      ? LifetimeCurves::ice()
+                                      : LifetimeCurves::fade()));
+        }
+        if (event.key.code == sf::Keyboard::Z) {
+          const bool sorting = inputView_->getSpatialSort();
+          Send(Command::setSpatialSort(sorting ? 0 : SORT_INTERVAL,
+                                       sorting ? 0.0F : SORT_DISORDER));
+        }
+        if (event.key.code == sf::Keyboard::X) {
+          Send(Command::setCompact(!inputView_->getCompact()));
+        }
+        if (event.key.code == sf::Keyboard::H) {
+          /* One strip per worker, at least two */
+          const std::size_t shards =
+              std::max<std::size_t>(2, ThreadPool::instance().concurrency());
+          Send(Command::setShards(static_cast<std::uint32_t>(
+              inputView_->getShards() == 0 ? shards : 0)));
+        }
+        if (event.key.code == sf::Keyboard::I) {
+          interpolate_ = !interpolate_;
+        }
+        if (event.key.code == sf::Keyboard::O) {
+          /* Cycle drop new -> recycle oldest -> recycle most transparent */
+          Send(Command::setOverflow(static_cast<OverflowPolicy>(
+              (static_cast<int>(inputView_->getOverflowPolicy()) + 1) %
+              3)));
+        }
+        if (event.key.code == sf::Keyboard::B) {
+          /* Cycle cull -> wrap -> bounce at the window edges */
+          Send(Command::setBounds(static_cast<BoundsMode>(
+              (static_cast<int>(inputView_->getBoundsMode()) + 1) %
+              static_cast<int>(BOUNDS_MODES))));
+        }
+        if (event.key.code == sf::Keyboard::P) {
+          ExportProfile();
+        }
+        if (event.key.code == sf::Keyboard::D) {
+          ForceField drag = inputView_->getForceFields()[dragField_];
+          drag.strength = drag.strength == 0 ? 1.5F : 0.0F;
+          Send(Command::setField(static_cast<std::uint32_t>(dragField_),
+                                 drag));
+        }
+        if (event.key.code == sf::Keyboard::N) {
+          ForceField noise = inputView_->getForceFields()[noiseField_];
+          noise.strength = noise.strength == 0 ? 2.0F : 0.0F;
+          Send(Command::setField(static_cast<std::uint32_t>(noiseField_),
+                                 noise));
+        }
+        if (event.key.code == sf::Keyboard::M) {
+          /* Drop an emitter at the cursor, each one in its own colors */
+          static const std::array<sf::Color, 6> palette{
+              sf::Color::Red,  sf::Color::Green,   sf::Color::Blue,
+              sf::Color::Cyan, sf::Color::Magenta, sf::Color::Yellow};
+          const sf::Color &color =
+              palette[inputEmitters_.size() % palette.size()];
+          Emitter emitter;
+          emitter.position = window_->mapPixelToCoords(
+              sf::Mouse::getPosition(*window_));
+          emitter.rate = EMITTER_RATE;
+          emitter.colorMin = sf::Color{static_cast<sf::Uint8>(color.r / 2),
+                                       static_cast<sf::Uint8>(color.g / 2),
+                                       static_cast<sf::Uint8>(color.b / 2)};
+          emitter.colorMax = color;
+          Send(Command::addEmitter(emitter));
+        }
+        if (event.key.code == sf::Keyboard::K) {
+          Send(Command::clearEmitters());
+        }
+        if (event.key.code == sf::Keyboard::C) {
+          /* Cycle off -> repulsion -> cohesion -> collision -> off */
+          const auto &forces = inputView_->getPairForces();
+          const int next =
+              forces.empty() ? 0 : static_cast<int>(forces.front().type) + 1;
+          Send(Command::clearPairForces());
+          if (next < 3) {
+            Send(Command::addPairForce(
+                PairForce{static_cast<PairForceType>(next), 6.0F, 2.0F}));
+          }
         }
         break;
       }
@@ -105,69 +223,250 @@ void App::UpdateSFMLEvents() {
     }
   }
 
-  auto f2 = std::async(std::launch::async, [&]() {
-    /* Mouse Input */
-    /* Set the position to match the mouse location */
-    sf::Vector2f mousePos =
-        window_->mapPixelToCoords(sf::Mouse::getPosition(*window_));
+  /* Mouse Input */
+  /* Set the position to match the mouse location */
+  sf::Vector2f mousePos =
+      window_->mapPixelToCoords(sf::Mouse::getPosition(*window_));
 
-    /* Update Particle Emitter to Mouse Position */
-    if (mousePos.x > 0 || mousePos.y > 0 ||
-        mousePos.x < static_cast<float>(window_->getSize().x) ||
-        mousePos.y < static_cast<float>(window_->getSize().y)) {
-      particleSystem_->setPosition(mousePos);
-    }
-    /* Mouse Clicks */
-    if (sf::Mouse::isButtonPressed(sf::Mouse::Left)) {
-      particleSystem_->fuel(50);
-    }
-    if (sf::Mouse::isButtonPressed(sf::Mouse::Right)) {
-      sf::Vector2f newGravity = lastMousePos_ - mousePos;
-      newGravity *= 0.75F;
-      particleSystem_->setGravity(newGravity);
+  /* Update Particle Emitter to Mouse Position; unchanged input is not
+   * applied again, which keeps session logs small */
+  if ((mousePos.x > 0 || mousePos.y > 0 ||
+       mousePos.x < static_cast<float>(window_->getSize().x) ||
+       mousePos.y < static_cast<float>(window_->getSize().y)) &&
+      mousePos != inputView_->getPosition()) {
+    Send(Command::setPosition(mousePos));
+  }
+  /* Mouse Clicks */
+  const bool shift = sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) ||
+                     sf::Keyboard::isKeyPressed(sf::Keyboard::RShift);
+  const bool control = sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) ||
+                       sf::Keyboard::isKeyPressed(sf::Keyboard::RControl);
+  const bool left = sf::Mouse::isButtonPressed(sf::Mouse::Left);
+  const bool right = sf::Mouse::isButtonPressed(sf::Mouse::Right);
+  /* Shift+Left attracts, Ctrl+Left repels, Shift+Right spins a vortex */
+  ForceField mouseField{ForceFieldType::ATTRACTOR, mousePos, 0.0F,
+                        MOUSE_FIELD_RADIUS};
+  if (left && (shift || control)) {
+    mouseField.strength = shift ? MOUSE_FIELD_STRENGTH : -MOUSE_FIELD_STRENGTH;
+  } else if (right && shift) {
+    mouseField.type = ForceFieldType::VORTEX;
+    mouseField.strength = MOUSE_FIELD_STRENGTH;
+  }
+  const ForceField &current = inputView_->getForceFields()[mouseField_];
+  if (mouseField.strength != current.strength ||
+      (mouseField.strength != 0 && (mouseField.type != current.type ||
+                                    mouseField.position != current.position))) {
+    Send(Command::setField(static_cast<std::uint32_t>(mouseField_),
+                           mouseField));
+  }
+  if (left && !shift && !control) {
+    /* Clicking on keeps adding load, the budget tapers it off */
+    const auto fuel = budgeting_
+                          ? static_cast<std::uint32_t>(std::lround(
+                                static_cast<float>(FUEL) *
+                                budget_.getEmissionScale()))
+                          : FUEL;
+    if (fuel > 0) {
+      Send(Command::emit(fuel));
     }
-    if (sf::Mouse::isButtonPressed(sf::Mouse::Middle)) {
-      particleSystem_->setGravity(0.0F, 0.0F);
+  }
+  if (right && !shift) {
+    sf::Vector2f newGravity = lastMousePos_ - mousePos;
+    newGravity *= 0.75F;
+    if (newGravity != inputView_->getGravity()) {
+      Send(Command::setGravity(newGravity));
     }
+  }
+  if (sf::Mouse::isButtonPressed(sf::Mouse::Middle) &&
+      inputView_->getGravity() != sf::Vector2f{}) {
+    Send(Command::setGravity(sf::Vector2f{}));
+  }
 
-    /* Update Last Mouse Position */
-    lastMousePos_ = mousePos;
+  /* Update Last Mouse Position */
+  lastMousePos_ = mousePos;
 
-    /* Push Diag Text */
-    std::ostringstream buffer;
-    buffer << "Q/W to Decrease/Increase Particle Speed\n"
-           << "A/S to Decrease/Increase Decay Rate\n"
-           << "F to Toggle Fullscreen\n"
-           << "Right Click+Drag to Shift Gravity\n"
-           << "E to Change Distribution Type\n"
-           << "Middle Click clears Gravity\n"
-           << "Left Click to Add\n"
-           << "Frames per Second (FPS): " << fps_ << "\n"
-           << "Particles: " << particleSystem_->getNumberOfParticles();
-    text_->setString(buffer.str());
-  });
+  if (budgeting_) {
+    UpdateBudget();
+  }
+
+  /* Push Diag Text, a few times per second so it stays readable */
+  if (hudClock_.getElapsedTime() < HUD_REFRESH) {
+    return;
+  }
+  hudClock_.restart();
+  status_.update();
+  const SimulationStatus &status = status_.front();
+  const PoolStats &pool = status.pool;
+  hudText_.clear();
+  /* Optional parts are appended one by one, formatting straight into the
+   * buffer */
+  const auto out = std::back_inserter(hudText_);
+  fmt::format_to(out,
+                 "Q/W to Decrease/Increase Particle Speed\n"
+                 "A/S to Decrease/Increase Decay Rate\n"
+                 "F to Toggle Fullscreen\n"
+                 "Right Click+Drag to Shift Gravity\n"
+                 "E to Change Distribution Type\n"
+                 "Middle Click clears Gravity\n"
+                 "Left Click to Add\n"
+                 "Shift/Ctrl+Left Click to Attract/Repel\n"
+                 "Shift+Right Click to Spin a Vortex\n"
+                 "D/N to Toggle Drag/Turbulence\n"
+                 "M to Place an Emitter, K to Remove All\n"
+                 "L to Cycle Lifetime Colors\n"
+                 "Z to Toggle Spatial Sorting\n"
+                 "X to Toggle Compact Particle State\n"
+                 "H to Toggle Sharded Simulation\n"
+                 "I to Toggle Interpolation\n"
+                 "O to Change Overflow Policy\n"
+                 "B to Cycle Cull/Wrap/Bounce at the Edges\n"
+                 "P to Export Profile Trace\n"
+                 "C to Cycle Particle Interaction\n"
+                 "G to Toggle the Frame Budget\n"
+                 "R to Start/Stop Recording the Session");
+  if (status.recording) {
+    fmt::format_to(out, " ({} steps, {} KiB)", status.recordedSteps,
+                   status.recordedBytes / 1024);
+  }
+  fmt::format_to(out, "\nV to Start/Stop Capturing Frames");
+  if (capture_.isRunning()) {
+    fmt::format_to(out, " ({} written, {} dropped)",
+                   capture_.getStats().written, capture_.getStats().dropped);
+  }
+  fmt::format_to(out,
+                 "\nFrames per Second (FPS): {}\n"
+                 "Steps/Frame: {}  Dropped: {} ms  Render: {} us\n"
+                 "Particles: {} / {}  Emitters: {}\n"
+                 "Pool: {} allocated  {} recycled  {} dropped  {} culled\n"
+                 "Budget: ",
+                 fps_, frameStats_.simSteps,
+                 frameStats_.droppedTime.asMilliseconds(),
+                 frameStats_.renderTime.asMicroseconds(),
+                 snapshots_.front().size(), status.capacity,
+                 inputEmitters_.size(), pool.allocated, pool.recycled,
+                 pool.dropped, pool.culled);
+  if (budgeting_) {
+    fmt::format_to(out,
+                   "{:.0f}% of {:.1f} ms, {}  Limit: {}  "
+                   "Emission: {:.0f}%  Decay: +{}",
+                   budget_.getLoad() * 100,
+                   budget_.getTarget().asSeconds() * 1000,
+                   budgetStateName(budget_.getState()), budget_.getBudget(),
+                   budget_.getEmissionScale() * 100, dissolutionBoost_);
+  } else {
+    fmt::format_to(out, "off");
+  }
+  fmt::format_to(out, "\nSpatial Sort: ");
+  if (inputView_->getSpatialSort()) {
+    fmt::format_to(out, "every {} steps or at {:.0f}%",
+                   inputView_->getSortInterval(),
+                   inputView_->getSortThreshold() * 100);
+  } else {
+    fmt::format_to(out, "off");
+  }
+  fmt::format_to(out, "  Disorder: {:.0f}%\nParticle State: ",
+                 status.disorder * 100);
+  if (inputView_->getCompact()) {
+    fmt::format_to(out, "compact, {} bytes each",
+                   CompactParticleStore::BYTES_PER_PARTICLE);
+  } else {
+    fmt::format_to(out, "full precision");
+  }
+  fmt::format_to(out, "\nShards: ");
+  if (inputView_->getShards() != 0) {
+    fmt::format_to(out, "{} strips, {} migrated", inputView_->getShards(),
+                   status.migrated);
+  } else {
+    fmt::format_to(out, "off");
+  }
+  fmt::format_to(out, "\n");
+  hudText_.append(profileText_.data(),
+                  profileText_.data() + profileText_.size());
+  /* sf::String converts to UTF-32 in SFML's own storage */
+  text_->setString(
+      sf::String::fromUtf8(hudText_.data(), hudText_.data() + hudText_.size()));
 }
 
 void App::Update() {
-  /* Update particle system */
-  auto f2 = std::async(std::launch::async, [&]() {
-    particleSystem_->update(static_cast<float>(UPDATE_STEP) / 1000);
-  });
+  APP_PROFILE_SCOPE("App::step");
+  sf::Clock stepClock;
+  /* Input queued since the last step takes effect at this boundary, so
+   * a step never sees the settings change under it */
+  if (recordToggle_.exchange(false)) {
+    ToggleRecording();
+  }
+  Command command;
+  while (commands_.pop(command)) {
+    Apply(command);
+  }
+
+  /* Update particle system; it spreads the work over the thread pool */
+  const sf::Time step = scheduler_.getStep();
+  emitters_.emit(*particleSystem_, step.asSeconds());
+  particleSystem_->update(step.asSeconds());
+  recorder_.step(*particleSystem_, emitters_);
+
+  /* Hand the finished step over to the render thread. It stands for the
+   * point in time the scheduler has simulated up to */
+  ParticleSnapshot &snapshot = snapshots_.back();
+  particleSystem_->snapshot(snapshot);
+  snapshot.step = scheduler_.getStepCount();
+  snapshot.publishedAt =
+      appClock_.getElapsedTime() - scheduler_.getAccumulatedTime();
+  snapshot.stepLength = step;
+  snapshots_.publish();
+
+  SimulationStatus &status = status_.back();
+  status.pool = particleSystem_->getPoolStats();
+  status.capacity = particleSystem_->getCapacity();
+  status.disorder = particleSystem_->getDisorder();
+  status.migrated = particleSystem_->getMigrated();
+  status.recording = recorder_.isOpen();
+  status.recordedSteps = recorder_.getSteps();
+  status.recordedBytes = recorder_.getBytes();
+  status_.publish();
+  simMicros_ += stepClock.getElapsedTime().asMicroseconds();
 }
 
 void App::Draw() {
+  APP_PROFILE_SCOPE("App::draw");
+  sf::Clock renderClock;
+  /* Pick up the newest finished step, never wait for one */
+  snapshots_.update();
+  const ParticleSnapshot &snapshot = snapshots_.front();
+
   /* Draw particle system and text */
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glGetError();
-  window_->setActive(false);
-  auto f2 = std::async(std::launch::async, [&]() {
-    window_->setActive(true);
-    window_->clear(sf::Color::Black);
-    window_->resetGLStates();
-    window_->draw(*text_);
-    window_->draw(*particleSystem_);
-    window_->display();
-  });
+  window_->clear(sf::Color::Black);
+  window_->resetGLStates();
+  window_->draw(*text_);
+  /* A packed snapshot only becomes vertices here, on the way to the GPU */
+  const std::vector<sf::Vertex> *vertices = nullptr;
+  if (interpolate_) {
+    /* Render alpha: how far real time has moved into the next step */
+    const float alpha =
+        snapshot.stepLength > sf::Time::Zero
+            ? std::clamp((appClock_.getElapsedTime() - snapshot.publishedAt)
+                                 .asSeconds() /
+                             snapshot.stepLength.asSeconds(),
+                         0.0F, 1.0F)
+            : 1.0F;
+    APP_PROFILE_SCOPE("App::interpolate");
+    vertices = &snapshot.interpolate(alpha, drawVertices_);
+  } else {
+    vertices = &snapshot.current(drawVertices_);
+  }
+  if (!vertices->empty()) {
+    window_->draw(vertices->data(), vertices->size(), sf::Points);
+  }
+  /* Hand the points to the capture writers; a full pool drops the frame */
+  if (capture_.isRunning() &&
+      captureClock_.getElapsedTime() >= CAPTURE_INTERVAL) {
+    captureClock_.restart();
+    capture_.submit(*vertices);
+  }
+  frameStats_.renderTime = renderClock.getElapsedTime();
+  APP_PROFILE_SCOPE("App::display");
+  window_->display();
 }
 
 void App::Setup() {
@@ -175,6 +474,18 @@ void App::Setup() {
     Log::Initialize();
   }
   Log::logger()->trace("program started.");
+  /* PARTICLE_THREADS overrides the size of the shared thread pool */
+  std::size_t threads{0};
+  if (const char *setting = std::getenv("PARTICLE_THREADS")) {
+    threads = std::strtoul(setting, nullptr, 10);
+  }
+  ThreadPool::Initialize(threads);
+  /* PARTICLE_STEP_RATE overrides the simulation steps per second */
+  if (const char *setting = std::getenv("PARTICLE_STEP_RATE")) {
+    scheduler_.setStepRate(std::strtof(setting, nullptr));
+  }
+  Log::logger()->trace("thread pool uses {} threads.",
+                       ThreadPool::instance().concurrency());
   constexpr int windowWidth{1400};
   constexpr int windowHeight{1000};
   window_ = create_scope<sf::RenderWindow>(
@@ -184,6 +495,30 @@ void App::Setup() {
   glEnable(GL_TEXTURE_2D);
   window_->setVerticalSyncEnabled(true);
   particleSystem_ = create_scope<ParticleSystem>(window_->getSize());
+  /* PARTICLE_CAPACITY overrides the live particle limit, 0 = unbounded */
+  std::size_t capacity{PARTICLE_CAPACITY};
+  if (const char *setting = std::getenv("PARTICLE_CAPACITY")) {
+    capacity = std::strtoul(setting, nullptr, 10);
+  }
+  particleSystem_->setCapacity(capacity);
+  particleSystem_->setOverflowPolicy(OverflowPolicy::RECYCLE_OLDEST);
+  /* PARTICLE_FRAME_BUDGET overrides the target frame cost in ms */
+  if (const char *setting = std::getenv("PARTICLE_FRAME_BUDGET")) {
+    budget_.setTarget(sf::seconds(std::strtof(setting, nullptr) / 1000));
+  } else {
+    budget_.setTarget(FRAME_BUDGET);
+  }
+  budget_.setLimits(MIN_BUDGET, capacity);
+  /* Parked fields (strength 0) for the mouse and the toggle keys */
+  mouseField_ = particleSystem_->addForceField(
+      {ForceFieldType::ATTRACTOR, {}, 0.0F, MOUSE_FIELD_RADIUS});
+  dragField_ = particleSystem_->addForceField({ForceFieldType::DRAG, {}, 0.0F});
+  noiseField_ = particleSystem_->addForceField(
+      {ForceFieldType::NOISE, {}, 0.0F, 0.0F, 0.004F});
+  /* Copied before any particle exists; without a capacity it reserves
+   * nothing, whatever mode it is switched to */
+  inputView_ = create_scope<ParticleSystem>(*particleSystem_);
+  inputView_->setCapacity(0);
   particleSystem_->fuel(1000);
   if (!font_.loadFromFile("../../src/detail/fixedsys500c.ttf")) {
     return;
@@ -196,11 +531,146 @@ void App::Setup() {
 
 App::App() { Setup(); }
 
+App::~App() {
+  running_ = false;
+  if (simThread_.joinable()) {
+    simThread_.join();
+  }
+  recorder_.close();
+}
+
 void App::UpdateFPS() {
-  auto f2 = std::async(std::launch::async, [&]() {
-    return std::round(1.f / fpsClock_.restart().asSeconds());
-  });
-  fps_ = f2.get();
+  fps_ = std::round(1.f / fpsClock_.restart().asSeconds());
+
+  /* Collect what the simulation thread did during the last frame */
+  frameStats_.simSteps = pendingSteps_.exchange(0);
+  const sf::Int64 dropped = droppedMicros_;
+  frameStats_.droppedTime = sf::microseconds(dropped - lastDroppedMicros_);
+  lastDroppedMicros_ = dropped;
+  const sf::Int64 simulated = simMicros_;
+  frameStats_.simTime = sf::microseconds(simulated - lastSimMicros_);
+  lastSimMicros_ = simulated;
+
+  /* Phase percentiles are recomputed from the rings once per second */
+  if (profileClock_.getElapsedTime() < sf::seconds(1)) {
+    return;
+  }
+  profileClock_.restart();
+  profileText_.clear();
+  for (const auto &phase : Profiler::summary(frameArena_.resource())) {
+    fmt::format_to(std::back_inserter(profileText_),
+                   "{} p50/p95/p99: {:.2f}/{:.2f}/{:.2f} ms\n", phase.name,
+                   phase.p50 / 1000.0, phase.p95 / 1000.0, phase.p99 / 1000.0);
+  }
+}
+
+void App::Send(const Command &command) {
+  /* A full queue drops the input; inputView_ only follows what is queued */
+  if (!commands_.push(command)) {
+    Log::logger()->warn("input dropped, {} commands pending.",
+                        commands_.capacity());
+    return;
+  }
+  if (command.type != CommandType::EMIT) {
+    applyCommand(command, *inputView_, inputEmitters_);
+  }
+}
+
+void App::Apply(const Command &command) {
+  applyCommand(command, *particleSystem_, emitters_);
+  recorder_.record(command);
+}
+
+void App::ToggleRecording() {
+  if (recorder_.isOpen()) {
+    recorder_.close();
+    Log::logger()->info("session recorded, {} steps.", recorder_.getSteps());
+    return;
+  }
+  const std::string path = fmt::format(
+      "session-{}.sfrec",
+      std::chrono::system_clock::now().time_since_epoch() /
+          std::chrono::seconds{1});
+  if (recorder_.open(path, *particleSystem_, emitters_,
+                     scheduler_.getStep().asSeconds(), CHECKPOINT_INTERVAL)) {
+    Log::logger()->info("recording session to {}.", path);
+  } else {
+    Log::logger()->error("cannot record session to {}.", path);
+  }
+}
+
+void App::ToggleCapture() {
+  if (capture_.isRunning()) {
+    capture_.stop();
+    const CaptureStats stats = capture_.getStats();
+    Log::logger()->info("capture stopped: {} frames written, {} dropped, "
+                        "{} failed.",
+                        stats.written, stats.dropped, stats.failed);
+    return;
+  }
+  /* PARTICLE_CAPTURE picks the output, e.g. frames/shot.png, out.rgba or
+   * "pipe:ffmpeg -f rawvideo -pix_fmt rgba -s 1400x1000 -r 30 -i - a.mp4" */
+  CaptureSettings settings;
+  const char *target = std::getenv("PARTICLE_CAPTURE");
+  parseCaptureTarget(
+      target != nullptr
+          ? std::string{target}
+          : fmt::format("capture-{}-",
+                        std::chrono::system_clock::now().time_since_epoch() /
+                            std::chrono::seconds{1}),
+      settings);
+  settings.size = window_->getSize();
+  settings.slots = CAPTURE_SLOTS;
+  /* Headroom over today's particles, so the slots rarely have to grow */
+  settings.points = snapshots_.front().size() * 3 / 2;
+  std::string error;
+  if (capture_.start(settings, error)) {
+    captureClock_.restart();
+    Log::logger()->info("capturing frames to {}.", settings.target);
+  } else {
+    Log::logger()->error("cannot capture frames: {}.", error);
+  }
+}
+
+void App::UpdateBudget() {
+  if (!budget_.update(frameStats_.simTime, frameStats_.renderTime,
+                      snapshots_.front().size())) {
+    return;
+  }
+  if (budget_.getBudget() != inputView_->getBudget()) {
+    Send(Command::setBudget(static_cast<std::uint32_t>(budget_.getBudget())));
+  }
+  ApplyDissolutionBoost(budget_.getDissolutionBoost());
+}
+
+void App::ToggleBudget() {
+  budgeting_ = !budgeting_;
+  budget_.reset();
+  /* Off lifts the limit, on starts over from the capacity */
+  if (inputView_->getBudget() != budget_.getBudget()) {
+    Send(Command::setBudget(static_cast<std::uint32_t>(budget_.getBudget())));
+  }
+  ApplyDissolutionBoost(0);
+}
+
+void App::ApplyDissolutionBoost(sf::Uint8 boost) {
+  /* The user may have lowered the rate below the boost meanwhile */
+  const int base =
+      std::max(inputView_->getDissolutionRate() - dissolutionBoost_, 0);
+  const int rate = std::min(base + boost, 255);
+  if (rate != inputView_->getDissolutionRate()) {
+    Send(Command::setDissolutionRate(static_cast<std::uint32_t>(rate)));
+  }
+  dissolutionBoost_ = static_cast<sf::Uint8>(rate - base);
+}
+
+void App::ExportProfile() {
+  constexpr const char *path = "profile.json";
+  if (Profiler::exportChromeTrace(path)) {
+    Log::logger()->info("profile trace written to {}.", path);
+  } else {
+    Log::logger()->error("cannot write profile trace to {}.", path);
+  }
 }
 
 }  // namespace app
\ No newline at end of file
@@ -17,34 +17,135 @@
 #include <SFML/Window/Keyboard.hpp>   // for Keyboard, Keyboard::A, Key...
 #include <SFML/Window/Mouse.hpp>      // for Mouse, Mouse::Left, Mouse:...
 #include <SFML/Window/VideoMode.hpp>  // for VideoMode
+#include <atomic>                     // for atomic
+#include <cstdint>                    // for uint64_t
 #include <memory>
+#include <spdlog/fmt/fmt.h>  // for memory_buffer
+#include <thread>            // for thread
+#include <vector>            // for vector
 
-#include "ParticleSystem.hpp"  // for ParticleSystem
-#include "detail/Core.hpp"     // for create_ref
+#include "BudgetController.hpp"           // for BudgetController
+#include "Command.hpp"                    // for Command
+#include "EmitterManager.hpp"             // for EmitterManager
+#include "FrameCapture.hpp"               // for FrameCapture
+#include "ParticleSnapshot.hpp"           // for ParticleSnapshot
+#include "ParticleSystem.hpp"             // for ParticleSystem
+#include "Recording.hpp"                  // for Recorder
+#include "detail/Core.hpp"                // for create_ref
+#include "detail/FixedStepScheduler.hpp"  // for FixedStepScheduler
+#include "detail/FrameArena.hpp"          // for FrameArena
+#include "detail/SpscQueue.hpp"           // for SpscQueue
+#include "detail/TripleBuffer.hpp"        // for TripleBuffer
 
 namespace app {
 
+/* What the HUD shows of the simulation thread, published after each step */
+struct SimulationStatus {
+  PoolStats pool;
+  std::size_t capacity{0};
+  float disorder{0}; /*< Sampled, 0 = in Z-order */
+  std::size_t migrated{0}; /*< Particles that changed shards */
+  bool recording{false};
+  std::uint64_t recordedSteps{0};
+  std::uint64_t recordedBytes{0};
+};
+
 class App {
  public:
   App();
+  App(const App &) = delete;
+  App(App &&) = delete;
+  App &operator=(const App &) = delete;
+  App &operator=(App &&) = delete;
+  ~App();
   int Run();
 
  private:
   void Setup();
+  void Simulate(); /*< Simulation thread body */
   void Update();
   void Draw();
   void UpdateSFMLEvents();
   void UpdateFPS();
+  void ExportProfile(); /*< Chrome trace of the profiler rings */
+  /* Queues input for the next simulation step and applies it to
+   * inputView_. Input thread only. */
+  void Send(const Command &command);
+  /* Applies input to the simulation and logs it while recording.
+   * Simulation thread only. */
+  void Apply(const Command &command);
+  /* Starts or stops a session log. Simulation thread only; R asks for it
+   * through recordToggle_. */
+  void ToggleRecording();
+  void ToggleCapture(); /*< Starts or stops writing frames */
+  /* Feeds the frame budget controller and sends what it decides */
+  void UpdateBudget();
+  void ToggleBudget(); /*< Lifts or reinstates the frame budget */
+  /* Sets the controller's dissolution boost on top of the user's rate */
+  void ApplyDissolutionBoost(sf::Uint8 boost);
   Scope<sf::RenderWindow> window_;
+  /* Owned by the simulation thread once it runs; input reaches them
+   * through commands_ only */
   Scope<ParticleSystem> particleSystem_;
-  bool running_{true};
+  EmitterManager emitters_; /*< Placed with M */
+  Recorder recorder_;       /*< Toggled with R */
+  std::atomic<bool> running_{true};
+  std::thread simThread_;
+  /* Input -> sim hand-off, drained at the start of each step */
+  SpscQueue<Command> commands_{COMMAND_SLOTS};
+  std::atomic<bool> recordToggle_{false}; /*< R pressed, not yet handled */
+  /* The settings as input last set them: a particle-free copy of the
+   * system that Send() applies every command to, so input never reads
+   * state the simulation thread is writing */
+  Scope<ParticleSystem> inputView_;
+  EmitterManager inputEmitters_;
+  TripleBuffer<ParticleSnapshot> snapshots_; /*< Sim -> render hand-off */
+  TripleBuffer<SimulationStatus> status_;    /*< Sim -> HUD hand-off */
+  std::vector<sf::Vertex> drawVertices_;     /*< Interpolated positions */
+  sf::Clock appClock_;
+  bool interpolate_{true};
+  FrameCapture capture_; /*< Toggled with V, render thread only */
+  sf::Clock captureClock_;
+  /* Fixed-step timing, owned by the sim thread */
+  FixedStepScheduler scheduler_{STEP_RATE, MAX_UPDATE_SKIP};
+  std::atomic<sf::Uint32> pendingSteps_{0}; /*< Steps since last frame */
+  std::atomic<sf::Int64> droppedMicros_{0}; /*< Total dropped sim time */
+  sf::Int64 lastDroppedMicros_{0};
+  std::atomic<sf::Int64> simMicros_{0}; /*< Total time spent in steps */
+  sf::Int64 lastSimMicros_{0};
+  FrameStats frameStats_;
+  BudgetController budget_; /*< Holds FRAME_BUDGET, toggled with G */
+  bool budgeting_{true};
+  sf::Uint8 dissolutionBoost_{0};  /*< Part of the rate set by budget_ */
+  FrameArena frameArena_;          /*< Scratch memory, reset after each frame */
+  fmt::memory_buffer hudText_;     /*< Reused HUD text */
+  fmt::memory_buffer profileText_; /*< HUD lines of phase percentiles */
+  sf::Clock hudClock_;
+  sf::Clock profileClock_;
   sf::Font font_;
   Scope<sf::Text> text_;
   sf::Vector2f lastMousePos_;
+  std::size_t mouseField_{0}; /*< Field following the cursor */
+  std::size_t dragField_{0};  /*< Toggled with D */
+  std::size_t noiseField_{0}; /*< Toggled with N */
   sf::Clock fpsClock_;
   float fps_{0};
-  static constexpr sf::Uint32 UPDATE_STEP = 20;
+  static constexpr float STEP_RATE = 50.0F;
   static constexpr sf::Uint32 MAX_UPDATE_SKIP = 5;
+  static constexpr std::size_t PARTICLE_CAPACITY = 2000000;
+  static constexpr std::size_t MIN_BUDGET = 1000; /*< Never culled below */
+  static constexpr std::uint32_t FUEL = 50; /*< Particles per click frame */
+  static inline const sf::Time FRAME_BUDGET = sf::seconds(1.0F / 60);
+  static constexpr float MOUSE_FIELD_STRENGTH = 3.0F;
+  static constexpr float MOUSE_FIELD_RADIUS = 400.0F;
+  static constexpr float EMITTER_RATE = 2000.0F; /*< Particles per second */
+  static constexpr std::uint64_t CHECKPOINT_INTERVAL = 500; /*< Steps */
+  static constexpr std::size_t CAPTURE_SLOTS = 6; /*< Frames in flight */
+  static constexpr std::size_t COMMAND_SLOTS = 1024; /*< Queued input */
+  static constexpr std::uint32_t SORT_INTERVAL = 250; /*< Steps, with Z */
+  static constexpr float SORT_DISORDER = 0.25F; /*< Out of order, with Z */
+  static inline const sf::Time CAPTURE_INTERVAL = sf::seconds(1.0F / 30);
+  static inline const sf::Time HUD_REFRESH = sf::milliseconds(250);
 };
 
 }  // namespace app
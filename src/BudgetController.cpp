@@ -0,0 +1,106 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "BudgetController.hpp"
+
+#include <algorithm>  // for clamp, max, min
+#include <cmath>      // for ceil
+
+namespace app {
+
+/************************************************************/
+const char *budgetStateName(BudgetState state) {
+  switch (state) {
+    case BudgetState::MEASURING:
+      return "measuring";
+    case BudgetState::STEADY:
+      return "steady";
+    case BudgetState::OVER:
+      return "over";
+    case BudgetState::HEADROOM:
+      return "headroom";
+  }
+  return "";
+}
+
+/************************************************************/
+BudgetController::BudgetController(sf::Time target) : target_(target) {}
+
+/************************************************************/
+void BudgetController::setLimits(std::size_t minParticles,
+                                 std::size_t maxParticles) {
+  minParticles_ = minParticles;
+  maxParticles_ = maxParticles;
+  reset();
+}
+
+/************************************************************/
+void BudgetController::reset() {
+  budget_ = maxParticles_;
+  cost_ = 0;
+  measured_ = false;
+  frames_ = 0;
+  boost_ = 0;
+  state_ = BudgetState::MEASURING;
+}
+
+/************************************************************/
+bool BudgetController::update(sf::Time simTime, sf::Time renderTime,
+                              std::size_t particles) {
+  /* Both threads share the cores, so their sum is the honest cost */
+  const float cost = (simTime + renderTime).asSeconds();
+  cost_ = measured_ ? cost_ + SMOOTHING * (cost - cost_) : cost;
+  measured_ = true;
+  /* A change only shows in the smoothed cost a few frames later */
+  if (++frames_ < DECISION_FRAMES) {
+    return false;
+  }
+  frames_ = 0;
+
+  const std::size_t budget = budget_;
+  const sf::Uint8 boost = boost_;
+  const float load = getLoad();
+  if (load > 1.0F && particles > 0) {
+    /* Cost is roughly linear in the particles, so cut to what fits */
+    state_ = BudgetState::OVER;
+    const auto fit = static_cast<std::size_t>(static_cast<float>(particles) *
+                                              HEADROOM / load);
+    budget_ = std::max(fit, minParticles_);
+    if (maxParticles_ != 0) {
+      budget_ = std::min(budget_, maxParticles_);
+    }
+  } else if (load < LOW_WATER) {
+    /* Only a budget that holds particles back is worth raising */
+    state_ = BudgetState::HEADROOM;
+    if (budget_ != 0 && static_cast<float>(particles) >=
+                            static_cast<float>(budget_) * HEADROOM) {
+      const auto grown =
+          static_cast<std::size_t>(static_cast<float>(budget_) * GROWTH) + 1;
+      budget_ = maxParticles_ == 0 ? grown : std::min(grown, maxParticles_);
+    }
+  } else {
+    state_ = BudgetState::STEADY;
+  }
+  const float excess = load - HEADROOM;
+  boost_ = excess > 0 ? static_cast<sf::Uint8>(std::min(
+                            std::ceil(excess * BOOST_GAIN),
+                            static_cast<float>(MAX_BOOST)))
+                      : sf::Uint8{0};
+  return budget_ != budget || boost_ != boost;
+}
+
+/************************************************************/
+float BudgetController::getEmissionScale() const {
+  if (!measured_) {
+    return 1.0F;
+  }
+  return std::clamp((1.0F - getLoad()) / (1.0F - HEADROOM), 0.0F, 1.0F);
+}
+
+/************************************************************/
+float BudgetController::getLoad() const {
+  return target_ > sf::Time::Zero ? cost_ / target_.asSeconds() : 0.0F;
+}
+
+}  // namespace app
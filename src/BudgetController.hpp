@@ -0,0 +1,81 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_BUDGETCONTROLLER_HPP
+#define SFMLTEST_BUDGETCONTROLLER_HPP
+
+#include <SFML/Config.hpp>       // for Uint8
+#include <SFML/System/Time.hpp>  // for Time
+#include <cstddef>               // for size_t
+
+namespace app {
+
+/* What the controller concluded at its last decision */
+enum class BudgetState {
+  MEASURING = 0, /*< No decision yet */
+  STEADY = 1,    /*< Close to the target, nothing to do */
+  OVER = 2,      /*< Over the target, shedding particles */
+  HEADROOM = 3   /*< Well under the target, allowing more */
+};
+
+[[nodiscard]] const char *budgetStateName(BudgetState state);
+
+/* Holds the cost of a frame at a target by steering how many particles may
+ * live. It is fed once per frame with the time spent simulating and drawing
+ * and the particles alive, and smooths the cost over a few frames.
+ *
+ * Every DECISION_FRAMES frames it looks at the smoothed load (cost over
+ * target). Over the target the budget drops straight to the count that the
+ * cost per particle says fits into HEADROOM of it; below LOW_WATER a budget
+ * that is actually binding grows by GROWTH. In between, manual emission is
+ * scaled down and dissolution sped up, which sheds load gently before
+ * anything has to be culled. Nothing depends on the hardware, so the same
+ * settings hold a frame rate on a fast machine and a slow one. */
+class BudgetController {
+ public:
+  explicit BudgetController(sf::Time target = sf::seconds(1.0F / 60));
+
+  void setTarget(sf::Time target) { target_ = target; }
+  /* Range of the budget; maxParticles 0 = unbounded. Also resets. */
+  void setLimits(std::size_t minParticles, std::size_t maxParticles);
+  /* Forgets the measurements and lifts the budget back to the maximum */
+  void reset();
+  /* Feeds one frame; true when the budget or the dissolution boost
+   * changed */
+  bool update(sf::Time simTime, sf::Time renderTime, std::size_t particles);
+
+  [[nodiscard]] sf::Time getTarget() const { return target_; }
+  /* Live particle limit, 0 = none */
+  [[nodiscard]] std::size_t getBudget() const { return budget_; }
+  /* Factor for manually requested emission, 0 to 1 */
+  [[nodiscard]] float getEmissionScale() const;
+  /* Added to the dissolution rate while close to or over the target */
+  [[nodiscard]] sf::Uint8 getDissolutionBoost() const { return boost_; }
+  /* Smoothed frame cost over the target, 1 = exactly on it */
+  [[nodiscard]] float getLoad() const;
+  [[nodiscard]] BudgetState getState() const { return state_; }
+
+  static constexpr float HEADROOM = 0.85F;  /*< Load aimed for */
+  static constexpr float LOW_WATER = 0.7F;  /*< Load below which to grow */
+  static constexpr float GROWTH = 1.2F;     /*< Budget factor per decision */
+  static constexpr float SMOOTHING = 0.2F;  /*< Weight of a new frame */
+  static constexpr int DECISION_FRAMES = 15;
+  static constexpr float BOOST_GAIN = 40.0F; /*< Boost per unit of load */
+  static constexpr sf::Uint8 MAX_BOOST = 16;
+
+ private:
+  sf::Time target_;
+  std::size_t minParticles_{1000};
+  std::size_t maxParticles_{0};
+  std::size_t budget_{0};
+  float cost_{0};         /*< Smoothed frame cost in seconds */
+  bool measured_{false};  /*< cost_ holds a frame */
+  int frames_{0};         /*< Since the last decision */
+  sf::Uint8 boost_{0};
+  BudgetState state_{BudgetState::MEASURING};
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_BUDGETCONTROLLER_HPP
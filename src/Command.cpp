@@ -0,0 +1,247 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "Command.hpp"
+
+#include <SFML/Config.hpp>  // for Uint8
+#include <algorithm>        // for min
+
+#include "EmitterManager.hpp"  // for EmitterManager
+
+namespace app {
+
+/************************************************************/
+Command Command::emit(std::uint32_t count) {
+  Command command;
+  command.type = CommandType::EMIT;
+  command.count = count;
+  return command;
+}
+
+/************************************************************/
+Command Command::setPosition(const sf::Vector2f &position) {
+  Command command;
+  command.type = CommandType::SET_POSITION;
+  command.vector = position;
+  return command;
+}
+
+/************************************************************/
+Command Command::setGravity(const sf::Vector2f &gravity) {
+  Command command;
+  command.type = CommandType::SET_GRAVITY;
+  command.vector = gravity;
+  return command;
+}
+
+/************************************************************/
+Command Command::setDissolve(bool enabled) {
+  Command command;
+  command.type = CommandType::SET_DISSOLVE;
+  command.flag = enabled;
+  return command;
+}
+
+/************************************************************/
+Command Command::setDissolutionRate(std::uint32_t rate) {
+  Command command;
+  command.type = CommandType::SET_DISSOLUTION_RATE;
+  command.count = rate;
+  return command;
+}
+
+/************************************************************/
+Command Command::setSpeed(float speed) {
+  Command command;
+  command.type = CommandType::SET_SPEED;
+  command.value = speed;
+  return command;
+}
+
+/************************************************************/
+Command Command::setShape(Shape shape) {
+  Command command;
+  command.type = CommandType::SET_SHAPE;
+  command.shape = shape;
+  return command;
+}
+
+/************************************************************/
+Command Command::setOverflow(OverflowPolicy policy) {
+  Command command;
+  command.type = CommandType::SET_OVERFLOW;
+  command.policy = policy;
+  return command;
+}
+
+/************************************************************/
+Command Command::setBounds(BoundsMode bounds) {
+  Command command;
+  command.type = CommandType::SET_BOUNDS;
+  command.bounds = bounds;
+  return command;
+}
+
+/************************************************************/
+Command Command::setField(std::uint32_t index, const ForceField &field) {
+  Command command;
+  command.type = CommandType::SET_FIELD;
+  command.count = index;
+  command.field = field;
+  return command;
+}
+
+/************************************************************/
+Command Command::addPairForce(const PairForce &force) {
+  Command command;
+  command.type = CommandType::ADD_PAIR_FORCE;
+  command.pairForce = force;
+  return command;
+}
+
+/************************************************************/
+Command Command::clearPairForces() {
+  Command command;
+  command.type = CommandType::CLEAR_PAIR_FORCES;
+  return command;
+}
+
+/************************************************************/
+Command Command::addEmitter(const Emitter &emitter) {
+  Command command;
+  command.type = CommandType::ADD_EMITTER;
+  command.emitter = emitter;
+  return command;
+}
+
+/************************************************************/
+Command Command::clearEmitters() {
+  Command command;
+  command.type = CommandType::CLEAR_EMITTERS;
+  return command;
+}
+
+/************************************************************/
+Command Command::setBudget(std::uint32_t budget) {
+  Command command;
+  command.type = CommandType::SET_BUDGET;
+  command.count = budget;
+  return command;
+}
+
+/************************************************************/
+Command Command::setLifetime(float min, float max) {
+  Command command;
+  command.type = CommandType::SET_LIFETIME;
+  command.vector = sf::Vector2f{min, max};
+  return command;
+}
+
+/************************************************************/
+Command Command::setCurves(const LifetimeCurves &curves) {
+  Command command;
+  command.type = CommandType::SET_CURVES;
+  command.curves = curves;
+  return command;
+}
+
+/************************************************************/
+Command Command::setSpatialSort(std::uint32_t interval, float threshold) {
+  Command command;
+  command.type = CommandType::SET_SPATIAL_SORT;
+  command.count = interval;
+  command.value = threshold;
+  return command;
+}
+
+/************************************************************/
+Command Command::setCompact(bool enabled) {
+  Command command;
+  command.type = CommandType::SET_COMPACT;
+  command.flag = enabled;
+  return command;
+}
+
+/************************************************************/
+Command Command::setShards(std::uint32_t shards) {
+  Command command;
+  command.type = CommandType::SET_SHARDS;
+  command.count = shards;
+  return command;
+}
+
+/************************************************************/
+void applyCommand(const Command &command, ParticleSystem &system,
+                  EmitterManager &emitters) {
+  switch (command.type) {
+    case CommandType::EMIT:
+      system.emit(command.count);
+      break;
+    case CommandType::SET_POSITION:
+      system.setPosition(command.vector);
+      break;
+    case CommandType::SET_GRAVITY:
+      system.setGravity(command.vector);
+      break;
+    case CommandType::SET_DISSOLVE:
+      system.setDissolve(command.flag);
+      break;
+    case CommandType::SET_DISSOLUTION_RATE:
+      system.setDissolutionRate(
+          static_cast<sf::Uint8>(std::min(command.count, 255U)));
+      break;
+    case CommandType::SET_SPEED:
+      system.setParticleSpeed(command.value);
+      break;
+    case CommandType::SET_SHAPE:
+      system.setShape(command.shape);
+      break;
+    case CommandType::SET_OVERFLOW:
+      system.setOverflowPolicy(command.policy);
+      break;
+    case CommandType::SET_BOUNDS:
+      system.setBoundsMode(command.bounds);
+      break;
+    case CommandType::SET_FIELD:
+      /* Slots past the end append, so a log can rebuild its fields */
+      if (command.count < system.getForceFields().size()) {
+        system.setForceField(command.count, command.field);
+      } else {
+        system.addForceField(command.field);
+      }
+      break;
+    case CommandType::ADD_PAIR_FORCE:
+      system.addPairForce(command.pairForce);
+      break;
+    case CommandType::CLEAR_PAIR_FORCES:
+      system.clearPairForces();
+      break;
+    case CommandType::ADD_EMITTER:
+      emitters.add(command.emitter);
+      break;
+    case CommandType::CLEAR_EMITTERS:
+      emitters.clear();
+      break;
+    case CommandType::SET_BUDGET:
+      system.setBudget(command.count);
+      break;
+    case CommandType::SET_LIFETIME:
+      system.setLifetime(command.vector.x, command.vector.y);
+      break;
+    case CommandType::SET_CURVES:
+      system.setLifetimeCurves(command.curves);
+      break;
+    case CommandType::SET_SPATIAL_SORT:
+      system.setSpatialSort(command.count, command.value);
+      break;
+    case CommandType::SET_COMPACT:
+      system.setCompact(command.flag);
+      break;
+    case CommandType::SET_SHARDS:
+      system.setShards(command.count);
+      break;
+  }
+}
+
+}  // namespace app
@@ -0,0 +1,91 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_COMMAND_HPP
+#define SFMLTEST_COMMAND_HPP
+
+#include <SFML/System/Vector2.hpp>  // for Vector2f
+#include <cstdint>                  // for uint8_t, uint32_t
+
+#include "Emitter.hpp"         // for Emitter, Shape
+#include "ForceField.hpp"      // for ForceField
+#include "KernelFeatures.hpp"  // for BoundsMode
+#include "Lifetime.hpp"        // for LifetimeCurves
+#include "PairForce.hpp"       // for PairForce
+#include "ParticleSystem.hpp"  // for OverflowPolicy
+
+namespace app {
+
+class EmitterManager;
+
+/* Stable numbers, they are stored in recordings */
+enum class CommandType : std::uint8_t {
+  EMIT = 0,                 /*< count particles at the system position */
+  SET_POSITION = 1,         /*< vector */
+  SET_GRAVITY = 2,          /*< vector */
+  SET_DISSOLVE = 3,         /*< flag */
+  SET_DISSOLUTION_RATE = 4, /*< count */
+  SET_SPEED = 5,            /*< value */
+  SET_SHAPE = 6,            /*< shape */
+  SET_OVERFLOW = 7,         /*< policy */
+  SET_BOUNDS = 8,           /*< bounds */
+  SET_FIELD = 9,            /*< field into slot index */
+  ADD_PAIR_FORCE = 10,      /*< pairForce */
+  CLEAR_PAIR_FORCES = 11,   /*< no payload */
+  ADD_EMITTER = 12,         /*< emitter */
+  CLEAR_EMITTERS = 13,      /*< no payload */
+  SET_BUDGET = 14,          /*< count, live particles, 0 = none */
+  SET_LIFETIME = 15,        /*< vector, min and max seconds */
+  SET_CURVES = 16,          /*< curves */
+  SET_SPATIAL_SORT = 17,    /*< count, steps per sort, value, disorder */
+  SET_COMPACT = 18,         /*< flag */
+  SET_SHARDS = 19           /*< count, strips, below 2 = off */
+};
+
+/* One change to a running simulation. Input goes through commands rather
+ * than straight into ParticleSystem, so it can be recorded and replayed.
+ * Only the members named next to the type are used. */
+struct Command {
+  CommandType type{CommandType::EMIT};
+  std::uint32_t count{0}; /*< Particles, rate or slot */
+  sf::Vector2f vector;
+  float value{0};
+  bool flag{false};
+  Shape shape{Shape::CIRCLE};
+  OverflowPolicy policy{OverflowPolicy::DROP_NEW};
+  BoundsMode bounds{BoundsMode::CULL};
+  ForceField field;
+  PairForce pairForce;
+  Emitter emitter;
+  LifetimeCurves curves;
+
+  static Command emit(std::uint32_t count);
+  static Command setPosition(const sf::Vector2f &position);
+  static Command setGravity(const sf::Vector2f &gravity);
+  static Command setDissolve(bool enabled);
+  static Command setDissolutionRate(std::uint32_t rate);
+  static Command setSpeed(float speed);
+  static Command setShape(Shape shape);
+  static Command setOverflow(OverflowPolicy policy);
+  static Command setBounds(BoundsMode bounds);
+  static Command setField(std::uint32_t index, const ForceField &field);
+  static Command addPairForce(const PairForce &force);
+  static Command clearPairForces();
+  static Command addEmitter(const Emitter &emitter);
+  static Command clearEmitters();
+  static Command setBudget(std::uint32_t budget);
+  static Command setLifetime(float min, float max);
+  static Command setCurves(const LifetimeCurves &curves);
+  static Command setSpatialSort(std::uint32_t interval, float threshold);
+  static Command setCompact(bool enabled);
+  static Command setShards(std::uint32_t shards);
+};
+
+/* Carries out the command on the system and its emitters */
+void applyCommand(const Command &command, ParticleSystem &system,
+                  EmitterManager &emitters);
+
+}  // namespace app
+
+#endif  // SFMLTEST_COMMAND_HPP
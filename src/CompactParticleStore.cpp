@@ -0,0 +1,188 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "CompactParticleStore.hpp"
+
+#include <algorithm>  // for clamp, copy, copy_n, min
+#include <iterator>   // for next
+
+#include "detail/Half.hpp"  // for fromHalf, toHalf
+
+namespace app {
+
+namespace {
+
+constexpr float AGE_STEPS = 65535.0F;
+
+float inverse(float extent) { return extent > 0 ? 1.0F / extent : 0.0F; }
+
+/* value in [0, 1] to the nearest of steps + 1 levels */
+std::uint16_t quantize(float value, float steps) {
+  return static_cast<std::uint16_t>(std::clamp(value, 0.0F, 1.0F) * steps +
+                                    0.5F);
+}
+
+}  // namespace
+
+/************************************************************/
+void CompactParticleStore::reserve(std::size_t capacity) {
+  x.reserve(capacity);
+  y.reserve(capacity);
+  vx.reserve(capacity);
+  vy.reserve(capacity);
+  color.reserve(capacity);
+  age.reserve(capacity);
+  lifetime.reserve(capacity);
+}
+
+/************************************************************/
+void CompactParticleStore::resize(std::size_t count) {
+  x.resize(count);
+  y.resize(count);
+  vx.resize(count);
+  vy.resize(count);
+  color.resize(count);
+  age.resize(count);
+  lifetime.resize(count);
+}
+
+/************************************************************/
+void CompactParticleStore::clear() { resize(0); }
+
+/************************************************************/
+void CompactParticleStore::shrinkToFit() {
+  x.shrink_to_fit();
+  y.shrink_to_fit();
+  vx.shrink_to_fit();
+  vy.shrink_to_fit();
+  color.shrink_to_fit();
+  age.shrink_to_fit();
+  lifetime.shrink_to_fit();
+}
+
+/************************************************************/
+void CompactParticleStore::compact(const std::uint32_t *survivors,
+                                   std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint32_t src = survivors[i];
+    if (src != i) {
+      x[i] = x[src];
+      y[i] = y[src];
+      vx[i] = vx[src];
+      vy[i] = vy[src];
+      color[i] = color[src];
+      age[i] = age[src];
+      lifetime[i] = lifetime[src];
+    }
+  }
+  resize(count);
+}
+
+/************************************************************/
+void CompactParticleStore::eraseFront(std::size_t count) {
+  const std::size_t kept = count < size() ? size() - count : 0;
+  const auto shift = [count](auto &array) {
+    std::copy(std::next(array.begin(), static_cast<std::ptrdiff_t>(count)),
+              array.end(), array.begin());
+  };
+  if (kept != 0) {
+    shift(x);
+    shift(y);
+    shift(vx);
+    shift(vy);
+    shift(color);
+    shift(age);
+    shift(lifetime);
+  }
+  resize(kept);
+}
+
+/************************************************************/
+void CompactParticleStore::gather(const CompactParticleStore &src,
+                                  const std::uint32_t *indices,
+                                  std::size_t count, std::size_t offset) {
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint32_t from = indices[i];
+    x[offset + i] = src.x[from];
+    y[offset + i] = src.y[from];
+    vx[offset + i] = src.vx[from];
+    vy[offset + i] = src.vy[from];
+    color[offset + i] = src.color[from];
+    age[offset + i] = src.age[from];
+    lifetime[offset + i] = src.lifetime[from];
+  }
+}
+
+/************************************************************/
+void CompactParticleStore::encode(const ParticleStore &src, std::size_t first,
+                                  std::size_t count, std::size_t offset,
+                                  float width, float height) {
+  /* One loop per attribute over raw pointers, so each vectorises */
+  const auto positions = [count](const float *__restrict from,
+                                 std::uint16_t *__restrict to,
+                                 float extent) {
+    const float scale = inverse(extent);
+    for (std::size_t i = 0; i < count; ++i) {
+      to[i] = quantize(from[i] * scale, COMPACT_POSITION_STEPS);
+    }
+  };
+  const auto halves = [count](const float *__restrict from,
+                              std::uint16_t *__restrict to) {
+    for (std::size_t i = 0; i < count; ++i) {
+      to[i] = toHalf(from[i]);
+    }
+  };
+  positions(src.x.data() + first, x.data() + offset, width);
+  positions(src.y.data() + first, y.data() + offset, height);
+  halves(src.vx.data() + first, vx.data() + offset);
+  halves(src.vy.data() + first, vy.data() + offset);
+  halves(src.lifetime.data() + first, lifetime.data() + offset);
+  std::copy_n(src.color.data() + first, count, color.data() + offset);
+
+  /* Relative to the lifetime as stored, so decoding reproduces it */
+  const float *__restrict ages = src.age.data() + first;
+  const std::uint16_t *__restrict lives = lifetime.data() + offset;
+  std::uint16_t *__restrict fractions = age.data() + offset;
+  for (std::size_t i = 0; i < count; ++i) {
+    fractions[i] = quantize(ages[i] / fromHalf(lives[i]), AGE_STEPS);
+  }
+}
+
+/************************************************************/
+void CompactParticleStore::decode(std::size_t first, std::size_t count,
+                                  ParticleStore &dst, std::size_t offset,
+                                  float width, float height) const {
+  const auto positions = [count](const std::uint16_t *__restrict from,
+                                 float *__restrict to, float extent) {
+    const float step = compactStep(extent);
+    for (std::size_t i = 0; i < count; ++i) {
+      /* The edge step may round past the canvas, which would cull it */
+      to[i] = std::min(static_cast<float>(from[i]) * step, extent);
+    }
+  };
+  const auto halves = [count](const std::uint16_t *__restrict from,
+                              float *__restrict to) {
+    for (std::size_t i = 0; i < count; ++i) {
+      to[i] = fromHalf(from[i]);
+    }
+  };
+  positions(x.data() + first, dst.x.data() + offset, width);
+  positions(y.data() + first, dst.y.data() + offset, height);
+  halves(vx.data() + first, dst.vx.data() + offset);
+  halves(vy.data() + first, dst.vy.data() + offset);
+  halves(lifetime.data() + first, dst.lifetime.data() + offset);
+  std::copy_n(color.data() + first, count, dst.color.data() + offset);
+
+  const std::uint16_t *__restrict fractions = age.data() + first;
+  const float *__restrict lives = dst.lifetime.data() + offset;
+  float *__restrict ages = dst.age.data() + offset;
+  constexpr float ageStep = 1.0F / AGE_STEPS;
+  for (std::size_t i = 0; i < count; ++i) {
+    const float aged = static_cast<float>(fractions[i]) * ageStep * lives[i];
+    /* Zero rather than 0 * infinity for particles that never expire */
+    ages[i] = fractions[i] == 0 ? 0.0F : aged;
+  }
+}
+
+}  // namespace app
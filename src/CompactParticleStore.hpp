@@ -0,0 +1,74 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_COMPACTPARTICLESTORE_HPP
+#define SFMLTEST_COMPACTPARTICLESTORE_HPP
+
+#include <SFML/Graphics/Color.hpp>  // for Color
+#include <cstddef>                  // for size_t
+#include <cstdint>                  // for uint16_t, uint32_t
+#include <vector>                   // for vector
+
+#include "ParticleStore.hpp"  // for ParticleStore
+
+namespace app {
+
+/* Fixed-point steps across the canvas per position axis */
+constexpr float COMPACT_POSITION_STEPS = 65535.0F;
+
+/* Quantized structure-of-arrays particle storage, 16 bytes a particle
+ * against ParticleStore's 28: positions in 16-bit fixed point across a
+ * width x height canvas, velocities and lifetimes as half floats, the age
+ * as a 16-bit fraction of the lifetime, the colour as is. The simulation
+ * never runs on it directly; encode() and decode() convert ranges to and
+ * from a ParticleStore, and decode(encode(p)) is stable, so a decoded
+ * store encodes back to the very same bits.
+ * Positions outside the canvas clamp to its edge. Motion below one step,
+ * width / COMPACT_POSITION_STEPS pixels, and velocity changes below half
+ * precision are rounded away. */
+class CompactParticleStore {
+ public:
+  static constexpr std::size_t BYTES_PER_PARTICLE =
+      4 * sizeof(std::uint16_t) + sizeof(sf::Color) +
+      2 * sizeof(std::uint16_t);
+
+  [[nodiscard]] std::size_t size() const { return x.size(); }
+  [[nodiscard]] bool empty() const { return x.empty(); }
+
+  void reserve(std::size_t capacity);
+  void resize(std::size_t count);
+  void clear();
+  void shrinkToFit(); /*< Releases spare capacity */
+
+  /* Same as their ParticleStore namesakes */
+  void compact(const std::uint32_t *survivors, std::size_t count);
+  void eraseFront(std::size_t count);
+  void gather(const CompactParticleStore &src, const std::uint32_t *indices,
+              std::size_t count, std::size_t offset);
+
+  /* Packs src particles [first, first + count) into slots [offset, ...) */
+  void encode(const ParticleStore &src, std::size_t first, std::size_t count,
+              std::size_t offset, float width, float height);
+  /* Unpacks particles [first, first + count) into dst slots
+   * [offset, ...); dst must be large enough */
+  void decode(std::size_t first, std::size_t count, ParticleStore &dst,
+              std::size_t offset, float width, float height) const;
+
+  std::vector<std::uint16_t> x;        /*< Position x, fixed point */
+  std::vector<std::uint16_t> y;        /*< Position y, fixed point */
+  std::vector<std::uint16_t> vx;       /*< Velocity x, half float */
+  std::vector<std::uint16_t> vy;       /*< Velocity y, half float */
+  std::vector<sf::Color> color;        /*< Color */
+  std::vector<std::uint16_t> age;      /*< Fraction of the lifetime lived */
+  std::vector<std::uint16_t> lifetime; /*< Seconds, half float */
+};
+
+/* Canvas pixels per fixed-point step of an axis extent pixels long */
+[[nodiscard]] inline float compactStep(float extent) {
+  return extent > 0 ? extent / COMPACT_POSITION_STEPS : 0.0F;
+}
+
+}  // namespace app
+
+#endif  // SFMLTEST_COMPACTPARTICLESTORE_HPP
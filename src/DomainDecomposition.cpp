@@ -0,0 +1,165 @@
+//
+// Created by Michael Wittmann on 18/10/2026.
+//
+
+#include "DomainDecomposition.hpp"
+
+#include <algorithm>  // for clamp, max, min
+#include <cmath>      // for ceil
+
+#include "detail/Profiler.hpp"  // for APP_PROFILE_SCOPE
+
+namespace app {
+
+/************************************************************/
+void DomainDecomposition::setStrips(std::size_t strips, float height) {
+  strips_ = strips < 2 ? 0 : strips;
+  height_ = height;
+  stripHeight_ = strips_ == 0 ? 0 : height / static_cast<float>(strips_);
+  outboxes_.resize((strips_ + 1) * strips_);
+  shards_.resize(strips_);
+  start_.assign(strips_ + 2, 0);
+  arrivals_.reserve(strips_ + 1);
+}
+
+/************************************************************/
+void DomainDecomposition::reserve(std::size_t capacity) {
+  if (!active()) {
+    return;
+  }
+  posts_.reserve(capacity);
+  const std::size_t share = std::min(capacity, 2 * capacity / strips_);
+  for (Shard &shard : shards_) {
+    shard.index.reserve(share);
+    shard.own.reserve(share);
+    shard.local.reserve(share);
+    shard.grid.reserve(share);
+    shard.dvx.reserve(share);
+    shard.dvy.reserve(share);
+  }
+}
+
+/************************************************************/
+std::size_t DomainDecomposition::stripOf(float y) const {
+  const float strip = std::clamp(y / stripHeight_, 0.0F,
+                                 static_cast<float>(strips_ - 1));
+  return static_cast<std::size_t>(strip);
+}
+
+/************************************************************/
+void DomainDecomposition::clearOutboxes() {
+  for (Outbox &posted : outboxes_) {
+    posted = Outbox{};
+  }
+  posts_.resize(start_[strips_ + 1]);
+}
+
+/************************************************************/
+bool DomainDecomposition::settled() const {
+  std::size_t stayed{0};
+  for (std::size_t strip = 0; strip < strips_; ++strip) {
+    stayed += outboxes_[strip * strips_ + strip].size;
+  }
+  return stayed == start_[strips_ + 1];
+}
+
+/************************************************************/
+std::size_t DomainDecomposition::getMigrated() const {
+  std::size_t migrated{0};
+  for (std::size_t from = 0; from < strips_; ++from) {
+    for (std::size_t to = 0; to < strips_; ++to) {
+      if (from != to) {
+        migrated += outboxes_[from * strips_ + to].size;
+      }
+    }
+  }
+  return migrated;
+}
+
+/************************************************************/
+void DomainDecomposition::applyPairForces(
+    ParticleStore &store, const std::vector<PairForce> &forces,
+    float cellSize, float width, float deltaTime, std::size_t maxNeighbours,
+    ThreadPool &pool) {
+  APP_PROFILE_SCOPE("DomainDecomposition::applyPairForces");
+  float radius{0};
+  for (const auto &force : forces) {
+    radius = std::max(radius, force.radius);
+  }
+  const auto reach = static_cast<std::size_t>(std::ceil(radius / cellSize));
+  const std::size_t rows = std::max<std::size_t>(
+      1, static_cast<std::size_t>(std::ceil(height_ / cellSize)));
+  /* As SpatialGrid::cellOf has it */
+  const auto rowOf = [&](float y) {
+    return static_cast<std::size_t>(
+        std::clamp(y / cellSize, 0.0F, static_cast<float>(rows - 1)));
+  };
+
+  pool.parallelFor(0, strips_, 1, [&](std::size_t firstStrip,
+                                      std::size_t lastStrip) {
+    for (std::size_t strip = firstStrip; strip < lastStrip; ++strip) {
+      Shard &shard = shards_[strip];
+      const float top = static_cast<float>(strip) * stripHeight_;
+      const std::size_t ownFirst = strip == 0 ? 0 : rowOf(top);
+      const std::size_t ownLast =
+          strip + 1 == strips_ ? rows - 1 : rowOf(top + stripHeight_);
+      const std::size_t first = ownFirst - std::min(ownFirst, reach);
+      const std::size_t last = std::min(rows - 1, ownLast + reach);
+      /* Half a cell of slack, as strip and row edges round apart */
+      const std::size_t fromStrip =
+          stripOf((static_cast<float>(first) - 0.5F) * cellSize);
+      const std::size_t toStrip =
+          stripOf((static_cast<float>(last) + 1.5F) * cellSize);
+
+      /* Ascending store indices, so the stable binning visits neighbours
+       * in the order the global grid does */
+      shard.index.clear();
+      shard.own.clear();
+      const auto take = [&](std::size_t i, bool own) {
+        const std::size_t row = rowOf(store.y[i]);
+        if (own || (row >= first && row <= last)) {
+          shard.index.push_back(static_cast<std::uint32_t>(i));
+          shard.own.push_back(own ? 1 : 0);
+        }
+      };
+      for (std::size_t from = fromStrip; from <= toStrip; ++from) {
+        for (std::size_t i = begin(from); i < end(from); ++i) {
+          take(i, from == strip);
+        }
+      }
+      for (std::size_t i = begin(strips_); i < end(strips_); ++i) {
+        take(i, stripOf(store.y[i]) == strip);
+      }
+
+      const std::size_t count = shard.index.size();
+      shard.local.resize(count);
+      shard.local.gather(store, shard.index.data(), count, 0);
+      shard.grid.setCellSize(cellSize);
+      shard.grid.setBounds(width, height_);
+      shard.grid.setRowWindow(first, last - first + 1);
+      shard.grid.build(shard.local, pool);
+      shard.dvx.assign(count, 0.0F);
+      shard.dvy.assign(count, 0.0F);
+      accumulatePairForces(shard.grid, pool, forces, deltaTime, maxNeighbours,
+                           shard.dvx.data(), shard.dvy.data());
+    }
+  });
+
+  /* Every shard has read the velocities, so they may change now */
+  pool.parallelFor(0, strips_, 1, [&](std::size_t firstStrip,
+                                      std::size_t lastStrip) {
+    for (std::size_t strip = firstStrip; strip < lastStrip; ++strip) {
+      const Shard &shard = shards_[strip];
+      const std::uint32_t *order = shard.grid.order().data();
+      for (std::size_t slot = 0; slot < shard.index.size(); ++slot) {
+        const std::uint32_t local = order[slot];
+        if (shard.own[local] != 0) {
+          store.vx[shard.index[local]] += shard.dvx[slot];
+          store.vy[shard.index[local]] += shard.dvy[slot];
+        }
+      }
+    }
+  });
+}
+
+}  // namespace app
@@ -0,0 +1,187 @@
+//
+// Created by Michael Wittmann on 18/10/2026.
+//
+
+#ifndef SFMLTEST_DOMAINDECOMPOSITION_HPP
+#define SFMLTEST_DOMAINDECOMPOSITION_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
+#include <vector>   // for vector
+
+#include "PairForce.hpp"          // for PairForce
+#include "ParticleStore.hpp"      // for ParticleStore
+#include "SpatialGrid.hpp"        // for SpatialGrid
+#include "detail/ThreadPool.hpp"  // for ThreadPool
+
+namespace app {
+
+/* Splits the canvas into horizontal strips of equal height, each owning
+ * one shard of the particles, see ParticleSystem::setShards.
+ * The store holds the particles of strip 0 first, then those of strip 1
+ * and so on; particles emitted since follow unassigned. After an update
+ * every shard posts each survivor to its outbox towards the strip the
+ * particle is in now, mostly its own, and migrate() regroups the store
+ * from the outboxes. An outbox has one writer and one reader, in passes
+ * the pool's join keeps apart, so none needs a lock. The outboxes of a
+ * shard are slices of its own slots in one buffer, so posting never
+ * allocates once reserve() made room. */
+class DomainDecomposition {
+ public:
+  /* Fewer than 2 strips switches the decomposition off */
+  void setStrips(std::size_t strips, float height);
+  [[nodiscard]] std::size_t getStrips() const { return strips_; }
+  [[nodiscard]] bool active() const { return strips_ > 1; }
+  /* Strip of a y position; beyond the canvas counts as the edge strip */
+  [[nodiscard]] std::size_t stripOf(float y) const;
+  /* Sizes the outboxes for capacity particles, and the pair force scratch
+   * of every shard for an even share of them plus as many again for ghost
+   * zones and uneven spread; a shard needing more grows once. Call again
+   * after setStrips. */
+  void reserve(std::size_t capacity);
+
+  /* Finds the shards of count particles, the first assigned of which are
+   * grouped by strip; y(i) is the position of particle i */
+  template <typename Y>
+  void locate(std::size_t assigned, std::size_t count, const Y &y);
+  /* Shard s holds particles [begin(s), end(s)); shard getStrips() stands
+   * for the unassigned ones */
+  [[nodiscard]] std::size_t begin(std::size_t shard) const {
+    return start_[shard];
+  }
+  [[nodiscard]] std::size_t end(std::size_t shard) const {
+    return start_[shard + 1];
+  }
+
+  /* Same as accumulatePairForces over a grid of the whole canvas, with
+   * the result added to the velocities, bit for bit. Each shard bins its
+   * own particles plus a ghost zone, the particles of neighbouring
+   * strips within reach of the largest radius, into a grid of its band
+   * of rows, and only keeps the result for its own. */
+  void applyPairForces(ParticleStore &store,
+                       const std::vector<PairForce> &forces, float cellSize,
+                       float width, float deltaTime,
+                       std::size_t maxNeighbours, ThreadPool &pool);
+
+  /* Empties the outboxes for the next update of the located particles */
+  void clearOutboxes();
+  /* Posts the survivors of shard from towards the strips they are in now,
+   * in store order; survivors(post) calls post(i, y) for every survivor i
+   * at height y, once to count and once to post. Only the thread working
+   * on shard from may call it. */
+  template <typename Survivors>
+  void post(std::size_t from, const Survivors &survivors);
+  /* Whether every located particle was posted to its own strip, so the
+   * store is grouped already */
+  [[nodiscard]] bool settled() const;
+  /* Regroups the posted particles by strip, in parallel over the strips:
+   * gather(indices, count, offset) copies store particles indices[0,
+   * count) to slot offset onwards of the new store */
+  template <typename Gather>
+  void migrate(ThreadPool &pool, const Gather &gather);
+  /* Particles posted to another strip since the last clearOutboxes() */
+  [[nodiscard]] std::size_t getMigrated() const;
+
+ private:
+  /* Store indices shard from sent to strip to: posts_[first, first + size)
+   */
+  struct Outbox {
+    std::size_t first{0};
+    std::size_t size{0};
+  };
+
+  /* Per-strip pair force scratch */
+  struct Shard {
+    std::vector<std::uint32_t> index; /*< Store index per local particle */
+    std::vector<std::uint8_t> own;    /*< 1 = in this strip, 0 = ghost */
+    ParticleStore local;              /*< Own and ghost particles */
+    SpatialGrid grid;                 /*< Band of rows around the strip */
+    std::vector<float> dvx;           /*< Velocity change, grid order */
+    std::vector<float> dvy;           /*< Velocity change, grid order */
+  };
+
+  std::size_t strips_{0};
+  float height_{0};                 /*< Canvas height */
+  float stripHeight_{0};            /*< height_ / strips_ */
+  std::vector<std::size_t> start_;  /*< First particle per shard, + end */
+  std::vector<std::size_t> arrivals_; /*< First slot per strip, migrate */
+  /* [from * strips_ + to]; from = strips_ for unassigned particles */
+  std::vector<Outbox> outboxes_;
+  std::vector<std::uint32_t> posts_; /*< Shard s posts to its own slots */
+  std::vector<Shard> shards_;
+};
+
+/************************************************************/
+template <typename Y>
+void DomainDecomposition::locate(std::size_t assigned, std::size_t count,
+                                 const Y &y) {
+  start_.resize(strips_ + 2);
+  start_[0] = 0;
+  for (std::size_t strip = 1; strip < strips_; ++strip) {
+    /* Binary search for the first particle of the strip */
+    std::size_t low = start_[strip - 1];
+    std::size_t high = assigned;
+    while (low < high) {
+      const std::size_t middle = low + (high - low) / 2;
+      if (stripOf(y(middle)) < strip) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    start_[strip] = low;
+  }
+  start_[strips_] = assigned;
+  start_[strips_ + 1] = count;
+}
+
+/************************************************************/
+template <typename Survivors>
+void DomainDecomposition::post(std::size_t from, const Survivors &survivors) {
+  Outbox *outboxes = outboxes_.data() + from * strips_;
+  for (std::size_t to = 0; to < strips_; ++to) {
+    outboxes[to].size = 0;
+  }
+  survivors([&](std::uint32_t, float y) { ++outboxes[stripOf(y)].size; });
+  /* A shard has no more survivors than particles */
+  std::size_t first = begin(from);
+  for (std::size_t to = 0; to < strips_; ++to) {
+    outboxes[to].first = first;
+    first += outboxes[to].size;
+    outboxes[to].size = 0;
+  }
+  survivors([&](std::uint32_t i, float y) {
+    Outbox &outbox = outboxes[stripOf(y)];
+    posts_[outbox.first + outbox.size++] = i;
+  });
+}
+
+/************************************************************/
+template <typename Gather>
+void DomainDecomposition::migrate(ThreadPool &pool, const Gather &gather) {
+  const std::size_t sources = strips_ + 1;
+  arrivals_.resize(strips_ + 1);
+  arrivals_[0] = 0;
+  for (std::size_t to = 0; to < strips_; ++to) {
+    std::size_t arriving{0};
+    for (std::size_t from = 0; from < sources; ++from) {
+      arriving += outboxes_[from * strips_ + to].size;
+    }
+    arrivals_[to + 1] = arrivals_[to] + arriving;
+  }
+  /* Sources in order keep every strip in store order */
+  pool.parallelFor(0, strips_, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t to = first; to < last; ++to) {
+      std::size_t offset = arrivals_[to];
+      for (std::size_t from = 0; from < sources; ++from) {
+        const Outbox &posted = outboxes_[from * strips_ + to];
+        gather(posts_.data() + posted.first, posted.size, offset);
+        offset += posted.size;
+      }
+    }
+  });
+}
+
+}  // namespace app
+
+#endif  // SFMLTEST_DOMAINDECOMPOSITION_HPP
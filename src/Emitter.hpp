@@ -0,0 +1,29 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_EMITTER_HPP
+#define SFMLTEST_EMITTER_HPP
+
+#include <SFML/Graphics/Color.hpp>  // for Color
+#include <SFML/System/Vector2.hpp>  // for Vector2f
+
+namespace app {
+
+enum class Shape { CIRCLE = 0, SQUARE = 1 };
+
+/* One particle source. Any number of emitters write into the same
+ * ParticleSystem; the defaults reproduce the system's own emission. */
+struct Emitter {
+  sf::Vector2f position;            /*< Spawn point */
+  float rate{100.0F};               /*< Particles per second */
+  Shape shape{Shape::CIRCLE};       /*< Velocity distribution */
+  float speed{1.0F};                /*< Multiplies the system speed */
+  sf::Color colorMin{0, 0, 0, 255}; /*< Per channel, inclusive */
+  sf::Color colorMax{255, 255, 255, 255};
+  bool enabled{true};
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_EMITTER_HPP
@@ -0,0 +1,51 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "EmitterManager.hpp"
+
+#include <cmath>     // for floor
+#include <cstddef>   // for ptrdiff_t
+#include <iterator>  // for next
+
+#include "ParticleSystem.hpp"  // for ParticleSystem
+
+namespace app {
+
+/************************************************************/
+std::size_t EmitterManager::add(const Emitter &emitter) {
+  emitters_.push_back(emitter);
+  owed_.push_back(0.0F);
+  return emitters_.size() - 1;
+}
+
+/************************************************************/
+void EmitterManager::remove(std::size_t index) {
+  const auto offset = static_cast<std::ptrdiff_t>(index);
+  emitters_.erase(std::next(emitters_.begin(), offset));
+  owed_.erase(std::next(owed_.begin(), offset));
+}
+
+/************************************************************/
+void EmitterManager::clear() {
+  emitters_.clear();
+  owed_.clear();
+}
+
+/************************************************************/
+void EmitterManager::emit(ParticleSystem &system, float deltaTime) {
+  counts_.resize(emitters_.size());
+  for (std::size_t i = 0; i < emitters_.size(); ++i) {
+    if (!emitters_[i].enabled || emitters_[i].rate <= 0) {
+      counts_[i] = 0;
+      continue;
+    }
+    const float owed = owed_[i] + emitters_[i].rate * deltaTime;
+    const float whole = std::floor(owed);
+    counts_[i] = static_cast<std::size_t>(whole);
+    owed_[i] = owed - whole;
+  }
+  system.emit(emitters_, counts_);
+}
+
+}  // namespace app
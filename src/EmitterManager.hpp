@@ -0,0 +1,55 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_EMITTERMANAGER_HPP
+#define SFMLTEST_EMITTERMANAGER_HPP
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "Emitter.hpp"  // for Emitter
+
+namespace app {
+
+class ParticleSystem;
+
+/* Owns the emitters of a scene and feeds them into one ParticleSystem.
+ * Per step it only does O(emitters) bookkeeping; all particles then go
+ * into the system's store in one batch, so the cost follows the particle
+ * count rather than the number of emitters. */
+class EmitterManager {
+ public:
+  /* Returns the index for later set/remove; removing shifts the indices
+   * of later emitters down by one */
+  std::size_t add(const Emitter &emitter);
+  void set(std::size_t index, const Emitter &emitter) {
+    emitters_[index] = emitter;
+  }
+  void remove(std::size_t index);
+  void clear();
+
+  [[nodiscard]] std::size_t size() const { return emitters_.size(); }
+  [[nodiscard]] const Emitter &get(std::size_t index) const {
+    return emitters_[index];
+  }
+  [[nodiscard]] const std::vector<Emitter> &emitters() const {
+    return emitters_;
+  }
+  /* Fraction of a particle an emitter carries into the next step */
+  [[nodiscard]] float getOwed(std::size_t index) const { return owed_[index]; }
+  void setOwed(std::size_t index, float owed) { owed_[index] = owed; }
+
+  /* Emits what every enabled emitter owes for deltaTime seconds;
+   * fractions carry over to the next call */
+  void emit(ParticleSystem &system, float deltaTime);
+
+ private:
+  std::vector<Emitter> emitters_;
+  std::vector<float> owed_;         /*< Fractional particles per emitter */
+  std::vector<std::size_t> counts_; /*< This step's particles per emitter */
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_EMITTERMANAGER_HPP
@@ -0,0 +1,121 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "ForceField.hpp"
+
+#include <algorithm>  // for max, min
+#include <array>      // for array
+#include <cmath>      // for abs, sqrt
+
+namespace app {
+
+namespace {
+
+constexpr std::size_t FIELD_BLOCK = 256; /*< Particles per L1 block */
+constexpr float SOFTENING = 16.0F;       /*< px^2, tames the centre */
+
+constexpr float PI = 3.14159265F;
+
+/* Share of the strength left at distance sqrt(dist2); branch-free so the
+ * loops vectorise, invRadius = 0 means unbounded */
+inline float falloff(float dist2, float invRadius) {
+  return std::max(0.0F, 1.0F - std::sqrt(dist2) * invRadius);
+}
+
+/* Parabolic sine with one refinement step, abs error below 0.001; plain
+ * arithmetic, so it vectorises where std::sin does not */
+inline float fastSin(float x) {
+  constexpr float invTwoPi = 1.0F / (2.0F * PI);
+  /* Wrap to [-pi, pi]; truncation of x + 0.5 rounds for x > -0.5 */
+  const float turns = x * invTwoPi;
+  const float shifted = turns + (turns >= 0 ? 0.5F : -0.5F);
+  x -= static_cast<float>(static_cast<int>(shifted)) * 2.0F * PI;
+  const float y = (4.0F / PI) * x - (4.0F / (PI * PI)) * x * std::abs(x);
+  return 0.225F * (y * std::abs(y) - y) + y;
+}
+
+}  // namespace
+
+/************************************************************/
+void applyForceFields(ParticleStore &store, std::size_t begin,
+                      std::size_t end, const std::vector<ForceField> &fields,
+                      float deltaTime, float time) {
+  std::array<float, FIELD_BLOCK> ax{};
+  std::array<float, FIELD_BLOCK> ay{};
+  for (std::size_t block = begin; block < end; block += FIELD_BLOCK) {
+    const std::size_t count = std::min(FIELD_BLOCK, end - block);
+    const float *x = store.x.data() + block;
+    const float *y = store.y.data() + block;
+    const float *vx = store.vx.data() + block;
+    const float *vy = store.vy.data() + block;
+    std::fill_n(ax.begin(), count, 0.0F);
+    std::fill_n(ay.begin(), count, 0.0F);
+
+    for (const auto &field : fields) {
+      if (field.strength == 0) {
+        continue;
+      }
+      const float strength = field.strength;
+      const float cx = field.position.x;
+      const float cy = field.position.y;
+      const float invRadius = field.radius > 0 ? 1.0F / field.radius : 0.0F;
+      switch (field.type) {
+        case ForceFieldType::ATTRACTOR: {
+          for (std::size_t i = 0; i < count; ++i) {
+            const float dx = cx - x[i];
+            const float dy = cy - y[i];
+            const float dist2 = dx * dx + dy * dy;
+            const float scale = strength * falloff(dist2, invRadius) /
+                                std::sqrt(dist2 + SOFTENING);
+            ax[i] += dx * scale;
+            ay[i] += dy * scale;
+          }
+          break;
+        }
+        case ForceFieldType::VORTEX: {
+          for (std::size_t i = 0; i < count; ++i) {
+            const float dx = x[i] - cx;
+            const float dy = y[i] - cy;
+            const float dist2 = dx * dx + dy * dy;
+            const float scale = strength * falloff(dist2, invRadius) /
+                                std::sqrt(dist2 + SOFTENING);
+            /* Counter-clockwise on screen, where y points down */
+            ax[i] += dy * scale;
+            ay[i] -= dx * scale;
+          }
+          break;
+        }
+        case ForceFieldType::DRAG: {
+          for (std::size_t i = 0; i < count; ++i) {
+            ax[i] -= strength * vx[i];
+            ay[i] -= strength * vy[i];
+          }
+          break;
+        }
+        case ForceFieldType::NOISE: {
+          /* Two octaves of shear waves: ax only depends on y and ay only on
+           * x, so the field neither sinks nor sources particles */
+          const float k = 2.0F * PI * field.frequency;
+          const float phase = time * 0.7F;
+          for (std::size_t i = 0; i < count; ++i) {
+            ax[i] += strength * (fastSin(k * y[i] + phase) +
+                                 0.5F * fastSin(2.3F * k * y[i] - phase));
+            ay[i] += strength * (fastSin(k * x[i] - phase) +
+                                 0.5F * fastSin(1.9F * k * x[i] + phase));
+          }
+          break;
+        }
+      }
+    }
+
+    float *outX = store.vx.data() + block;
+    float *outY = store.vy.data() + block;
+    for (std::size_t i = 0; i < count; ++i) {
+      outX[i] += ax[i] * deltaTime;
+      outY[i] += ay[i] * deltaTime;
+    }
+  }
+}
+
+}  // namespace app
@@ -0,0 +1,43 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_FORCEFIELD_HPP
+#define SFMLTEST_FORCEFIELD_HPP
+
+#include <SFML/System/Vector2.hpp>  // for Vector2f
+#include <cstddef>                  // for size_t
+#include <vector>                   // for vector
+
+#include "ParticleStore.hpp"  // for ParticleStore
+
+namespace app {
+
+enum class ForceFieldType {
+  ATTRACTOR = 0, /*< Pulls towards position, repels if strength < 0 */
+  VORTEX = 1,    /*< Spins around position, clockwise if strength < 0 */
+  DRAG = 2,      /*< Slows particles down */
+  NOISE = 3      /*< Divergence-free turbulence, drifts over time */
+};
+
+/* Acceleration source acting on every particle in range; fields with
+ * strength 0 are skipped, so a field can be parked without removing it */
+struct ForceField {
+  ForceFieldType type{ForceFieldType::ATTRACTOR};
+  sf::Vector2f position;  /*< Centre of ATTRACTOR and VORTEX */
+  float strength{1.0F};   /*< Velocity change per second */
+  float radius{0};        /*< Their range, 0 = unbounded */
+  float frequency{0.01F}; /*< NOISE cycles per pixel */
+};
+
+/* Adds the acceleration of all fields to the velocities of particles
+ * [begin, end). Runs block by block: each field streams over a block that
+ * stays in L1, so particle state is read and written once however many
+ * fields are active. time animates NOISE. */
+void applyForceFields(ParticleStore &store, std::size_t begin,
+                      std::size_t end, const std::vector<ForceField> &fields,
+                      float deltaTime, float time);
+
+}  // namespace app
+
+#endif  // SFMLTEST_FORCEFIELD_HPP
@@ -0,0 +1,221 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "FrameCapture.hpp"
+
+#include <spdlog/fmt/fmt.h>  // for format
+
+#include <csignal>  // for signal, SIGPIPE
+
+#include "Rasterizer.hpp"         // for Rasterizer
+#include "detail/Profiler.hpp"    // for APP_PROFILE_SCOPE
+#include "detail/ThreadPool.hpp"  // for ThreadPool
+
+namespace app {
+
+namespace {
+
+bool endsWith(const std::string &text, const std::string &suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+
+std::FILE *openPipe(const std::string &command) {
+#ifdef _WIN32
+  return _popen(command.c_str(), "wb");
+#else
+  /* An encoder that quits early must fail our writes, not kill the app */
+  std::signal(SIGPIPE, SIG_IGN);
+  return popen(command.c_str(), "w");
+#endif
+}
+
+void closePipe(std::FILE *pipe) {
+#ifdef _WIN32
+  _pclose(pipe);
+#else
+  pclose(pipe);
+#endif
+}
+
+}  // namespace
+
+/************************************************************/
+bool parseCaptureTarget(const std::string &target,
+                        CaptureSettings &settings) {
+  const std::string pipe{"pipe:"};
+  settings.output = CaptureOutput::IMAGES;
+  settings.target = target;
+  settings.format = "ppm";
+  if (target.compare(0, pipe.size(), pipe) == 0) {
+    settings.output = CaptureOutput::PIPE;
+    settings.target = target.substr(pipe.size());
+  } else if (endsWith(target, ".rgba")) {
+    settings.output = CaptureOutput::RAW_FILE;
+  } else if (endsWith(target, ".png") || endsWith(target, ".ppm")) {
+    settings.format = target.substr(target.size() - 3);
+    settings.target = target.substr(0, target.size() - 4);
+  }
+  return !settings.target.empty();
+}
+
+/************************************************************/
+FrameCapture::~FrameCapture() { stop(); }
+
+/************************************************************/
+bool FrameCapture::start(const CaptureSettings &settings,
+                         std::string &error) {
+  stop();
+  if (settings.slots == 0 || settings.writers == 0 || settings.size.x == 0 ||
+      settings.size.y == 0) {
+    error = "capture needs a frame size, slots and writers";
+    return false;
+  }
+  settings_ = settings;
+  if (settings_.output == CaptureOutput::RAW_FILE) {
+    stream_ = std::fopen(settings_.target.c_str(), "wb");
+  } else if (settings_.output == CaptureOutput::PIPE) {
+    stream_ = openPipe(settings_.target);
+  }
+  if (settings_.output != CaptureOutput::IMAGES && stream_ == nullptr) {
+    error = fmt::format("cannot open {}", settings_.target);
+    return false;
+  }
+
+  /* Everything the render thread touches is allocated up front */
+  slots_.resize(settings_.slots);
+  free_.clear();
+  free_.reserve(settings_.slots);
+  for (std::size_t slot = 0; slot < settings_.slots; ++slot) {
+    slots_[slot].points.reserve(settings_.points);
+    free_.push_back(slot);
+  }
+  ready_.assign(settings_.slots, 0);
+  readyHead_ = 0;
+  readyCount_ = 0;
+  stopping_ = false;
+  nextWrite_ = 0;
+  frame_ = 0;
+  captured_ = 0;
+  written_ = 0;
+  dropped_ = 0;
+  failed_ = 0;
+  for (std::size_t i = 0; i < settings_.writers; ++i) {
+    workers_.emplace_back([this]() { workerLoop(); });
+  }
+  return true;
+}
+
+/************************************************************/
+void FrameCapture::stop() {
+  if (workers_.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  readyChanged_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  if (stream_ != nullptr) {
+    if (settings_.output == CaptureOutput::PIPE) {
+      closePipe(stream_);
+    } else {
+      std::fclose(stream_);
+    }
+    stream_ = nullptr;
+  }
+}
+
+/************************************************************/
+bool FrameCapture::submit(const std::vector<sf::Vertex> &vertices) {
+  APP_PROFILE_SCOPE("FrameCapture::submit");
+  std::size_t slot{0};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+      ++dropped_;
+      return false;
+    }
+    slot = free_.back();
+    free_.pop_back();
+  }
+  /* The copy runs outside the lock; the slot is ours until queued */
+  slots_[slot].points.assign(vertices.begin(), vertices.end());
+  slots_[slot].frame = frame_++;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_[(readyHead_ + readyCount_) % ready_.size()] = slot;
+    ++readyCount_;
+  }
+  readyChanged_.notify_one();
+  ++captured_;
+  return true;
+}
+
+/************************************************************/
+CaptureStats FrameCapture::getStats() const {
+  return CaptureStats{captured_, written_, dropped_, failed_};
+}
+
+/************************************************************/
+void FrameCapture::workerLoop() {
+  /* A private single-threaded pool: writers must not compete with the
+   * simulation for the shared one */
+  ThreadPool pool{1};
+  Rasterizer rasterizer{settings_.size};
+  rasterizer.setThreadPool(pool);
+  while (true) {
+    std::size_t slot{0};
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      readyChanged_.wait(lock,
+                         [this]() { return readyCount_ > 0 || stopping_; });
+      if (readyCount_ == 0) {
+        return;
+      }
+      slot = ready_[readyHead_];
+      readyHead_ = (readyHead_ + 1) % ready_.size();
+      --readyCount_;
+    }
+    rasterizer.clear(settings_.background);
+    rasterizer.draw(slots_[slot].points);
+    const std::uint64_t frame = slots_[slot].frame;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_.push_back(slot);
+    }
+    if (write(rasterizer, frame)) {
+      ++written_;
+    } else {
+      ++failed_;
+    }
+  }
+}
+
+/************************************************************/
+bool FrameCapture::write(const Rasterizer &rasterizer, std::uint64_t frame) {
+  APP_PROFILE_SCOPE("FrameCapture::write");
+  if (settings_.output == CaptureOutput::IMAGES) {
+    return rasterizer.save(fmt::format("{}{:06}.{}", settings_.target, frame,
+                                       settings_.format));
+  }
+  /* Streams take the frames in order; a writer that is ahead waits */
+  std::unique_lock<std::mutex> lock(streamMutex_);
+  streamTurn_.wait(lock, [this, frame]() { return nextWrite_ == frame; });
+  const std::vector<sf::Color> &pixels = rasterizer.getPixels();
+  const bool written = std::fwrite(pixels.data(), sizeof(sf::Color),
+                                   pixels.size(),
+                                   stream_) == pixels.size();
+  ++nextWrite_;
+  lock.unlock();
+  streamTurn_.notify_all();
+  return written;
+}
+
+}  // namespace app
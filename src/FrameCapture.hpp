@@ -0,0 +1,114 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_FRAMECAPTURE_HPP
+#define SFMLTEST_FRAMECAPTURE_HPP
+
+#include <SFML/Graphics/Color.hpp>   // for Color
+#include <SFML/Graphics/Vertex.hpp>  // for Vertex
+#include <SFML/System/Vector2.hpp>   // for Vector2u
+#include <atomic>                    // for atomic
+#include <condition_variable>        // for condition_variable
+#include <cstddef>                   // for size_t
+#include <cstdint>                   // for uint64_t
+#include <cstdio>                    // for FILE
+#include <mutex>                     // for mutex
+#include <string>                    // for string
+#include <thread>                    // for thread
+#include <vector>                    // for vector
+
+namespace app {
+
+class Rasterizer;
+
+enum class CaptureOutput {
+  IMAGES = 0,   /*< One image file per frame */
+  RAW_FILE = 1, /*< Raw RGBA frames back to back in one file */
+  PIPE = 2      /*< Raw RGBA frames to the stdin of a command */
+};
+
+struct CaptureSettings {
+  CaptureOutput output{CaptureOutput::IMAGES};
+  std::string target;        /*< Image prefix, file or shell command */
+  std::string format{"ppm"}; /*< Image extension, ppm or png */
+  sf::Vector2u size;         /*< Frame size in pixels */
+  sf::Color background{sf::Color::Black};
+  std::size_t slots{4};   /*< Frames in flight, the size of the pool */
+  std::size_t points{0};  /*< Points preallocated per slot */
+  std::size_t writers{2}; /*< Worker threads */
+};
+
+/* "pipe:COMMAND" pipes raw frames into COMMAND, "FILE.rgba" writes them to
+ * FILE.rgba, "PREFIX.png" and "PREFIX.ppm" write PREFIX000000.png... and
+ * anything else is a PPM prefix. Returns false for an empty target. */
+bool parseCaptureTarget(const std::string &target, CaptureSettings &settings);
+
+struct CaptureStats {
+  std::uint64_t captured{0}; /*< Frames taken into the pool */
+  std::uint64_t written{0};  /*< Frames on disk or in the pipe */
+  std::uint64_t dropped{0};  /*< Frames refused because the pool was full */
+  std::uint64_t failed{0};   /*< Frames lost to write errors */
+};
+
+/* Records the frames of the interactive app without stalling it.
+ * submit() copies a frame's points into a free slot of a fixed pool and
+ * returns at once; when every slot is still in flight the frame is dropped
+ * and counted instead of waiting. Writer threads render the slots with
+ * their own Rasterizer, give the slot back and then write the image, so a
+ * slow disk or encoder only ever costs dropped frames. Raw and piped
+ * output keep the frame order; image files are numbered by frame. */
+class FrameCapture {
+ public:
+  FrameCapture() = default;
+  FrameCapture(const FrameCapture &) = delete;
+  FrameCapture(FrameCapture &&) = delete;
+  FrameCapture &operator=(const FrameCapture &) = delete;
+  FrameCapture &operator=(FrameCapture &&) = delete;
+  ~FrameCapture();
+
+  /* Opens the output, preallocates the pool and starts the writers */
+  bool start(const CaptureSettings &settings, std::string &error);
+  /* Writes the frames still queued, then joins the writers */
+  void stop();
+  /* Queues a frame; false if it was dropped. Render thread only. */
+  bool submit(const std::vector<sf::Vertex> &vertices);
+
+  [[nodiscard]] bool isRunning() const { return !workers_.empty(); }
+  [[nodiscard]] CaptureStats getStats() const;
+
+ private:
+  struct Slot {
+    std::vector<sf::Vertex> points;
+    std::uint64_t frame{0};
+  };
+
+  void workerLoop();
+  bool write(const Rasterizer &rasterizer, std::uint64_t frame);
+
+  CaptureSettings settings_;
+  std::vector<Slot> slots_;
+  std::vector<std::size_t> free_;  /*< Slots the render thread may fill */
+  std::vector<std::size_t> ready_; /*< Ring of filled slots, oldest first */
+  std::size_t readyHead_{0};
+  std::size_t readyCount_{0};
+  bool stopping_{false};
+  std::mutex mutex_; /*< Guards free_, ready_ and stopping_ */
+  std::condition_variable readyChanged_;
+
+  std::FILE *stream_{nullptr}; /*< Raw file or pipe */
+  std::uint64_t nextWrite_{0}; /*< Frame whose turn it is on stream_ */
+  std::mutex streamMutex_;
+  std::condition_variable streamTurn_;
+
+  std::vector<std::thread> workers_;
+  std::uint64_t frame_{0}; /*< Next frame number, render thread only */
+  std::atomic<std::uint64_t> captured_{0};
+  std::atomic<std::uint64_t> written_{0};
+  std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<std::uint64_t> failed_{0};
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_FRAMECAPTURE_HPP
@@ -0,0 +1,444 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "Headless.hpp"
+
+#include <spdlog/fmt/fmt.h>  // for print, format
+
+#include <algorithm>  // for max, min
+#include <chrono>     // for steady_clock, duration
+#include <cerrno>     // for errno, ERANGE
+#include <cmath>      // for cos, sin
+#include <cstdint>    // for uint64_t
+#include <cstdio>     // for stderr, stdout
+#include <cstdlib>    // for strtof, strtoull
+#include <limits>     // for numeric_limits
+#include <string>     // for string, operator==
+
+#include "Command.hpp"            // for Command, applyCommand
+#include "EmitterManager.hpp"     // for EmitterManager
+#include "ParticleSystem.hpp"     // for ParticleSystem
+#include "Rasterizer.hpp"         // for Rasterizer
+#include "Recording.hpp"          // for Recorder, Replayer
+#include "detail/Profiler.hpp"    // for Profiler, APP_PROFILE_SCOPE
+#include "detail/ThreadPool.hpp"  // for ThreadPool
+
+namespace app {
+
+namespace {
+
+/* Particles an emit command carries at most */
+constexpr std::uint64_t COMMAND_COUNT_MAX =
+    std::numeric_limits<decltype(Command::count)>::max();
+
+/* Whole argument must be a number no larger than max, otherwise the
+ * option is rejected */
+template <typename Count>
+bool parseCount(const char *text, Count &out,
+                std::uint64_t max = std::numeric_limits<Count>::max()) {
+  char *end = nullptr;
+  errno = 0;
+  const std::uint64_t value = std::strtoull(text, &end, 10);
+  out = static_cast<Count>(value);
+  return end != text && *end == '\0' && text[0] != '-' && errno != ERANGE &&
+         value <= max;
+}
+
+bool parseFloat(const char *text, float &out) {
+  char *end = nullptr;
+  out = std::strtof(text, &end);
+  return end != text && *end == '\0';
+}
+
+/* "x,y" */
+bool parseVector(const char *text, sf::Vector2f &out) {
+  char *end = nullptr;
+  out.x = std::strtof(text, &end);
+  if (end == text || *end != ',') {
+    return false;
+  }
+  return parseFloat(end + 1, out.y);
+}
+
+/* FNV-1a over every particle attribute; equal runs print equal sums */
+std::uint64_t checksum(const ParticleStore &particles) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  /* Sized by each array's own element type */
+  const auto mix = [&hash](const auto &array) {
+    const auto *bytes = reinterpret_cast<const unsigned char *>(array.data());
+    const std::size_t size = array.size() * sizeof(array[0]);
+    for (std::size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+  };
+  mix(particles.x);
+  mix(particles.y);
+  mix(particles.vx);
+  mix(particles.vy);
+  mix(particles.color);
+  mix(particles.age);
+  mix(particles.lifetime);
+  return hash;
+}
+
+/* Renders the particles as the next frame of the sequence, if one is
+ * requested and the step is due */
+bool writeFrame(const HeadlessOptions &options, std::uint64_t step,
+                const ParticleSystem &system, Rasterizer &rasterizer,
+                std::uint64_t &frames) {
+  if (options.frames.empty() || step % options.frameInterval != 0) {
+    return true;
+  }
+  if (rasterizer.getSize() != system.getCanvasSize()) {
+    rasterizer.setSize(system.getCanvasSize());
+  }
+  rasterizer.clear();
+  rasterizer.draw(system.getParticles());
+  const std::string path =
+      fmt::format("{}{:06}.{}", options.frames, frames, options.frameFormat);
+  if (!rasterizer.save(path)) {
+    fmt::print(stderr, "cannot write frame {}\n", path);
+    return false;
+  }
+  ++frames;
+  return true;
+}
+
+int runReplay(const HeadlessOptions &options) {
+  Replayer replayer;
+  std::string error;
+  if (!replayer.open(options.replay, error)) {
+    fmt::print(stderr, "{}\n", error);
+    return 1;
+  }
+  /* The log restores every setting, canvas and capacity included */
+  ParticleSystem system{options.canvas};
+  EmitterManager emitters;
+  if (!replayer.seek(options.seek, system, emitters)) {
+    fmt::print(stderr, "cannot restore the state of {}\n", options.replay);
+    return 1;
+  }
+  const std::uint64_t from = replayer.getStep();
+  Rasterizer rasterizer;
+  std::uint64_t frames{0};
+
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  while (replayer.step(system, emitters)) {
+    if (!writeFrame(options, replayer.getStep(), system, rasterizer,
+                    frames)) {
+      return 1;
+    }
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+  const double seconds = elapsed.count();
+  const auto steps = static_cast<double>(replayer.getStep() - from);
+  fmt::print(stdout,
+             "{{\"replay\": \"{}\", \"from_step\": {}, \"steps\": {}, "
+             "\"checkpoints\": {}, \"seconds\": {:.6f}, "
+             "\"steps_per_sec\": {:.2f}, \"final_particles\": {}, "
+             "\"frames\": {}, \"threads\": {}, \"checksum\": \"{:016x}\"}}\n",
+             options.replay, from, replayer.getStep() - from,
+             replayer.getCheckpoints().size(), seconds,
+             seconds > 0 ? steps / seconds : 0.0,
+             system.getNumberOfParticles(), frames,
+             ThreadPool::instance().concurrency(),
+             checksum(system.getParticles()));
+  return 0;
+}
+
+}  // namespace
+
+/************************************************************/
+bool parseCommandLine(int argc, const char *const *argv,
+                      HeadlessOptions &options, std::string &error) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg{argv[i]};
+    if (arg == "--headless") {
+      options.headless = true;
+      continue;
+    }
+    if (arg == "--help" || arg == "-h") {
+      options.help = true;
+      continue;
+    }
+    if (arg == "--dissolve") {
+      options.dissolve = true;
+      continue;
+    }
+    if (arg == "--compact") {
+      options.compact = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      error = fmt::format("unknown option or missing value: {}", arg);
+      return false;
+    }
+    const char *value = argv[++i];
+    bool valid{false};
+    if (arg == "--particles") {
+      valid = parseCount(value, options.particles, COMMAND_COUNT_MAX);
+    } else if (arg == "--rate") {
+      valid = parseCount(value, options.emissionRate, COMMAND_COUNT_MAX);
+    } else if (arg == "--emitters") {
+      valid = parseCount(value, options.emitters);
+    } else if (arg == "--steps") {
+      valid = parseCount(value, options.steps);
+    } else if (arg == "--seed") {
+      valid = parseCount(value, options.seed);
+    } else if (arg == "--threads") {
+      valid = parseCount(value, options.threads);
+    } else if (arg == "--step-rate") {
+      valid = parseFloat(value, options.stepRate) && options.stepRate > 0;
+    } else if (arg == "--gravity") {
+      valid = parseVector(value, options.gravity);
+    } else if (arg == "--capacity") {
+      valid = parseCount(value, options.capacity);
+    } else if (arg == "--overflow") {
+      const std::string policy{value};
+      valid = policy == "drop" || policy == "oldest" || policy == "transparent";
+      options.overflow = policy == "oldest" ? OverflowPolicy::RECYCLE_OLDEST
+                         : policy == "transparent"
+                             ? OverflowPolicy::RECYCLE_MOST_TRANSPARENT
+                             : OverflowPolicy::DROP_NEW;
+    } else if (arg == "--interaction") {
+      const std::string type{value};
+      valid = type == "repulsion" || type == "cohesion" || type == "collision";
+      PairForce force;
+      force.type = type == "cohesion"    ? PairForceType::COHESION
+                   : type == "collision" ? PairForceType::COLLISION
+                                         : PairForceType::REPULSION;
+      options.interactions.push_back(force);
+    } else if (arg == "--field") {
+      const std::string type{value};
+      valid = type == "attractor" || type == "repulsor" || type == "vortex" ||
+              type == "drag" || type == "noise";
+      /* Centred fields sit in the middle of the canvas */
+      ForceField field;
+      field.position = sf::Vector2f{static_cast<float>(options.canvas.x) / 2,
+                                    static_cast<float>(options.canvas.y) / 2};
+      field.type = type == "vortex"  ? ForceFieldType::VORTEX
+                   : type == "drag"  ? ForceFieldType::DRAG
+                   : type == "noise" ? ForceFieldType::NOISE
+                                     : ForceFieldType::ATTRACTOR;
+      field.strength = type == "repulsor" ? -1.0F : 1.0F;
+      options.fields.push_back(field);
+    } else if (arg == "--bounds") {
+      const std::string mode{value};
+      valid = mode == "cull" || mode == "wrap" || mode == "bounce";
+      options.bounds = mode == "wrap"     ? BoundsMode::WRAP
+                       : mode == "bounce" ? BoundsMode::BOUNCE
+                                          : BoundsMode::CULL;
+    } else if (arg == "--cell-size") {
+      valid = parseFloat(value, options.cellSize) && options.cellSize >= 0;
+    } else if (arg == "--sort-every") {
+      valid = parseCount(value, options.sortInterval);
+    } else if (arg == "--sort-disorder") {
+      valid = parseFloat(value, options.sortThreshold) &&
+              options.sortThreshold >= 0;
+    } else if (arg == "--shards") {
+      valid = parseCount(value, options.shards);
+    } else if (arg == "--record") {
+      options.record = value;
+      valid = !options.record.empty();
+    } else if (arg == "--checkpoint-every") {
+      valid = parseCount(value, options.checkpointInterval);
+    } else if (arg == "--replay") {
+      options.replay = value;
+      valid = !options.replay.empty();
+    } else if (arg == "--seek") {
+      valid = parseCount(value, options.seek);
+    } else if (arg == "--frames") {
+      options.frames = value;
+      valid = !options.frames.empty();
+    } else if (arg == "--frame-format") {
+      options.frameFormat = value;
+      valid = options.frameFormat == "ppm" || options.frameFormat == "png";
+    } else if (arg == "--frame-every") {
+      valid = parseCount(value, options.frameInterval) &&
+              options.frameInterval > 0;
+    } else if (arg == "--trace") {
+      options.trace = value;
+      valid = !options.trace.empty();
+    } else if (arg == "--lifetime") {
+      valid = parseVector(value, options.lifetime) &&
+              options.lifetime.x > 0 &&
+              options.lifetime.y >= options.lifetime.x;
+    } else if (arg == "--curves") {
+      const std::string curves{value};
+      valid = curves == "fade" || curves == "fire" || curves == "ice";
+      options.curves = curves == "fire"  ? LifetimeCurves::fire()
+                       : curves == "ice" ? LifetimeCurves::ice()
+                                         : LifetimeCurves::fade();
+    } else if (arg == "--shape") {
+      const std::string shape{value};
+      valid = shape == "circle" || shape == "square";
+      options.shape = shape == "square" ? Shape::SQUARE : Shape::CIRCLE;
+    } else {
+      error = fmt::format("unknown option: {}", arg);
+      return false;
+    }
+    if (!valid) {
+      error = fmt::format("invalid value for {}: {}", arg, value);
+      return false;
+    }
+  }
+  return true;
+}
+
+/************************************************************/
+std::string commandLineUsage() {
+  return "usage: SFMLTest [--headless [options]]\n"
+         "  --particles N    particles emitted before the first step,\n"
+         "                   below 2^32\n"
+         "  --rate N         particles emitted every step, below 2^32\n"
+         "  --emitters N     split the rate over N emitters on a ring\n"
+         "  --gravity X,Y    constant gravity\n"
+         "  --shape S        circle or square\n"
+         "  --steps N        simulation steps to run\n"
+         "  --seed N         emission seed\n"
+         "  --step-rate F    simulated steps per second\n"
+         "  --dissolve       age particles until their lifetime is up\n"
+         "  --lifetime MIN,MAX\n"
+         "                   lifetime range in seconds\n"
+         "  --curves C       fade, fire or ice colours over the lifetime\n"
+         "  --bounds B       cull, wrap or bounce at the canvas edges\n"
+         "  --threads N      worker threads, 0 = all cores\n"
+         "  --capacity N     live particle limit, 0 = unbounded\n"
+         "  --overflow P     drop, oldest or transparent at capacity\n"
+         "  --interaction T  add a repulsion, cohesion or collision force\n"
+         "  --cell-size F    interaction grid cell, 0 = largest radius\n"
+         "  --field T        add an attractor, repulsor, vortex, drag or\n"
+         "                   noise field\n"
+         "  --sort-every N   sort particles in Z-order every N steps\n"
+         "  --sort-disorder F\n"
+         "                   also sort once F of neighbours are out of order\n"
+         "  --compact        keep particles quantized, 16 bytes each\n"
+         "  --shards N       split the canvas into N strips, one per shard\n"
+         "  --trace FILE     write a Chrome trace of the run\n"
+         "  --record FILE    log the run for --replay\n"
+         "  --checkpoint-every N\n"
+         "                   also save the full state every N steps\n"
+         "  --replay FILE    rerun a session log instead of a scenario\n"
+         "  --seek N         start the replay at step N\n"
+         "  --frames PREFIX  render frames on the CPU to PREFIX000000.ppm...\n"
+         "  --frame-format F ppm or png\n"
+         "  --frame-every N  render every N-th step\n";
+}
+
+/************************************************************/
+int runHeadless(const HeadlessOptions &options) {
+  ThreadPool::Initialize(options.threads);
+  APP_PROFILE_THREAD("headless");
+  if (!options.replay.empty()) {
+    return runReplay(options);
+  }
+
+  ParticleSystem system{options.canvas};
+  system.setSeed(options.seed);
+  system.setShape(options.shape);
+  system.setGravity(options.gravity);
+  system.setCapacity(options.capacity);
+  system.setOverflowPolicy(options.overflow);
+  system.setBoundsMode(options.bounds);
+  for (const auto &force : options.interactions) {
+    system.addPairForce(force);
+  }
+  system.setInteractionCellSize(options.cellSize);
+  system.setSpatialSort(options.sortInterval, options.sortThreshold);
+  system.setCompact(options.compact);
+  system.setShards(options.shards);
+  for (const auto &field : options.fields) {
+    system.addForceField(field);
+  }
+  if (options.dissolve) {
+    system.setDissolve();
+  }
+  system.setLifetime(options.lifetime.x, options.lifetime.y);
+  system.setLifetimeCurves(options.curves);
+  system.setPosition(static_cast<float>(options.canvas.x) / 2,
+                     static_cast<float>(options.canvas.y) / 2);
+
+  const float deltaTime = 1.0F / options.stepRate;
+  /* Emitters on a ring, together emitting the same rate as the system */
+  EmitterManager emitters;
+  constexpr float twoPi = 2.0F * 3.14159265F;
+  const float ring = 0.35F * static_cast<float>(std::min(options.canvas.x,
+                                                         options.canvas.y));
+  for (std::size_t i = 0; i < options.emitters; ++i) {
+    const float angle =
+        twoPi * static_cast<float>(i) / static_cast<float>(options.emitters);
+    Emitter emitter;
+    emitter.position = sf::Vector2f{
+        static_cast<float>(options.canvas.x) / 2 + ring * std::cos(angle),
+        static_cast<float>(options.canvas.y) / 2 + ring * std::sin(angle)};
+    emitter.shape = options.shape;
+    emitter.rate = static_cast<float>(options.emissionRate) * options.stepRate /
+                   static_cast<float>(options.emitters);
+    emitters.add(emitter);
+  }
+  /* Emission goes through commands so a recording can replay it */
+  Recorder recorder;
+  if (!options.record.empty() &&
+      !recorder.open(options.record, system, emitters, deltaTime,
+                     options.checkpointInterval)) {
+    fmt::print(stderr, "cannot record to {}\n", options.record);
+    return 1;
+  }
+  const auto apply = [&](const Command &command) {
+    applyCommand(command, system, emitters);
+    recorder.record(command);
+  };
+  std::uint64_t particleSteps{0};
+  std::size_t peak{0};
+  Rasterizer rasterizer;
+  std::uint64_t frames{0};
+
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  apply(Command::emit(static_cast<std::uint32_t>(options.particles)));
+  for (std::uint64_t step = 0; step < options.steps; ++step) {
+    APP_PROFILE_SCOPE("Headless::step");
+    if (options.emitters > 0) {
+      emitters.emit(system, deltaTime);
+    } else if (options.emissionRate > 0) {
+      apply(Command::emit(static_cast<std::uint32_t>(options.emissionRate)));
+    }
+    const auto live = static_cast<std::size_t>(system.getNumberOfParticles());
+    peak = std::max(peak, live);
+    particleSteps += live;
+    system.update(deltaTime);
+    recorder.step(system, emitters);
+    if (!writeFrame(options, step + 1, system, rasterizer, frames)) {
+      return 1;
+    }
+  }
+  recorder.close();
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+  const double seconds = elapsed.count();
+  const double perSecond = seconds > 0 ? 1.0 / seconds : 0.0;
+  fmt::print(stdout,
+             "{{\"steps\": {}, \"seconds\": {:.6f}, \"steps_per_sec\": {:.2f}, "
+             "\"particle_steps_per_sec\": {:.0f}, \"peak_particles\": {}, "
+             "\"final_particles\": {}, \"allocated\": {}, \"recycled\": {}, "
+             "\"dropped\": {}, \"frames\": {}, \"threads\": {}, "
+             "\"shards\": {}, \"seed\": {}, \"checksum\": \"{:016x}\"}}\n",
+             options.steps, seconds,
+             static_cast<double>(options.steps) * perSecond,
+             static_cast<double>(particleSteps) * perSecond, peak,
+             system.getNumberOfParticles(), system.getPoolStats().allocated,
+             system.getPoolStats().recycled, system.getPoolStats().dropped,
+             frames, ThreadPool::instance().concurrency(),
+             system.getShards(), options.seed,
+             checksum(system.getParticles()));
+  if (!options.trace.empty() && !Profiler::exportChromeTrace(options.trace)) {
+    fmt::print(stderr, "cannot write trace to {}\n", options.trace);
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace app
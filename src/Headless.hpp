@@ -0,0 +1,73 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_HEADLESS_HPP
+#define SFMLTEST_HEADLESS_HPP
+
+#include <SFML/System/Vector2.hpp>  // for Vector2f, Vector2u
+#include <cstddef>                  // for size_t
+#include <cstdint>                  // for uint64_t
+#include <string>                   // for string
+#include <vector>                   // for vector
+
+#include "ForceField.hpp"      // for ForceField
+#include "KernelFeatures.hpp"  // for BoundsMode
+#include "Lifetime.hpp"        // for LifetimeCurves
+#include "PairForce.hpp"       // for PairForce
+#include "ParticleSystem.hpp"  // for Shape, OverflowPolicy
+
+namespace app {
+
+/* Scenario for a run without window or GL context */
+struct HeadlessOptions {
+  bool headless{false};              /*< --headless given */
+  bool help{false};                  /*< --help given */
+  std::size_t particles{100000};     /*< Particles emitted up front */
+  std::size_t emissionRate{0};       /*< Particles emitted every step */
+  std::size_t emitters{0};           /*< Share the rate, 0 = system emits */
+  sf::Vector2f gravity;              /*< Constant gravity */
+  Shape shape{Shape::CIRCLE};        /*< Emission distribution */
+  std::uint64_t steps{1000};         /*< Simulation steps to run */
+  std::uint64_t seed{0};             /*< Emission seed */
+  float stepRate{50.0F};             /*< Steps per simulated second */
+  bool dissolve{false};              /*< Age particles until they expire */
+  bool compact{false};               /*< Quantized particle state */
+  sf::Vector2f lifetime{1.0F, 1.5F}; /*< Seconds, min and max */
+  /* Colour and alpha over the lifetime */
+  LifetimeCurves curves{LifetimeCurves::fade()};
+  sf::Vector2u canvas{1400, 1000}; /*< Simulation bounds */
+  std::size_t threads{0};          /*< 0 = hardware concurrency */
+  std::size_t capacity{0};         /*< Live particle limit, 0 = none */
+  std::string trace;               /*< Chrome trace file, empty = none */
+  /* Behaviour once capacity is reached */
+  OverflowPolicy overflow{OverflowPolicy::DROP_NEW};
+  std::vector<PairForce> interactions; /*< Pairwise forces, in order */
+  std::vector<ForceField> fields;      /*< Force fields, in order */
+  float cellSize{0};                   /*< Interaction cell, 0 = auto */
+  std::uint32_t sortInterval{0};       /*< Steps per spatial sort, 0 = off */
+  float sortThreshold{0};              /*< Disorder forcing a sort, 0 = off */
+  std::size_t shards{0};               /*< Canvas strips, below 2 = off */
+  BoundsMode bounds{BoundsMode::CULL}; /*< Canvas edge handling */
+  std::string record;                  /*< Session log to write */
+  std::uint64_t checkpointInterval{0}; /*< Steps, 0 = no checkpoints */
+  std::string replay;                  /*< Session log to run instead */
+  std::uint64_t seek{0};               /*< First replayed step */
+  std::string frames;                  /*< Frame file prefix, empty = none */
+  std::string frameFormat{"ppm"};      /*< ppm or png */
+  std::uint64_t frameInterval{1};      /*< Steps per rendered frame */
+};
+
+/* Parses argv into options; on failure returns false and sets error */
+bool parseCommandLine(int argc, const char *const *argv,
+                      HeadlessOptions &options, std::string &error);
+[[nodiscard]] std::string commandLineUsage();
+
+/* Runs the scenario, or replays a session log, optionally rendering frames
+ * on the CPU, and prints throughput and a checksum of the final particles
+ * as JSON to stdout */
+int runHeadless(const HeadlessOptions &options);
+
+}  // namespace app
+
+#endif  // SFMLTEST_HEADLESS_HPP
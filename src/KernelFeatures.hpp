@@ -0,0 +1,57 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_KERNELFEATURES_HPP
+#define SFMLTEST_KERNELFEATURES_HPP
+
+#include <cstddef>  // for size_t
+
+namespace app {
+
+/* What happens to particles that leave the canvas */
+enum class BoundsMode {
+  CULL = 0,  /*< They die */
+  WRAP = 1,  /*< They re-enter on the opposite edge */
+  BOUNCE = 2 /*< They are mirrored back and their velocity flips */
+};
+
+constexpr std::size_t BOUNDS_MODES = 3;
+
+/* Feature combination an update kernel is specialised for. Each feature
+ * that is off is compiled out of the kernel instead of being tested per
+ * particle. */
+struct KernelFeatures {
+  bool dissolve{false}; /*< Particles age, recolour and expire */
+  bool gravity{false};  /*< Velocities change by a constant */
+  bool fields{false};   /*< Force fields run before integration */
+  BoundsMode bounds{BoundsMode::CULL};
+
+  constexpr bool operator==(const KernelFeatures &) const = default;
+};
+
+/* Number of specialised kernels, one per feature combination */
+constexpr std::size_t KERNEL_VARIANTS = 2 * 2 * 2 * BOUNDS_MODES;
+
+/* Dense index of a combination into the dispatch table; the flags are the
+ * low bits, the bounds mode the rest */
+constexpr std::size_t kernelIndex(const KernelFeatures &features) {
+  return static_cast<std::size_t>(features.dissolve) |
+         static_cast<std::size_t>(features.gravity) << 1U |
+         static_cast<std::size_t>(features.fields) << 2U |
+         static_cast<std::size_t>(features.bounds) << 3U;
+}
+
+/* Inverse of kernelIndex for index < KERNEL_VARIANTS */
+constexpr KernelFeatures kernelFeatures(std::size_t index) {
+  KernelFeatures features;
+  features.dissolve = (index & 1U) != 0;
+  features.gravity = (index & 2U) != 0;
+  features.fields = (index & 4U) != 0;
+  features.bounds = static_cast<BoundsMode>(index >> 3U);
+  return features;
+}
+
+}  // namespace app
+
+#endif  // SFMLTEST_KERNELFEATURES_HPP
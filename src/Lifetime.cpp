@@ -0,0 +1,126 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "Lifetime.hpp"
+
+#include <SFML/Config.hpp>   // for Uint8
+#include <algorithm>         // for clamp, min
+#include <cmath>             // for lround
+#include <cstring>           // for memcpy
+#include <initializer_list>  // for initializer_list
+
+namespace app {
+
+namespace {
+
+std::uint32_t pack(const sf::Color &color) {
+  static_assert(sizeof(sf::Color) == sizeof(std::uint32_t));
+  std::uint32_t word{0};
+  std::memcpy(&word, &color, sizeof(word));
+  return word;
+}
+
+sf::Color unpack(std::uint32_t word) {
+  std::array<sf::Uint8, 4> bytes{};
+  std::memcpy(bytes.data(), &word, sizeof(word));
+  return sf::Color{bytes[0], bytes[1], bytes[2], bytes[3]};
+}
+
+sf::Color mix(const sf::Color &from, const sf::Color &to, float t) {
+  const auto channel = [t](sf::Uint8 a, sf::Uint8 b) {
+    return static_cast<sf::Uint8>(std::lround(
+        static_cast<float>(a) +
+        (static_cast<float>(b) - static_cast<float>(a)) * t));
+  };
+  return sf::Color{channel(from.r, to.r), channel(from.g, to.g),
+                   channel(from.b, to.b), channel(from.a, to.a)};
+}
+
+LifetimeCurves makeCurves(std::initializer_list<CurveStop> stops, bool tint) {
+  LifetimeCurves curves;
+  for (const auto &stop : stops) {
+    curves.stops[curves.count++] = stop;
+  }
+  curves.tint = tint;
+  return curves;
+}
+
+}  // namespace
+
+/************************************************************/
+LifetimeCurves LifetimeCurves::fade() {
+  return makeCurves({{0.0F, sf::Color{255, 255, 255, 255}},
+                     {1.0F, sf::Color{255, 255, 255, 0}}},
+                    false);
+}
+
+/************************************************************/
+LifetimeCurves LifetimeCurves::fire() {
+  return makeCurves({{0.0F, sf::Color{255, 240, 160, 255}},
+                     {0.25F, sf::Color{255, 150, 20, 230}},
+                     {0.6F, sf::Color{200, 40, 10, 150}},
+                     {1.0F, sf::Color{60, 60, 60, 0}}},
+                    true);
+}
+
+/************************************************************/
+LifetimeCurves LifetimeCurves::ice() {
+  return makeCurves({{0.0F, sf::Color{255, 255, 255, 255}},
+                     {0.4F, sf::Color{120, 220, 255, 220}},
+                     {1.0F, sf::Color{20, 60, 200, 0}}},
+                    true);
+}
+
+/************************************************************/
+bool LifetimeCurves::operator==(const LifetimeCurves &other) const {
+  if (count != other.count || tint != other.tint) {
+    return false;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    if (stops[i].age != other.stops[i].age ||
+        stops[i].color != other.stops[i].color) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/************************************************************/
+void LifetimeTable::bake(const LifetimeCurves &curves) {
+  mask_ = curves.tint ? ~std::uint32_t{0} : pack(sf::Color{0, 0, 0, 255});
+  const std::size_t count = std::min(curves.count, MAX_CURVE_STOPS);
+  if (count == 0) {
+    colors_.fill(pack(sf::Color::White));
+    return;
+  }
+  std::size_t next{0}; /*< First stop past the current age */
+  for (std::size_t i = 0; i < SIZE; ++i) {
+    const float age = static_cast<float>(i) / static_cast<float>(SIZE - 1);
+    while (next < count && curves.stops[next].age <= age) {
+      ++next;
+    }
+    sf::Color color;
+    if (next == 0) {
+      color = curves.stops[0].color;
+    } else if (next == count) {
+      color = curves.stops[count - 1].color;
+    } else {
+      const CurveStop &from = curves.stops[next - 1];
+      const CurveStop &to = curves.stops[next];
+      color = mix(from.color, to.color,
+                  std::clamp((age - from.age) / (to.age - from.age), 0.0F,
+                             1.0F));
+    }
+    colors_[i] = pack(color);
+  }
+}
+
+/************************************************************/
+sf::Color LifetimeTable::sample(float age) const {
+  const auto entry = static_cast<std::size_t>(
+      std::clamp(age, 0.0F, 1.0F) * static_cast<float>(SIZE - 1));
+  return unpack(colors_[entry]);
+}
+
+}  // namespace app
@@ -0,0 +1,63 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_LIFETIME_HPP
+#define SFMLTEST_LIFETIME_HPP
+
+#include <SFML/Graphics/Color.hpp>  // for Color
+#include <array>                    // for array
+#include <cstddef>                  // for size_t
+#include <cstdint>                  // for uint32_t
+
+namespace app {
+
+/* One key of a curve; age is normalized, 0 at birth and 1 at expiry */
+struct CurveStop {
+  float age{0};
+  sf::Color color;
+};
+
+constexpr std::size_t MAX_CURVE_STOPS = 4;
+
+/* How particles look over their life: up to MAX_CURVE_STOPS stops in
+ * ascending age, interpolated linearly and held flat before the first and
+ * after the last. Alpha always follows the curve; the colour only with
+ * tint set, otherwise particles keep the colour they were emitted with.
+ * Fixed size, so a Command can carry it. */
+struct LifetimeCurves {
+  std::array<CurveStop, MAX_CURVE_STOPS> stops{};
+  std::size_t count{0};
+  bool tint{false};
+
+  static LifetimeCurves fade(); /*< Emission colour fading out, default */
+  static LifetimeCurves fire(); /*< Yellow to red to smoke */
+  static LifetimeCurves ice();  /*< White to cyan to deep blue */
+
+  bool operator==(const LifetimeCurves &other) const;
+};
+
+/* LifetimeCurves baked into one packed colour per step of normalized age.
+ * The update kernel looks the colour of a particle up rather than
+ * computing it; baking happens only when the curves change. */
+class LifetimeTable {
+ public:
+  static constexpr std::size_t SIZE = 256;
+
+  LifetimeTable() { bake(LifetimeCurves::fade()); }
+
+  void bake(const LifetimeCurves &curves);
+  /* SIZE colours, each sf::Color's four bytes as one word */
+  [[nodiscard]] const std::uint32_t *data() const { return colors_.data(); }
+  /* Bits of a colour word the table replaces; the rest is kept */
+  [[nodiscard]] std::uint32_t mask() const { return mask_; }
+  [[nodiscard]] sf::Color sample(float age) const;
+
+ private:
+  std::array<std::uint32_t, SIZE> colors_{};
+  std::uint32_t mask_{0};
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_LIFETIME_HPP
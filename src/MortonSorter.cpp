@@ -0,0 +1,153 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "MortonSorter.hpp"
+
+#include <algorithm>         // for clamp, min
+#include <initializer_list>  // for initializer_list
+#include <utility>           // for swap
+
+#include "detail/Profiler.hpp"  // for APP_PROFILE_SCOPE
+
+namespace app {
+
+namespace {
+
+constexpr auto AXIS_STEPS =
+    static_cast<float>((1U << MORTON_AXIS_BITS) - 1U);
+
+/* Quantizes value in [0, extent] to MORTON_AXIS_BITS */
+std::uint32_t quantize(float value, float extent) {
+  if (extent <= 0) {
+    return 0;
+  }
+  return static_cast<std::uint32_t>(std::clamp(value / extent, 0.0F, 1.0F) *
+                                    AXIS_STEPS);
+}
+
+/* Moves the low 16 bits of bits into the even bits */
+std::uint32_t spread(std::uint32_t bits) {
+  bits &= 0x0000FFFFU;
+  bits = (bits | (bits << 8U)) & 0x00FF00FFU;
+  bits = (bits | (bits << 4U)) & 0x0F0F0F0FU;
+  bits = (bits | (bits << 2U)) & 0x33333333U;
+  bits = (bits | (bits << 1U)) & 0x55555555U;
+  return bits;
+}
+
+/* mortonCode() of a compact store particle: its fixed-point coordinates
+ * cut down to MORTON_AXIS_BITS */
+std::uint32_t compactCode(const CompactParticleStore &store, std::size_t i) {
+  constexpr std::uint32_t drop = 16U - MORTON_AXIS_BITS;
+  return spread(static_cast<std::uint32_t>(store.x[i]) >> drop) |
+         (spread(static_cast<std::uint32_t>(store.y[i]) >> drop) << 1U);
+}
+
+/* Share of evenly spread neighbour pairs whose codes descend */
+template <typename Code>
+float descents(std::size_t count, std::size_t samples, const Code &code) {
+  if (count < 2) {
+    return 0.0F;
+  }
+  samples = std::min(samples, count - 1);
+  std::size_t descending{0};
+  for (std::size_t sample = 0; sample < samples; ++sample) {
+    const std::size_t i = sample * (count - 1) / samples;
+    descending += static_cast<std::size_t>(code(i) > code(i + 1));
+  }
+  return static_cast<float>(descending) / static_cast<float>(samples);
+}
+
+}  // namespace
+
+/************************************************************/
+std::uint32_t mortonCode(float x, float y, float width, float height) {
+  return spread(quantize(x, width)) | (spread(quantize(y, height)) << 1U);
+}
+
+/************************************************************/
+void MortonSorter::reserve(std::size_t particles) {
+  for (auto *buffer : {&keys_, &keysBack_, &order_, &orderBack_}) {
+    buffer->reserve(particles);
+  }
+  digits_.reserve(particles);
+}
+
+/************************************************************/
+template <typename Key>
+void MortonSorter::sortBy(std::size_t count, const Key &key,
+                          ThreadPool &pool) {
+  APP_PROFILE_SCOPE("MortonSorter::sort");
+  keys_.resize(count);
+  keysBack_.resize(count);
+  order_.resize(count);
+  orderBack_.resize(count);
+  pool.parallelFor(0, count, SORT_CHUNK,
+                   [&](std::size_t begin, std::size_t end) {
+                     for (std::size_t i = begin; i < end; ++i) {
+                       keys_[i] = key(i);
+                       order_[i] = static_cast<std::uint32_t>(i);
+                     }
+                   });
+
+  passes_ = 0;
+  for (std::size_t pass = 0; pass < PASSES; ++pass) {
+    const auto shift = static_cast<std::uint32_t>(pass * RADIX_BITS);
+    digits_.bin(count, BUCKETS, pool, [&](std::size_t i) {
+      return (keys_[i] >> shift) & static_cast<std::uint32_t>(BUCKETS - 1);
+    });
+    /* A digit shared by every key leaves the order as it is, so that
+     * pass is skipped */
+    const auto &starts = digits_.starts();
+    bool uniform{false};
+    for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+      uniform = uniform || starts[bucket + 1] - starts[bucket] == count;
+    }
+    if (uniform) {
+      continue;
+    }
+    digits_.scatter(pool, [&](std::size_t i, std::uint32_t slot) {
+      keysBack_[slot] = keys_[i];
+      orderBack_[slot] = order_[i];
+    });
+    std::swap(keys_, keysBack_);
+    std::swap(order_, orderBack_);
+    ++passes_;
+  }
+}
+
+/************************************************************/
+void MortonSorter::sort(const ParticleStore &store, float width,
+                        float height, ThreadPool &pool) {
+  sortBy(
+      store.size(),
+      [&](std::size_t i) {
+        return mortonCode(store.x[i], store.y[i], width, height);
+      },
+      pool);
+}
+
+/************************************************************/
+void MortonSorter::sort(const CompactParticleStore &store, ThreadPool &pool) {
+  sortBy(
+      store.size(), [&](std::size_t i) { return compactCode(store, i); },
+      pool);
+}
+
+/************************************************************/
+float MortonSorter::disorder(const ParticleStore &store, float width,
+                             float height) {
+  return descents(store.size(), DISORDER_SAMPLES, [&](std::size_t i) {
+    return mortonCode(store.x[i], store.y[i], width, height);
+  });
+}
+
+/************************************************************/
+float MortonSorter::disorder(const CompactParticleStore &store) {
+  return descents(store.size(), DISORDER_SAMPLES, [&](std::size_t i) {
+    return compactCode(store, i);
+  });
+}
+
+}  // namespace app
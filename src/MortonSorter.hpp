@@ -0,0 +1,81 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_MORTONSORTER_HPP
+#define SFMLTEST_MORTONSORTER_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
+#include <vector>   // for vector
+
+#include "CompactParticleStore.hpp"  // for CompactParticleStore
+#include "ParticleStore.hpp"         // for ParticleStore
+#include "detail/CountingSort.hpp"   // for CountingSort
+#include "detail/ThreadPool.hpp"     // for ThreadPool
+
+namespace app {
+
+/* Bits per coordinate in a Morton code. 1024 steps across the canvas
+ * resolve more than locality needs and keep the sort at two passes. */
+constexpr std::uint32_t MORTON_AXIS_BITS = 10;
+
+/* Position on a width x height canvas as a Z-order (Morton) code: both
+ * coordinates quantized to MORTON_AXIS_BITS and interleaved, x in the even
+ * bits. Nearby positions mostly get nearby codes. Outside the canvas
+ * clamps to the border. */
+[[nodiscard]] std::uint32_t mortonCode(float x, float y, float width,
+                                       float height);
+
+/* Orders particles along the Z-order curve of their positions.
+ * sort() computes the Morton code of every particle, then runs a parallel,
+ * stable LSD radix sort over them: one pass per RADIX_BITS digit, each a
+ * CountingSort like SpatialGrid's. Passes in which every code has the
+ * same digit are skipped, so a small canvas or a tight cluster sorts in
+ * fewer passes. order()[slot] is the store index
+ * that belongs in slot. */
+class MortonSorter {
+ public:
+  void reserve(std::size_t particles);
+
+  void sort(const ParticleStore &store, float width, float height,
+            ThreadPool &pool);
+  /* Same order from the fixed-point positions, no canvas needed */
+  void sort(const CompactParticleStore &store, ThreadPool &pool);
+
+  [[nodiscard]] const std::vector<std::uint32_t> &order() const {
+    return order_;
+  }
+  /* Passes the last sort actually ran */
+  [[nodiscard]] std::size_t getPasses() const { return passes_; }
+
+  /* Share of DISORDER_SAMPLES evenly spread neighbour pairs whose codes
+   * are out of order: 0 right after a sort, about one half for particles
+   * in random order */
+  [[nodiscard]] static float disorder(const ParticleStore &store, float width,
+                                      float height);
+  [[nodiscard]] static float disorder(const CompactParticleStore &store);
+
+  static constexpr std::size_t RADIX_BITS = 10;
+  static constexpr std::size_t DISORDER_SAMPLES = 1024;
+
+ private:
+  static constexpr std::size_t BUCKETS = std::size_t{1} << RADIX_BITS;
+  static constexpr std::size_t PASSES = 2 * MORTON_AXIS_BITS / RADIX_BITS;
+  static constexpr std::size_t SORT_CHUNK = 16384; /*< Keys per task */
+
+  /* Sorts indices [0, count) by key(i) */
+  template <typename Key>
+  void sortBy(std::size_t count, const Key &key, ThreadPool &pool);
+
+  std::vector<std::uint32_t> keys_;        /*< Codes in order_ order */
+  std::vector<std::uint32_t> keysBack_;    /*< Pass output */
+  std::vector<std::uint32_t> order_;       /*< Store index per slot */
+  std::vector<std::uint32_t> orderBack_;   /*< Pass output */
+  CountingSort digits_;                    /*< One pass */
+  std::size_t passes_{0};
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_MORTONSORTER_HPP
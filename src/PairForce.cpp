@@ -0,0 +1,45 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "PairForce.hpp"
+
+#include <algorithm>  // for clamp
+
+#include "detail/Profiler.hpp"  // for APP_PROFILE_SCOPE
+
+namespace app {
+
+/************************************************************/
+void accumulatePairForces(const SpatialGrid &grid, ThreadPool &pool,
+                          const std::vector<PairForce> &forces,
+                          float deltaTime, std::size_t maxNeighbours,
+                          float *dvx, float *dvy) {
+  APP_PROFILE_SCOPE("accumulatePairForces");
+  /* One pass per force keeps every kernel a separate, inlined loop */
+  for (const auto &force : forces) {
+    const float impulse = force.strength * deltaTime;
+    switch (force.type) {
+      case PairForceType::REPULSION: {
+        accumulatePairs(grid, pool, RepulsionKernel{force.radius, impulse},
+                        maxNeighbours, dvx, dvy);
+        break;
+      }
+      case PairForceType::COHESION: {
+        accumulatePairs(grid, pool, CohesionKernel{force.radius, impulse},
+                        maxNeighbours, dvx, dvy);
+        break;
+      }
+      case PairForceType::COLLISION: {
+        accumulatePairs(
+            grid, pool,
+            CollisionKernel{force.radius,
+                            std::clamp(force.strength, 0.0F, 1.0F)},
+            maxNeighbours, dvx, dvy);
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace app
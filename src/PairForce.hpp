@@ -0,0 +1,202 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_PAIRFORCE_HPP
+#define SFMLTEST_PAIRFORCE_HPP
+
+#include <SFML/System/Vector2.hpp>  // for Vector2f
+#include <algorithm>                // for max, min
+#include <cmath>                    // for ceil, sqrt
+#include <cstddef>                  // for size_t, ptrdiff_t
+#include <cstdint>                  // for uint32_t
+#include <vector>                   // for vector
+
+#include "SpatialGrid.hpp"        // for SpatialGrid
+#include "detail/ThreadPool.hpp"  // for ThreadPool
+
+namespace app {
+
+enum class PairForceType { REPULSION = 0, COHESION = 1, COLLISION = 2 };
+
+/* Short-range interaction between neighbouring particles */
+struct PairForce {
+  PairForceType type{PairForceType::REPULSION};
+  float radius{8.0F};   /*< Range in pixels */
+  float strength{1.0F}; /*< Velocity change per second, restitution for
+                             COLLISION */
+};
+
+/* One neighbour as seen from the particle being updated */
+struct PairSample {
+  float dx;    /*< Neighbour position - own position */
+  float dy;    /*< Neighbour position - own position */
+  float dvx;   /*< Neighbour velocity - own velocity */
+  float dvy;   /*< Neighbour velocity - own velocity */
+  float dist2; /*< dx * dx + dy * dy, below radius * radius */
+};
+
+/* Pair kernels return the velocity change one neighbour causes this step.
+ * Anything with a radius member and that call operator can be passed to
+ * accumulatePairs(). Kernels declaring averaged = true have their result
+ * divided by the number of neighbours found. */
+
+/* Pushes apart, linearly stronger towards the centre */
+struct RepulsionKernel {
+  float radius;
+  float impulse; /*< strength * deltaTime */
+
+  sf::Vector2f operator()(const PairSample &s) const {
+    const float dist = std::sqrt(s.dist2);
+    if (dist <= 0) {
+      return {};
+    }
+    const float push = impulse * (1.0F - dist / radius) / dist;
+    return {-s.dx * push, -s.dy * push};
+  }
+};
+
+/* Pulls together, vanishing at contact and at the edge of the range */
+struct CohesionKernel {
+  float radius;
+  float impulse; /*< strength * deltaTime */
+
+  sf::Vector2f operator()(const PairSample &s) const {
+    const float dist = std::sqrt(s.dist2);
+    if (dist <= 0) {
+      return {};
+    }
+    const float r = dist / radius;
+    const float pull = 4.0F * impulse * r * (1.0F - r) / dist;
+    return {s.dx * pull, s.dy * pull};
+  }
+};
+
+/* Discs of diameter radius; closing pairs exchange momentum along the
+ * normal. Each side applies its half, so pairs stay symmetric. Impulses
+ * are averaged over all contacts, otherwise a particle in a dense cluster
+ * would receive the sum of them all and overshoot. */
+struct CollisionKernel {
+  static constexpr bool averaged = true;
+  float radius;
+  float restitution; /*< 0 = plastic, 1 = elastic */
+
+  sf::Vector2f operator()(const PairSample &s) const {
+    const float dist = std::sqrt(s.dist2);
+    if (dist <= 0) {
+      return {};
+    }
+    const float nx = s.dx / dist;
+    const float ny = s.dy / dist;
+    const float closing = s.dvx * nx + s.dvy * ny;
+    if (closing >= 0) {
+      return {};
+    }
+    const float impulse = 0.5F * (1.0F + restitution) * closing;
+    return {nx * impulse, ny * impulse};
+  }
+};
+
+template <typename Kernel>
+constexpr bool isAveraged() {
+  if constexpr (requires { Kernel::averaged; }) {
+    return Kernel::averaged;
+  } else {
+    return false;
+  }
+}
+
+/* Adds kernel's effect on every grid slot to dvx/dvy (grid order, sized
+ * grid.size()). Each particle visits neighbours within kernel.radius
+ * cell by cell and stops after maxNeighbours hits, which bounds the cost
+ * of dense clusters such as the emission point. All inputs are read-only,
+ * so the result does not depend on the thread count. */
+template <typename Kernel>
+void accumulatePairs(const SpatialGrid &grid, ThreadPool &pool,
+                     const Kernel &kernel, std::size_t maxNeighbours,
+                     float *dvx, float *dvy) {
+  const float radius2 = kernel.radius * kernel.radius;
+  const auto reach = static_cast<std::ptrdiff_t>(
+      std::ceil(kernel.radius / grid.getCellSize()));
+  const auto columns = static_cast<std::ptrdiff_t>(grid.getColumns());
+  const auto rows = static_cast<std::ptrdiff_t>(grid.getRows());
+  const std::uint32_t *start = grid.cellStart().data();
+  const float *x = grid.x().data();
+  const float *y = grid.y().data();
+  const float *vx = grid.vx().data();
+  const float *vy = grid.vy().data();
+
+  pool.parallelFor(
+      0, grid.getRows(), 1, [&](std::size_t firstRow, std::size_t lastRow) {
+        for (auto row = static_cast<std::ptrdiff_t>(firstRow);
+             row < static_cast<std::ptrdiff_t>(lastRow); ++row) {
+          const std::ptrdiff_t rowLo = std::max<std::ptrdiff_t>(0, row - reach);
+          const std::ptrdiff_t rowHi = std::min(rows - 1, row + reach);
+          for (std::ptrdiff_t column = 0; column < columns; ++column) {
+            const std::ptrdiff_t colLo =
+                std::max<std::ptrdiff_t>(0, column - reach);
+            const std::ptrdiff_t colHi = std::min(columns - 1, column + reach);
+            const auto cell = static_cast<std::size_t>(row * columns + column);
+            const std::uint32_t own = start[cell];
+            const std::uint32_t ownEnd = start[cell + 1];
+            for (std::uint32_t i = own; i < ownEnd; ++i) {
+              float sumX{0};
+              float sumY{0};
+              std::size_t hits{0};
+              const auto visit = [&](std::uint32_t first, std::uint32_t last) {
+                for (std::uint32_t j = first; j < last && hits < maxNeighbours;
+                     ++j) {
+                  const float dx = x[j] - x[i];
+                  const float dy = y[j] - y[i];
+                  const float dist2 = dx * dx + dy * dy;
+                  if (j == i || dist2 >= radius2) {
+                    continue;
+                  }
+                  const sf::Vector2f dv = kernel(
+                      PairSample{dx, dy, vx[j] - vx[i], vy[j] - vy[i], dist2});
+                  sumX += dv.x;
+                  sumY += dv.y;
+                  ++hits;
+                }
+              };
+              /* Own cell first: in dense clusters it fills the budget
+               * before the wider, mostly out of range rows are scanned */
+              visit(own, ownEnd);
+              for (std::ptrdiff_t r = rowLo; r <= rowHi && hits < maxNeighbours;
+                   ++r) {
+                /* Cells of one grid row are adjacent in slot order */
+                const auto base = static_cast<std::size_t>(r * columns);
+                const std::uint32_t first =
+                    start[base + static_cast<std::size_t>(colLo)];
+                const std::uint32_t last =
+                    start[base + static_cast<std::size_t>(colHi) + 1];
+                if (r == row) {
+                  visit(first, own);
+                  visit(ownEnd, last);
+                } else {
+                  visit(first, last);
+                }
+              }
+              if constexpr (isAveraged<Kernel>()) {
+                if (hits > 0) {
+                  sumX /= static_cast<float>(hits);
+                  sumY /= static_cast<float>(hits);
+                }
+              }
+              dvx[i] += sumX;
+              dvy[i] += sumY;
+            }
+          }
+        }
+      });
+}
+
+/* Runs each force's kernel over the grid, accumulating into dvx/dvy */
+void accumulatePairForces(const SpatialGrid &grid, ThreadPool &pool,
+                          const std::vector<PairForce> &forces,
+                          float deltaTime, std::size_t maxNeighbours,
+                          float *dvx, float *dvy);
+
+}  // namespace app
+
+#endif  // SFMLTEST_PAIRFORCE_HPP
@@ -4,17 +4,14 @@
 
 #include "Particle.hpp"
 
-#include <SFML/Graphics/PrimitiveType.hpp>  // for Points
-#include <SFML/Graphics/RenderTarget.hpp>   // for RenderTarget
-
 namespace app {
 
-void Particle::draw(sf::RenderTarget &target, sf::RenderStates states) const {
-  target.draw(&draw_vertex_, 1, sf::Points, states);
-}
-
 void Particle::updateDrawVertexColorAlpha(const sf::Uint8 &alpha) {
-  draw_vertex_.color.a = static_cast<sf::Uint8>(draw_vertex_.color.a - alpha);
+  /* Saturates at transparent; a wrapped byte would flash back to opaque */
+  draw_vertex_.color.a = draw_vertex_.color.a > alpha
+                             ? static_cast<sf::Uint8>(draw_vertex_.color.a -
+                                                      alpha)
+                             : sf::Uint8{0};
 }
 
 void Particle::updateVelocity(const sf::Vector2f &vel) { velocity_ += vel; }
@@ -5,22 +5,17 @@
 #ifndef SFMLTEST_PARTICLE_HPP
 #define SFMLTEST_PARTICLE_HPP
 
-#include <SFML/Config.hpp>                 // for Uint8
-#include <SFML/Graphics/Color.hpp>         // for Color
-#include <SFML/Graphics/Drawable.hpp>      // for Drawable
-#include <SFML/Graphics/RenderStates.hpp>  // for RenderStates
-#include <SFML/Graphics/Vertex.hpp>        // for Vertex
-#include <SFML/System/Vector2.hpp>         // for Vector2f
-namespace sf {
-class RenderTarget;
-}
+#include <SFML/Config.hpp>            // for Uint8
+#include <SFML/Graphics/Color.hpp>   // for Color
+#include <SFML/Graphics/Vertex.hpp>  // for Vertex
+#include <SFML/System/Vector2.hpp>   // for Vector2f
 
 namespace app {
 
-class Particle : public sf::Drawable {
+/* Plain value type describing a single particle; storage and drawing are
+ * handled in bulk by ParticleStore and ParticleSystem. */
+class Particle {
  public:
-  void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
-
   [[nodiscard]] const sf::Vertex &getDrawVertex() const { return draw_vertex_; }
   [[nodiscard]] const sf::Vector2f &getVelocity() const { return velocity_; }
   void setVelocity(const sf::Vector2f &vel) { velocity_ = vel; }
@@ -31,6 +26,7 @@ class Particle : public sf::Drawable {
     draw_vertex_.position = pos;
   }
 
+  /* Fades by alpha, stopping at transparent */
   void updateDrawVertexColorAlpha(const sf::Uint8 &alpha);
   void updateVelocity(const sf::Vector2f &vel);
 
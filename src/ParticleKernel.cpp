@@ -0,0 +1,310 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "ParticleKernel.hpp"
+
+#include <SFML/Graphics/Color.hpp>  // for Color
+#include <algorithm>                // for clamp, max, min
+#include <array>                    // for array
+#include <cmath>                    // for floor
+#include <utility>                  // for index_sequence
+
+#include "Lifetime.hpp"  // for LifetimeTable
+
+/* The kernels are written once as templates and left to the compiler to
+ * vectorise. SSE2 is part of the x86-64 baseline; the AVX2 instances are
+ * compiled per function and only entered after a runtime CPU check. Their
+ * loops must be force-inlined, or they would be compiled for the baseline
+ * only. */
+#if defined(__x86_64__) || defined(_M_X64)
+#define SFMLTEST_KERNEL_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>  // for _xgetbv
+#include <intrin.h>     // for __cpuid, __cpuidex
+#define SFMLTEST_TARGET_AVX2
+#else
+#define SFMLTEST_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define SFMLTEST_TARGET_AVX2
+#endif
+/* The streams of a store never overlap; IVDEP says so and spares the
+ * vectoriser its runtime alias checks, of which it only does a handful */
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SFMLTEST_INLINE __forceinline
+#define SFMLTEST_IVDEP __pragma(loop(ivdep))
+#elif defined(__clang__)
+#define SFMLTEST_INLINE inline __attribute__((always_inline))
+#define SFMLTEST_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#else
+#define SFMLTEST_INLINE inline __attribute__((always_inline))
+#define SFMLTEST_IVDEP _Pragma("GCC ivdep")
+#endif
+
+namespace app {
+
+namespace {
+
+constexpr std::size_t FIELD_SPAN = 1024; /*< Particles per field pass */
+/* Highest index into the lifetime table */
+constexpr auto LAST_ENTRY = static_cast<float>(LifetimeTable::SIZE - 1);
+
+/* Puts a coordinate that left [0, max] back on the canvas. Nothing bounds
+ * the velocity, gravity keeps adding to it, so a particle may have moved
+ * any number of canvases in one step: wrapping takes the floored
+ * remainder, bouncing mirrors once and clamps the rest. */
+template <BoundsMode Mode>
+SFMLTEST_INLINE float confine(float position, float max, float &velocity) {
+  /* Both candidates are computed up front so the choice is a select */
+  const bool below = position < 0.0F;
+  const bool above = position > max;
+  if constexpr (Mode == BoundsMode::WRAP) {
+    const float wrapped = std::clamp(
+        position - max * std::floor(position / max), 0.0F, max);
+    return (below | above) ? wrapped : position;
+  } else {
+    const float flipped = -velocity;
+    const float mirroredLow = std::min(-position, max);
+    const float mirroredHigh = std::max(2.0F * max - position, 0.0F);
+    velocity = (below | above) ? flipped : velocity;
+    return below ? mirroredLow : (above ? mirroredHigh : position);
+  }
+}
+
+/* One particle's step, with every disabled feature compiled out. Selects
+ * instead of branches, so loops around it vectorise. Colours are handled
+ * as one word each, the lifetime table replaces the masked bits. Returns
+ * whether the particle survives. */
+template <std::size_t Index>
+SFMLTEST_INLINE bool integrateOne(float *__restrict px, float *__restrict py,
+                                  float *__restrict pvx,
+                                  float *__restrict pvy,
+                                  std::uint32_t *__restrict pc,
+                                  float *__restrict page,
+                                  const float *__restrict plife,
+                                  std::size_t i, const KernelParams &params) {
+  constexpr KernelFeatures features = kernelFeatures(Index);
+  float vx = pvx[i];
+  float vy = pvy[i];
+  if constexpr (features.gravity) {
+    vx += params.gravityX;
+    vy += params.gravityY;
+  }
+  float x = px[i] + vx * params.thrust;
+  float y = py[i] + vy * params.thrust;
+  bool alive = true;
+  if constexpr (features.dissolve) {
+    const float age = page[i] + params.aging;
+    const float life = plife[i];
+    page[i] = age;
+    /* The expiring step still reads a valid entry, the last one */
+    const auto entry =
+        static_cast<std::uint32_t>(std::min(age / life, 1.0F) * LAST_ENTRY);
+    pc[i] = (params.lifetimeColors[entry] & params.lifetimeMask) |
+            (pc[i] & ~params.lifetimeMask);
+    alive = age < life;
+  }
+  /* Bitwise rather than logical operators: no short circuit, no branch */
+  if constexpr (features.bounds == BoundsMode::CULL) {
+    alive &= !((x > params.maxX) | (x < 0.0F) | (y > params.maxY) |
+               (y < 0.0F));
+  } else {
+    x = confine<features.bounds>(x, params.maxX, vx);
+    y = confine<features.bounds>(y, params.maxY, vy);
+  }
+  if constexpr (features.gravity || features.bounds == BoundsMode::BOUNCE) {
+    pvx[i] = vx;
+    pvy[i] = vy;
+  }
+  px[i] = x;
+  py[i] = y;
+  return alive;
+}
+
+/* Scalar reference: one fused loop, which the survivor list keeps from
+ * vectorising */
+template <std::size_t Index>
+SFMLTEST_INLINE std::uint32_t *integrateFused(
+    float *__restrict px, float *__restrict py, float *__restrict pvx,
+    float *__restrict pvy, std::uint32_t *__restrict pc,
+    float *__restrict page, const float *__restrict plife,
+    std::uint8_t *__restrict mask, std::uint32_t *__restrict out,
+    std::size_t begin, std::size_t end, const KernelParams &params) {
+  const KernelParams constants = params;
+  for (std::size_t i = begin; i < end; ++i) {
+    const bool alive = integrateOne<Index>(px, py, pvx, pvy, pc, page, plife,
+                                           i, constants);
+    mask[i] = static_cast<std::uint8_t>(alive);
+    /* Branch-free append: always write, only advance on survivors */
+    *out = static_cast<std::uint32_t>(i);
+    out += static_cast<std::size_t>(alive);
+  }
+  return out;
+}
+
+/* Vectorisable split: integrate and write the mask, then list survivors in
+ * a second, cheap pass over the mask bytes */
+template <std::size_t Index>
+SFMLTEST_INLINE std::uint32_t *integrateSplit(
+    float *__restrict px, float *__restrict py, float *__restrict pvx,
+    float *__restrict pvy, std::uint32_t *__restrict pc,
+    float *__restrict page, const float *__restrict plife,
+    std::uint8_t *__restrict mask, std::uint32_t *__restrict out,
+    std::size_t begin, std::size_t end, const KernelParams &params) {
+  const KernelParams constants = params;
+  SFMLTEST_IVDEP
+  for (std::size_t i = begin; i < end; ++i) {
+    mask[i] = static_cast<std::uint8_t>(
+        integrateOne<Index>(px, py, pvx, pvy, pc, page, plife, i, constants));
+  }
+  for (std::size_t i = begin; i < end; ++i) {
+    *out = static_cast<std::uint32_t>(i);
+    out += mask[i];
+  }
+  return out;
+}
+
+/* Runs the chosen loop over [begin, end). With fields, it goes span by
+ * span: the fields push the velocities of a span that is then integrated
+ * while still in L1. */
+template <std::size_t Index, bool Split>
+SFMLTEST_INLINE std::size_t integrateRange(ParticleStore &store,
+                                           std::size_t begin, std::size_t end,
+                                           const KernelParams &params,
+                                           std::uint8_t *mask,
+                                           std::uint32_t *indices) {
+  constexpr bool fields = kernelFeatures(Index).fields;
+  float *px = store.x.data();
+  float *py = store.y.data();
+  float *pvx = store.vx.data();
+  float *pvy = store.vy.data();
+  auto *pc = reinterpret_cast<std::uint32_t *>(store.color.data());
+  float *page = store.age.data();
+  const float *plife = store.lifetime.data();
+  std::uint32_t *first = indices + begin;
+  std::uint32_t *out = first;
+  const std::size_t span = fields ? FIELD_SPAN : end - begin;
+  for (std::size_t from = begin; from < end; from += span) {
+    const std::size_t to = std::min(from + span, end);
+    if constexpr (fields) {
+      applyForceFields(store, from, to, *params.fields, params.deltaTime,
+                       params.fieldTime);
+    }
+    if constexpr (Split) {
+      out = integrateSplit<Index>(px, py, pvx, pvy, pc, page, plife, mask,
+                                  out, from, to, params);
+    } else {
+      out = integrateFused<Index>(px, py, pvx, pvy, pc, page, plife, mask,
+                                  out, from, to, params);
+    }
+  }
+  return static_cast<std::size_t>(out - first);
+}
+
+template <std::size_t Index>
+std::size_t integrateScalar(ParticleStore &store, std::size_t begin,
+                            std::size_t end, const KernelParams &params,
+                            std::uint8_t *mask, std::uint32_t *indices) {
+  return integrateRange<Index, false>(store, begin, end, params, mask,
+                                      indices);
+}
+
+template <std::size_t Index>
+std::size_t integrateBaseline(ParticleStore &store, std::size_t begin,
+                              std::size_t end, const KernelParams &params,
+                              std::uint8_t *mask, std::uint32_t *indices) {
+  return integrateRange<Index, true>(store, begin, end, params, mask, indices);
+}
+
+/* Same source, but everything inlined into it is compiled for AVX2 */
+template <std::size_t Index>
+SFMLTEST_TARGET_AVX2 std::size_t integrateAvx2(ParticleStore &store,
+                                               std::size_t begin,
+                                               std::size_t end,
+                                               const KernelParams &params,
+                                               std::uint8_t *mask,
+                                               std::uint32_t *indices) {
+  return integrateRange<Index, true>(store, begin, end, params, mask, indices);
+}
+
+using KernelTable = std::array<std::array<KernelFn, KERNEL_VARIANTS>, 3>;
+
+/* Rows by KernelIsa, columns by kernelIndex */
+template <std::size_t... Index>
+constexpr KernelTable makeKernelTable(std::index_sequence<Index...>) {
+  return {{{&integrateScalar<Index>...},
+           {&integrateBaseline<Index>...},
+           {&integrateAvx2<Index>...}}};
+}
+
+constexpr KernelTable KERNELS =
+    makeKernelTable(std::make_index_sequence<KERNEL_VARIANTS>{});
+
+KernelIsa queryCpu() {
+#if defined(SFMLTEST_KERNEL_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+  int info[4]{};
+  __cpuid(info, 1);
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  if (osxsave && avx && (_xgetbv(0) & 6U) == 6U) {
+    __cpuidex(info, 7, 0);
+    if ((info[1] & (1 << 5)) != 0) {
+      return KernelIsa::AVX2;
+    }
+  }
+  return KernelIsa::SSE2;
+#else
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") != 0) {
+    return KernelIsa::AVX2;
+  }
+  return KernelIsa::SSE2;
+#endif
+#else
+  return KernelIsa::SCALAR;
+#endif
+}
+
+}  // namespace
+
+/************************************************************/
+KernelIsa detectKernelIsa() {
+  static const KernelIsa isa = queryCpu();
+  return isa;
+}
+
+/************************************************************/
+bool isKernelIsaSupported(KernelIsa isa) {
+  return static_cast<int>(isa) <= static_cast<int>(detectKernelIsa());
+}
+
+/************************************************************/
+KernelFeatures kernelFeaturesOf(const KernelParams &params) {
+  KernelFeatures features;
+  features.dissolve = params.aging != 0 && params.lifetimeColors != nullptr;
+  features.gravity = params.gravityX != 0 || params.gravityY != 0;
+  features.fields = params.fields != nullptr && !params.fields->empty();
+  features.bounds = params.bounds;
+  return features;
+}
+
+/************************************************************/
+KernelFn selectKernel(const KernelFeatures &features, KernelIsa isa) {
+  if (!isKernelIsaSupported(isa)) {
+    isa = detectKernelIsa();
+  }
+  return KERNELS[static_cast<std::size_t>(isa)][kernelIndex(features)];
+}
+
+/************************************************************/
+std::size_t integrateParticles(ParticleStore &store, std::size_t begin,
+                               std::size_t end, const KernelParams &params,
+                               std::uint8_t *mask, std::uint32_t *indices,
+                               KernelIsa isa) {
+  return selectKernel(kernelFeaturesOf(params), isa)(store, begin, end,
+                                                     params, mask, indices);
+}
+
+}  // namespace app
@@ -0,0 +1,71 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_PARTICLEKERNEL_HPP
+#define SFMLTEST_PARTICLEKERNEL_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t, uint32_t
+#include <vector>   // for vector
+
+#include "ForceField.hpp"      // for ForceField
+#include "KernelFeatures.hpp"  // for KernelFeatures, BoundsMode
+#include "ParticleStore.hpp"   // for ParticleStore
+
+namespace app {
+
+/* Per-step constants of the update kernel, hoisted out of the loop */
+struct KernelParams {
+  float gravityX{0};        /*< Gravity * deltaTime */
+  float gravityY{0};        /*< Gravity * deltaTime */
+  float thrust{0};          /*< deltaTime * particle speed */
+  float maxX{0};            /*< Canvas width */
+  float maxY{0};            /*< Canvas height */
+  float aging{0};           /*< Age added per step, 0 = no dissolve */
+  /* LifetimeTable::data() and mask(), read while dissolving */
+  const std::uint32_t *lifetimeColors{nullptr};
+  std::uint32_t lifetimeMask{0};
+  BoundsMode bounds{BoundsMode::CULL};
+  const std::vector<ForceField> *fields{nullptr}; /*< null = none */
+  float deltaTime{0};                             /*< For the fields */
+  float fieldTime{0};                             /*< Animates NOISE */
+};
+
+/* The features params actually use; what is off or neutral (no gravity,
+ * no dissolution, no fields) selects a kernel without that code */
+[[nodiscard]] KernelFeatures kernelFeaturesOf(const KernelParams &params);
+
+enum class KernelIsa { SCALAR = 0, SSE2 = 1, AVX2 = 2 };
+
+/* Update kernel specialised for one feature combination and instruction
+ * set, see integrateParticles for the contract */
+using KernelFn = std::size_t (*)(ParticleStore &store, std::size_t begin,
+                                 std::size_t end, const KernelParams &params,
+                                 std::uint8_t *mask, std::uint32_t *indices);
+
+/* Best instruction set supported by the running CPU (detected once) */
+[[nodiscard]] KernelIsa detectKernelIsa();
+[[nodiscard]] bool isKernelIsaSupported(KernelIsa isa);
+
+/* Looks the kernel up in the dispatch table; meant to be called once per
+ * step, outside the per-chunk loop. Falls back to the detected instruction
+ * set if isa is not supported. */
+[[nodiscard]] KernelFn selectKernel(const KernelFeatures &features,
+                                    KernelIsa isa);
+
+/* Integrates particles [begin, end) in place: force fields, gravity,
+ * thrust, ageing with the colour looked up by normalized age, then bounds
+ * handling and expiry (age >= lifetime). Writes
+ * mask[i] = 1 for each survivor and appends the survivors' indices in
+ * ascending order to indices[begin...]. Returns the number of survivors.
+ * All instruction sets produce bit-identical results. Selects the kernel
+ * on every call; hot loops should hold on to selectKernel's result. */
+std::size_t integrateParticles(ParticleStore &store, std::size_t begin,
+                               std::size_t end, const KernelParams &params,
+                               std::uint8_t *mask, std::uint32_t *indices,
+                               KernelIsa isa);
+
+}  // namespace app
+
+#endif  // SFMLTEST_PARTICLEKERNEL_HPP
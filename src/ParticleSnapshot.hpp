@@ -0,0 +1,82 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_PARTICLESNAPSHOT_HPP
+#define SFMLTEST_PARTICLESNAPSHOT_HPP
+
+#include <SFML/Graphics/Color.hpp>   // for Color
+#include <SFML/Graphics/Vertex.hpp>  // for Vertex
+#include <SFML/System/Time.hpp>      // for Time
+#include <SFML/System/Vector2.hpp>   // for Vector2f
+#include <cstddef>                   // for size_t
+#include <cstdint>                   // for uint16_t, uint64_t
+#include <vector>                    // for vector
+
+namespace app {
+
+/* One particle of a packed snapshot, 12 bytes against the 28 of a vertex
+ * and its previous position */
+struct PackedPoint {
+  std::uint16_t x{0};         /*< Fixed point, see CompactParticleStore */
+  std::uint16_t y{0};         /*< Fixed point */
+  std::uint16_t previousX{0}; /*< Fixed point, before the step */
+  std::uint16_t previousY{0}; /*< Fixed point, before the step */
+  sf::Color color;
+};
+
+/* Immutable copy of the particle state after one simulation step, handed
+ * from the simulation thread to the render thread. A system in compact
+ * mode fills packed instead of vertices and previous; the render thread
+ * expands it to vertices only while uploading. */
+struct ParticleSnapshot {
+  std::vector<sf::Vertex> vertices;   /*< State after the step */
+  std::vector<sf::Vector2f> previous; /*< Same particles before the step */
+  std::vector<PackedPoint> packed;    /*< Both of the above, packed */
+  sf::Vector2f packedStep;            /*< Pixels per fixed-point step */
+  std::uint64_t step{0};              /*< Simulation step number */
+  sf::Time publishedAt;               /*< Real time the step stands for */
+  sf::Time stepLength;                /*< Simulated time per step */
+
+  [[nodiscard]] std::size_t size() const {
+    return vertices.size() + packed.size();
+  }
+
+  /* The state after the step as vertices, expanded into out if packed */
+  const std::vector<sf::Vertex> &current(
+      std::vector<sf::Vertex> &out) const {
+    return packed.empty() ? vertices : interpolate(1.0F, out);
+  }
+
+  /* Blends previous -> current positions, alpha in [0, 1] */
+  const std::vector<sf::Vertex> &interpolate(
+      float alpha, std::vector<sf::Vertex> &out) const {
+    if (!packed.empty()) {
+      out.resize(packed.size());
+      for (std::size_t i = 0; i < packed.size(); ++i) {
+        const PackedPoint &point = packed[i];
+        const auto fromX = static_cast<float>(point.previousX);
+        const auto fromY = static_cast<float>(point.previousY);
+        out[i].color = point.color;
+        out[i].position.x =
+            (fromX + (static_cast<float>(point.x) - fromX) * alpha) *
+            packedStep.x;
+        out[i].position.y =
+            (fromY + (static_cast<float>(point.y) - fromY) * alpha) *
+            packedStep.y;
+      }
+      return out;
+    }
+    out.resize(vertices.size());
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+      out[i].color = vertices[i].color;
+      out[i].position = previous[i] + (vertices[i].position - previous[i]) *
+                                          alpha;
+    }
+    return out;
+  }
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_PARTICLESNAPSHOT_HPP
@@ -0,0 +1,123 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "ParticleStore.hpp"
+
+#include <algorithm>  // for copy
+#include <iterator>   // for next
+
+namespace app {
+
+void ParticleStore::reserve(std::size_t capacity) {
+  x.reserve(capacity);
+  y.reserve(capacity);
+  vx.reserve(capacity);
+  vy.reserve(capacity);
+  color.reserve(capacity);
+  age.reserve(capacity);
+  lifetime.reserve(capacity);
+}
+
+/************************************************************/
+void ParticleStore::resize(std::size_t count) {
+  x.resize(count);
+  y.resize(count);
+  vx.resize(count);
+  vy.resize(count);
+  color.resize(count);
+  age.resize(count);
+  lifetime.resize(count);
+}
+
+/************************************************************/
+void ParticleStore::clear() { resize(0); }
+
+/************************************************************/
+void ParticleStore::shrinkToFit() {
+  x.shrink_to_fit();
+  y.shrink_to_fit();
+  vx.shrink_to_fit();
+  vy.shrink_to_fit();
+  color.shrink_to_fit();
+  age.shrink_to_fit();
+  lifetime.shrink_to_fit();
+}
+
+/************************************************************/
+void ParticleStore::push(const sf::Vector2f &position,
+                         const sf::Vector2f &velocity, const sf::Color &col,
+                         float life) {
+  x.push_back(position.x);
+  y.push_back(position.y);
+  vx.push_back(velocity.x);
+  vy.push_back(velocity.y);
+  color.push_back(col);
+  age.push_back(0.0F);
+  lifetime.push_back(life);
+}
+
+/************************************************************/
+void ParticleStore::push(const Particle &particle) {
+  push(particle.getDrawVertex().position, particle.getVelocity(),
+       particle.getDrawVertex().color);
+}
+
+/************************************************************/
+void ParticleStore::move(std::size_t dst, std::size_t src) {
+  x[dst] = x[src];
+  y[dst] = y[src];
+  vx[dst] = vx[src];
+  vy[dst] = vy[src];
+  color[dst] = color[src];
+  age[dst] = age[src];
+  lifetime[dst] = lifetime[src];
+}
+
+/************************************************************/
+void ParticleStore::compact(const std::uint32_t *survivors, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    /* survivors[i] >= i, so slots are never overwritten before being read */
+    if (survivors[i] != i) {
+      move(i, survivors[i]);
+    }
+  }
+  resize(count);
+}
+
+/************************************************************/
+void ParticleStore::eraseFront(std::size_t count) {
+  const std::size_t kept = count < size() ? size() - count : 0;
+  const auto shift = [count](auto &array) {
+    std::copy(std::next(array.begin(), static_cast<std::ptrdiff_t>(count)),
+              array.end(), array.begin());
+  };
+  if (kept != 0) {
+    shift(x);
+    shift(y);
+    shift(vx);
+    shift(vy);
+    shift(color);
+    shift(age);
+    shift(lifetime);
+  }
+  resize(kept);
+}
+
+/************************************************************/
+void ParticleStore::gather(const ParticleStore &src,
+                           const std::uint32_t *indices, std::size_t count,
+                           std::size_t offset) {
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint32_t from = indices[i];
+    x[offset + i] = src.x[from];
+    y[offset + i] = src.y[from];
+    vx[offset + i] = src.vx[from];
+    vy[offset + i] = src.vy[from];
+    color[offset + i] = src.color[from];
+    age[offset + i] = src.age[from];
+    lifetime[offset + i] = src.lifetime[from];
+  }
+}
+
+}  // namespace app
@@ -0,0 +1,62 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_PARTICLESTORE_HPP
+#define SFMLTEST_PARTICLESTORE_HPP
+
+#include <SFML/Graphics/Color.hpp>  // for Color
+#include <SFML/System/Vector2.hpp>  // for Vector2f
+#include <cstddef>                  // for size_t
+#include <cstdint>                  // for uint32_t
+#include <limits>                   // for numeric_limits
+#include <vector>                   // for vector
+
+#include "Particle.hpp"  // for Particle
+
+namespace app {
+
+/* Structure-of-arrays particle storage.
+ * Every attribute lives in its own contiguous array so the update loop
+ * streams through memory linearly; index i in each array is particle i.
+ * Dead particles are removed by compacting survivors towards the front,
+ * never by erasing from the middle. */
+class ParticleStore {
+ public:
+  [[nodiscard]] std::size_t size() const { return x.size(); }
+  [[nodiscard]] bool empty() const { return x.empty(); }
+
+  void reserve(std::size_t capacity);
+  void resize(std::size_t count);
+  void clear();
+  void shrinkToFit(); /*< Releases spare capacity */
+
+  /* Pushes a newborn particle; by default it never expires */
+  void push(const sf::Vector2f &position, const sf::Vector2f &velocity,
+            const sf::Color &col,
+            float life = std::numeric_limits<float>::infinity());
+  void push(const Particle &particle);
+
+  /* Moves particle src into slot dst */
+  void move(std::size_t dst, std::size_t src);
+  /* Stable O(n) compaction: keeps only the particles listed in the
+   * ascending index list survivors[0, count), in that order */
+  void compact(const std::uint32_t *survivors, std::size_t count);
+  /* Drops the first count particles, keeping the order of the rest */
+  void eraseFront(std::size_t count);
+  /* Copies src particles indices[0, count) into slots [offset, ...) */
+  void gather(const ParticleStore &src, const std::uint32_t *indices,
+              std::size_t count, std::size_t offset);
+
+  std::vector<float> x;         /*< Position x */
+  std::vector<float> y;         /*< Position y */
+  std::vector<float> vx;        /*< Velocity x */
+  std::vector<float> vy;        /*< Velocity y */
+  std::vector<sf::Color> color; /*< Color, follows the lifetime curves */
+  std::vector<float> age;       /*< Seconds lived while dissolving */
+  std::vector<float> lifetime;  /*< Age at which the particle expires */
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_PARTICLESTORE_HPP
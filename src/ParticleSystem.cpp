@@ -8,9 +8,18 @@
 #include <SFML/Graphics/RenderTarget.hpp>   // for RenderTarget
 #include <SFML/Graphics/Vertex.hpp>         // for Vertex
 #include <SFML/System/Vector2.hpp>          // for Vector2::Vector2<T>
+#include <algorithm>                        // for lower_bound, clamp, max
+#include <array>                            // for array
 #include <cmath>                            // for cos, sin
-#include <sstream>                          // for ostringstream, basic_ostream
-#include <type_traits>                      // for move
+#include <cstddef>                          // for size_t, ptrdiff_t
+#include <initializer_list>                 // for initializer_list
+#include <iterator>                         // for next
+#include <random>                           // for random_device
+#include <string>                           // for to_string
+#include <utility>                          // for swap
+
+#include "detail/Half.hpp"      // for fromHalf
+#include "detail/Profiler.hpp"  // for APP_PROFILE_SCOPE
 
 namespace app {
 
@@ -23,7 +32,11 @@ ParticleSystem::ParticleSystem(sf::Vector2u canvasSize)
       gravity_(sf::Vector2f(0.0, 0.0)),
       startPos_(sf::Vector2f(static_cast<float>(canvasSize.x) / 2,
                              static_cast<float>(canvasSize.y) / 2)),
-      canvasSize_(canvasSize) {}
+      canvasSize_(canvasSize),
+      seed_(std::random_device{}()),
+      rng_(seed_),
+      kernelIsa_(detectKernelIsa()),
+      pool_(&ThreadPool::instance()) {}
 
 /************************************************************/
 ParticleSystem::~ParticleSystem() {
@@ -34,97 +47,907 @@ ParticleSystem::~ParticleSystem() {
 /************************************************************/
 void ParticleSystem::draw(sf::RenderTarget& target,
                           sf::RenderStates states) const {
-  for (const auto& item : particles_) {
-    target.draw(&item.getDrawVertex(), 1, sf::Points, states);
+  const auto &vertices = getVertices();
+  if (vertices.empty()) {
+    return;
+  }
+  /* One draw call for the whole system */
+  target.draw(vertices.data(), vertices.size(), sf::Points, states);
+}
+
+/************************************************************/
+const std::vector<sf::Vertex>& ParticleSystem::getVertices() const {
+  if (!verticesDirty_) {
+    return vertices_;
+  }
+  const std::size_t count = liveCount();
+  vertices_.resize(count);
+  if (compact_) {
+    const float stepX = compactStep(static_cast<float>(canvasSize_.x));
+    const float stepY = compactStep(static_cast<float>(canvasSize_.y));
+    for (std::size_t i = 0; i < count; ++i) {
+      vertices_[i].position.x = static_cast<float>(packed_.x[i]) * stepX;
+      vertices_[i].position.y = static_cast<float>(packed_.y[i]) * stepY;
+      vertices_[i].color = packed_.color[i];
+    }
+  } else {
+    for (std::size_t i = 0; i < count; ++i) {
+      vertices_[i].position.x = particles_.x[i];
+      vertices_[i].position.y = particles_.y[i];
+      vertices_[i].color = particles_.color[i];
+    }
+  }
+  verticesDirty_ = false;
+  return vertices_;
+}
+
+/************************************************************/
+void ParticleSystem::snapshot(ParticleSnapshot& out) const {
+  APP_PROFILE_SCOPE("ParticleSystem::snapshot");
+  const std::size_t count = liveCount();
+  if (compact_) {
+    snapshotPacked(out);
+    return;
   }
+  out.packed.clear();
+  out.vertices.resize(count);
+  out.previous.resize(count);
+  const auto width = static_cast<float>(canvasSize_.x);
+  const auto height = static_cast<float>(canvasSize_.y);
+  pool_->parallelFor(0, count, UPDATE_CHUNK, [&](std::size_t begin,
+                                                 std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const sf::Vector2f position{particles_.x[i], particles_.y[i]};
+      const sf::Vector2f velocity{particles_.vx[i], particles_.vy[i]};
+      out.vertices[i].position = position;
+      out.vertices[i].color = particles_.color[i];
+      /* Undo the last thrust step rather than storing a second copy. On
+       * an axis the edges wrapped or bounced, that steps off the canvas,
+       * and the particle is drawn where it is instead of sweeping across */
+      const sf::Vector2f back = position - velocity * lastThrust_;
+      out.previous[i] = {back.x >= 0.0F && back.x <= width ? back.x
+                                                           : position.x,
+                         back.y >= 0.0F && back.y <= height ? back.y
+                                                            : position.y};
+    }
+  });
+}
+
+/************************************************************/
+void ParticleSystem::snapshotPacked(ParticleSnapshot &out) const {
+  const std::size_t count = packed_.size();
+  const float stepX = compactStep(static_cast<float>(canvasSize_.x));
+  const float stepY = compactStep(static_cast<float>(canvasSize_.y));
+  /* The last thrust step in fixed-point steps per unit of velocity */
+  const float backX = stepX > 0 ? lastThrust_ / stepX : 0.0F;
+  const float backY = stepY > 0 ? lastThrust_ / stepY : 0.0F;
+  /* Off the canvas, the edges moved the particle: no step back, as in
+   * snapshot() */
+  const auto previous = [](std::uint16_t position, float shift) {
+    const float back = static_cast<float>(position) - shift;
+    return back >= 0.0F && back <= COMPACT_POSITION_STEPS
+               ? static_cast<std::uint16_t>(back + 0.5F)
+               : position;
+  };
+  out.vertices.clear();
+  out.previous.clear();
+  out.packed.resize(count);
+  out.packedStep = sf::Vector2f{stepX, stepY};
+  pool_->parallelFor(0, count, UPDATE_CHUNK, [&](std::size_t begin,
+                                                 std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      PackedPoint &point = out.packed[i];
+      point.x = packed_.x[i];
+      point.y = packed_.y[i];
+      point.previousX = previous(point.x, fromHalf(packed_.vx[i]) * backX);
+      point.previousY = previous(point.y, fromHalf(packed_.vy[i]) * backY);
+      point.color = packed_.color[i];
+    }
+  });
 }
 
 /************************************************************/
 void ParticleSystem::fuel(int numParticles) {
-  for (int i = 0; i < numParticles; ++i) {
-    /* Generate a new particle and put it at the generation point */
-    Particle particle;
-    sf::Vector2f pos{startPos_.x, startPos_.y};
-    particle.setDrawVertexPosition(pos);
+  if (numParticles > 0) {
+    emit(static_cast<std::size_t>(numParticles));
+  }
+}
+
+/************************************************************/
+void ParticleSystem::clear() {
+  particles_.clear();
+  packed_.clear();
+  sorted_ = 0;
+  verticesDirty_ = true;
+  unpackedDirty_ = true;
+}
+
+/************************************************************/
+void ParticleSystem::emit(std::size_t count) {
+  APP_PROFILE_SCOPE("ParticleSystem::emit");
+  count = makeRoom(count);
+  const std::size_t first = liveCount();
+  const std::size_t last = first + count;
+
+  /* Fill the new slots in parallel blocks; every particle draws from its own
+   * counter range, so the output does not depend on the block layout */
+  Emitter emitter;
+  emitter.position = startPos_;
+  emitter.shape = shape_;
+  const std::uint64_t sequence = emitted_;
+  fillSlots(first, last,
+            [&](ParticleStore &out, std::size_t offset, std::size_t begin,
+                std::size_t end) {
+              emitBlock(out, begin - offset, end - offset,
+                        sequence + (begin - first), emitter);
+            });
+  emitted_ += count;
+  verticesDirty_ = true;
+  unpackedDirty_ = true;
+}
+
+/************************************************************/
+void ParticleSystem::emit(const std::vector<Emitter> &emitters,
+                          const std::vector<std::size_t> &counts) {
+  APP_PROFILE_SCOPE("ParticleSystem::emitBatch");
+  const std::size_t sources = std::min(emitters.size(), counts.size());
+  std::size_t requested{0};
+  for (std::size_t i = 0; i < sources; ++i) {
+    requested += counts[i];
+  }
+  /* A full pool trims the last emitters first */
+  std::size_t remaining = makeRoom(requested);
+  const std::size_t first = liveCount();
+  emitOffsets_.resize(sources + 1);
+  emitOffsets_[0] = first;
+  for (std::size_t i = 0; i < sources; ++i) {
+    const std::size_t take = std::min(counts[i], remaining);
+    remaining -= take;
+    emitOffsets_[i + 1] = emitOffsets_[i] + take;
+  }
+  const std::size_t last = emitOffsets_[sources];
+
+  /* One parallel pass over all new slots; a block spanning several
+   * emitters is split at their boundaries */
+  const std::uint64_t sequence = emitted_;
+  fillSlots(first, last,
+            [&](ParticleStore &out, std::size_t offset, std::size_t begin,
+                std::size_t end) {
+              const auto next = std::upper_bound(emitOffsets_.begin() + 1,
+                                                 emitOffsets_.end(), begin);
+              auto source =
+                  static_cast<std::size_t>(next - emitOffsets_.begin()) - 1;
+              while (begin < end) {
+                const std::size_t stop =
+                    std::min(end, emitOffsets_[source + 1]);
+                emitBlock(out, begin - offset, stop - offset,
+                          sequence + (begin - first), emitters[source]);
+                begin = stop;
+                ++source;
+              }
+            });
+  emitted_ += last - first;
+  verticesDirty_ = true;
+  unpackedDirty_ = true;
+}
+
+/************************************************************/
+template <typename Fill>
+void ParticleSystem::fillSlots(std::size_t first, std::size_t last,
+                               const Fill &fill) {
+  if (!compact_) {
+    particles_.resize(last);
+    pool_->parallelFor(first, last, EMIT_BLOCK,
+                       [&](std::size_t begin, std::size_t end) {
+                         fill(particles_, 0, begin, end);
+                       });
+    return;
+  }
+  /* Full precision only in slices of staging, packed block by block */
+  const auto width = static_cast<float>(canvasSize_.x);
+  const auto height = static_cast<float>(canvasSize_.y);
+  packed_.resize(last);
+  for (std::size_t slice = first; slice < last; slice += PACK_STAGING) {
+    const std::size_t stop = std::min(last, slice + PACK_STAGING);
+    back_.resize(stop - slice);
+    pool_->parallelFor(slice, stop, EMIT_BLOCK,
+                       [&](std::size_t begin, std::size_t end) {
+                         fill(back_, slice, begin, end);
+                         packed_.encode(back_, begin - slice, end - begin,
+                                        begin, width, height);
+                       });
+  }
+}
+
+/************************************************************/
+std::size_t ParticleSystem::makeRoom(std::size_t count) {
+  const std::size_t limit = liveLimit();
+  if (limit == 0) {
+    poolStats_.allocated += count;
+    return count;
+  }
+  if (count > limit) {
+    poolStats_.dropped += count - limit;
+    count = limit;
+  }
+  const std::size_t free = limit > liveCount() ? limit - liveCount() : 0;
+  if (count <= free) {
+    poolStats_.allocated += count;
+    return count;
+  }
+  const std::size_t evict = count - free;
+  poolStats_.allocated += free;
+  switch (overflowPolicy_) {
+    case OverflowPolicy::DROP_NEW: {
+      poolStats_.dropped += evict;
+      return free;
+    }
+    case OverflowPolicy::RECYCLE_OLDEST: {
+      evictOldest(evict);
+      break;
+    }
+    case OverflowPolicy::RECYCLE_MOST_TRANSPARENT: {
+      evictMostTransparent(evict);
+      break;
+    }
+  }
+  poolStats_.recycled += evict;
+  return count;
+}
+
+/************************************************************/
+std::size_t ParticleSystem::liveLimit() const {
+  if (budget_ == 0 || (capacity_ != 0 && capacity_ < budget_)) {
+    return capacity_;
+  }
+  return budget_;
+}
+
+/************************************************************/
+void ParticleSystem::evictMostTransparent(std::size_t count) {
+  /* Alpha histogram gives the cut-off: everything below it goes, plus the
+   * oldest particles sitting exactly on it */
+  const std::vector<sf::Color> &colors =
+      compact_ ? packed_.color : particles_.color;
+  std::array<std::size_t, 256> histogram{};
+  for (const auto &color : colors) {
+    ++histogram[color.a];
+  }
+  std::size_t below{0};
+  std::size_t cutoff{0};
+  while (below + histogram[cutoff] < count) {
+    below += histogram[cutoff];
+    ++cutoff;
+  }
+  std::size_t onCutoff = count - below;
+
+  const std::size_t size = colors.size();
+  survivors_.resize(size);
+  std::size_t kept{0};
+  for (std::size_t i = 0; i < size; ++i) {
+    const std::size_t alpha = colors[i].a;
+    if (alpha < cutoff || (alpha == cutoff && onCutoff > 0)) {
+      onCutoff -= alpha == cutoff ? 1 : 0;
+      continue;
+    }
+    survivors_[kept++] = static_cast<std::uint32_t>(i);
+  }
+  withStore([&](auto &store) { store.compact(survivors_.data(), kept); });
+  sorted_ = static_cast<std::size_t>(
+      std::lower_bound(survivors_.data(), survivors_.data() + kept, sorted_) -
+      survivors_.data());
+}
+
+/************************************************************/
+void ParticleSystem::evictOldest(std::size_t count) {
+  /* Compaction keeps emission order, so the oldest are in front, unless a
+   * sort shuffled them */
+  const std::size_t thinned = std::min(count, sorted_);
+  if (thinned == 0) {
+    withStore([count](auto &store) { store.eraseFront(count); });
+    return;
+  }
+  /* Drop thinned of the sorted particles spread evenly over them, then
+   * the rest from the front of the ones emitted since */
+  const std::size_t size = liveCount();
+  survivors_.resize(size);
+  std::size_t kept{0};
+  for (std::size_t i = 0; i < sorted_; ++i) {
+    if ((i + 1) * thinned / sorted_ == i * thinned / sorted_) {
+      survivors_[kept++] = static_cast<std::uint32_t>(i);
+    }
+  }
+  const std::size_t sortedKept = kept;
+  for (std::size_t i = sorted_ + count - thinned; i < size; ++i) {
+    survivors_[kept++] = static_cast<std::uint32_t>(i);
+  }
+  withStore([&](auto &store) { store.compact(survivors_.data(), kept); });
+  sorted_ = sortedKept;
+}
+
+/************************************************************/
+void ParticleSystem::setCapacity(std::size_t capacity) {
+  capacity_ = capacity;
+  if (capacity == 0) {
+    return;
+  }
+  if (liveCount() > capacity) {
+    evictOldest(liveCount() - capacity);
+    verticesDirty_ = true;
+    unpackedDirty_ = true;
+  }
+  /* Release any spare room from before, then size every per-particle
+   * buffer of emit() and update() for the limit */
+  reserveStores();
+  aliveMask_.shrink_to_fit();
+  aliveMask_.reserve(capacity);
+  survivors_.shrink_to_fit();
+  survivors_.reserve(capacity);
+  chunkOffsets_.reserve(capacity / UPDATE_CHUNK + 2);
+  grid_.reserve(capacity);
+  sorter_.reserve(capacity);
+  pairDvx_.reserve(capacity);
+  pairDvy_.reserve(capacity);
+  decomposition_.reserve(capacity);
+}
+
+/************************************************************/
+void ParticleSystem::reserveStores() {
+  for (ParticleStore *store : {&particles_, &back_}) {
+    store->shrinkToFit();
+  }
+  for (CompactParticleStore *store : {&packed_, &packedBack_}) {
+    store->shrinkToFit();
+  }
+  unpacked_.shrinkToFit();
+  if (capacity_ == 0) {
+    return;
+  }
+  if (compact_) {
+    /* back_ only stages emission */
+    packed_.reserve(capacity_);
+    packedBack_.reserve(capacity_);
+    back_.reserve(std::min(capacity_, PACK_STAGING));
+  } else {
+    particles_.reserve(capacity_);
+    back_.reserve(capacity_);
+  }
+}
+
+/************************************************************/
+void ParticleSystem::setCompact(bool compact) {
+  if (compact == compact_) {
+    return;
+  }
+  if (compact) {
+    compact_ = true;
+    pack(particles_);
+    particles_.clear();
+  } else {
+    unpack(particles_);
+    packed_.clear();
+    compact_ = false;
+  }
+  reserveStores();
+  if (decomposition_.active()) {
+    /* Quantizing may move particles across a strip edge */
+    sorted_ = 0;
+  }
+  verticesDirty_ = true;
+  unpackedDirty_ = true;
+}
+
+/************************************************************/
+void ParticleSystem::pack(const ParticleStore &from) {
+  const std::size_t count = from.size();
+  const auto width = static_cast<float>(canvasSize_.x);
+  const auto height = static_cast<float>(canvasSize_.y);
+  packed_.resize(count);
+  pool_->parallelFor(0, count, UPDATE_CHUNK,
+                     [&](std::size_t begin, std::size_t end) {
+                       packed_.encode(from, begin, end - begin, begin, width,
+                                      height);
+                     });
+}
+
+/************************************************************/
+void ParticleSystem::unpack(ParticleStore &to) const {
+  const std::size_t count = packed_.size();
+  const auto width = static_cast<float>(canvasSize_.x);
+  const auto height = static_cast<float>(canvasSize_.y);
+  to.resize(count);
+  pool_->parallelFor(0, count, UPDATE_CHUNK,
+                     [&](std::size_t begin, std::size_t end) {
+                       packed_.decode(begin, end - begin, to, begin, width,
+                                      height);
+                     });
+}
+
+/************************************************************/
+const ParticleStore &ParticleSystem::getParticles() const {
+  if (!compact_) {
+    return particles_;
+  }
+  if (unpackedDirty_) {
+    unpack(unpacked_);
+    unpackedDirty_ = false;
+  }
+  return unpacked_;
+}
+
+/************************************************************/
+void ParticleSystem::setCanvasSize(const sf::Vector2u &newSize) {
+  if (decomposition_.active() && newSize.y != canvasSize_.y) {
+    decomposition_.setStrips(decomposition_.getStrips(),
+                             static_cast<float>(newSize.y));
+    sorted_ = 0;
+  }
+  if (!compact_ || newSize == canvasSize_) {
+    canvasSize_ = newSize;
+    return;
+  }
+  /* Fixed point is relative to the canvas */
+  unpack(back_);
+  canvasSize_ = newSize;
+  pack(back_);
+  back_.clear();
+  verticesDirty_ = true;
+  unpackedDirty_ = true;
+}
+
+/************************************************************/
+void ParticleSystem::setBudget(std::size_t budget) {
+  budget_ = budget;
+  const std::size_t limit = liveLimit();
+  if (limit == 0 || liveCount() <= limit) {
+    return;
+  }
+  const std::size_t cull = liveCount() - limit;
+  if (overflowPolicy_ == OverflowPolicy::RECYCLE_MOST_TRANSPARENT) {
+    evictMostTransparent(cull);
+  } else {
+    evictOldest(cull);
+  }
+  poolStats_.culled += cull;
+  verticesDirty_ = true;
+  unpackedDirty_ = true;
+}
+
+/************************************************************/
+void ParticleSystem::emitBlock(ParticleStore &out, std::size_t begin,
+                               std::size_t end, std::uint64_t sequence,
+                               const Emitter &emitter) {
+  constexpr float twoPi = 2.0F * 3.14159265F;
+  /* Random byte b maps to min + b * (max - min + 1) / 256 per channel */
+  const auto channel = [](std::uint32_t bits, sf::Uint8 low, sf::Uint8 high) {
+    const std::uint32_t span = high >= low ? high - low + 1U : 1U;
+    return static_cast<sf::Uint8>(low + (((bits & 0xFFU) * span) >> 8U));
+  };
+  for (std::size_t i = begin; i < end; ++i) {
+    const std::uint64_t counter = (sequence + (i - begin)) * RNG_DRAWS;
 
-    /* Randomizer initialization */
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    /* Put the particle at the generation point */
+    out.x[i] = emitter.position.x;
+    out.y[i] = emitter.position.y;
 
-    switch (shape_) {
+    switch (emitter.shape) {
       case Shape::CIRCLE: {
-        /* Generate a random angle */
-        UniRealDist randomAngle(0.0, (2.0 * 3.14159265));
-        auto angle = randomAngle(gen);
-
-        /* Use the random angle as a thrust vector for the particle */
-        UniRealDist randomAngleCos(0.0, cos(angle));
-        UniRealDist randomAngleSin(0.0, sin(angle));
-        sf::Vector2f vel{static_cast<float>(randomAngleCos(gen)),
-                         static_cast<float>(randomAngleSin(gen))};
-        particle.setVelocity(vel);
+        /* Use a random angle as a thrust vector for the particle */
+        const float angle = rng_.uniform(counter, 0.0F, twoPi);
+        out.vx[i] = rng_.uniform(counter + 1) * std::cos(angle);
+        out.vy[i] = rng_.uniform(counter + 2) * std::sin(angle);
         break;
       }
       case Shape::SQUARE: {
         /* Square generation */
-        UniRealDist randomSide(-1.0, 1.0);
-        sf::Vector2f vel{static_cast<float>(randomSide(gen)),
-                         static_cast<float>(randomSide(gen))};
-        particle.setVelocity(vel);
-
+        out.vx[i] = rng_.uniform(counter + 1, -1.0F, 1.0F);
+        out.vy[i] = rng_.uniform(counter + 2, -1.0F, 1.0F);
         break;
       }
     }
+    out.vx[i] *= emitter.speed;
+    out.vy[i] *= emitter.speed;
 
     /* Randomly change the colors of the particles */
-    UniIntDist randomColor(0, 255);
-    sf::Color color{static_cast<sf::Uint8>(randomColor(gen)),
-                    static_cast<sf::Uint8>(randomColor(gen)),
-                    static_cast<sf::Uint8>(randomColor(gen)), 255};
-    particle.setDrawVertexColor(color);
+    const std::uint32_t bits = rng_(counter + 3);
+    out.color[i] =
+        sf::Color{channel(bits, emitter.colorMin.r, emitter.colorMax.r),
+                  channel(bits >> 8U, emitter.colorMin.g, emitter.colorMax.g),
+                  channel(bits >> 16U, emitter.colorMin.b, emitter.colorMax.b),
+                  channel(bits >> 24U, emitter.colorMin.a, emitter.colorMax.a)};
+    out.age[i] = 0.0F;
+    out.lifetime[i] =
+        rng_.uniform(counter + 4, lifetimeMin_, lifetimeMax_);
+  }
+}
+
+/************************************************************/
+void ParticleSystem::setLifetime(float min, float max) {
+  lifetimeMin_ = std::max(min, MIN_LIFETIME);
+  lifetimeMax_ = std::max(max, lifetimeMin_);
+}
+
+/************************************************************/
+void ParticleSystem::setLifetimeCurves(const LifetimeCurves &curves) {
+  curves_ = curves;
+  lifetimeTable_.bake(curves_);
+}
+
+/************************************************************/
+void ParticleSystem::setSeed(std::uint64_t seed, std::uint64_t emitted) {
+  seed_ = seed;
+  rng_ = CounterRng{seed};
+  emitted_ = emitted;
+}
+
+/************************************************************/
+void ParticleSystem::setParticles(const ParticleStore &particles,
+                                  std::size_t sorted) {
+  if (compact_) {
+    pack(particles);
+  } else {
+    /* Copy assignment keeps the reserved buffers when they are big
+     * enough */
+    particles_ = particles;
+  }
+  sorted_ = std::min(sorted, liveCount());
+  verticesDirty_ = true;
+  unpackedDirty_ = true;
+}
+
+/************************************************************/
+void ParticleSystem::setShards(std::size_t shards) {
+  if ((shards < 2 ? 0 : shards) == decomposition_.getStrips()) {
+    return;
+  }
+  decomposition_.setStrips(shards, static_cast<float>(canvasSize_.y));
+  shardChunks_.reserve(decomposition_.getStrips() + 2);
+  if (capacity_ != 0) {
+    decomposition_.reserve(capacity_);
+  }
+  /* Nothing is grouped by the new strips yet */
+  sorted_ = 0;
+}
+
+/************************************************************/
+float ParticleSystem::positionY(std::size_t index) const {
+  if (!compact_) {
+    return particles_.y[index];
+  }
+  const auto height = static_cast<float>(canvasSize_.y);
+  return std::min(
+      static_cast<float>(packed_.y[index]) * compactStep(height), height);
+}
+
+/************************************************************/
+void ParticleSystem::setSpatialSort(std::uint32_t interval, float threshold) {
+  sortInterval_ = interval;
+  sortThreshold_ = std::max(threshold, 0.0F);
+}
+
+/************************************************************/
+float ParticleSystem::getDisorder() const {
+  if (compact_) {
+    return MortonSorter::disorder(packed_);
+  }
+  return MortonSorter::disorder(particles_,
+                                static_cast<float>(canvasSize_.x),
+                                static_cast<float>(canvasSize_.y));
+}
 
-    particles_.push_back(std::move(particle));
+/************************************************************/
+bool ParticleSystem::sortDue() const {
+  /* Shards keep their own order */
+  if (decomposition_.active() || liveCount() < 2) {
+    return false;
   }
+  return (sortInterval_ != 0 && stepsSinceSort_ >= sortInterval_) ||
+         (sortThreshold_ > 0 && getDisorder() > sortThreshold_);
+}
+
+/************************************************************/
+void ParticleSystem::sortSpatially() {
+  APP_PROFILE_SCOPE("ParticleSystem::sortSpatially");
+  if (decomposition_.active()) {
+    return;
+  }
+  const std::size_t count = liveCount();
+  if (compact_) {
+    sorter_.sort(packed_, *pool_);
+  } else {
+    sorter_.sort(particles_, static_cast<float>(canvasSize_.x),
+                 static_cast<float>(canvasSize_.y), *pool_);
+  }
+  const std::uint32_t *order = sorter_.order().data();
+  const auto reorder = [&](auto &from, auto &to) {
+    to.resize(count);
+    pool_->parallelFor(0, count, UPDATE_CHUNK,
+                       [&](std::size_t begin, std::size_t end) {
+                         to.gather(from, order + begin, end - begin, begin);
+                       });
+    std::swap(from, to);
+  };
+  if (compact_) {
+    reorder(packed_, packedBack_);
+  } else {
+    reorder(particles_, back_);
+  }
+  sorted_ = count;
+  stepsSinceSort_ = 0;
+  verticesDirty_ = true;
+  unpackedDirty_ = true;
 }
 
 /************************************************************/
 std::string ParticleSystem::getNumberOfParticlesString() const {
-  std::ostringstream oss;
-  oss << particles_.size();
-  return oss.str();
+  return std::to_string(liveCount());
+}
+
+/************************************************************/
+std::size_t ParticleSystem::addForceField(const ForceField &field) {
+  forceFields_.push_back(field);
+  return forceFields_.size() - 1;
+}
+
+/************************************************************/
+void ParticleSystem::removeForceField(std::size_t index) {
+  forceFields_.erase(
+      std::next(forceFields_.begin(), static_cast<std::ptrdiff_t>(index)));
+}
+
+/************************************************************/
+void ParticleSystem::applyPairForces(float deltaTime) {
+  APP_PROFILE_SCOPE("ParticleSystem::applyPairForces");
+  float cellSize = interactionCellSize_;
+  if (cellSize <= 0) {
+    for (const auto &force : pairForces_) {
+      cellSize = std::max(cellSize, force.radius);
+    }
+  }
+  if (decomposition_.active()) {
+    decomposition_.applyPairForces(particles_, pairForces_, cellSize,
+                                   static_cast<float>(canvasSize_.x),
+                                   deltaTime, maxNeighbours_, *pool_);
+    return;
+  }
+  grid_.setCellSize(cellSize);
+  grid_.setBounds(static_cast<float>(canvasSize_.x),
+                  static_cast<float>(canvasSize_.y));
+  grid_.build(particles_, *pool_);
+
+  /* Forces see the velocities from before this step, the result is
+   * scattered back afterwards */
+  const std::size_t count = particles_.size();
+  pairDvx_.assign(count, 0.0F);
+  pairDvy_.assign(count, 0.0F);
+  accumulatePairForces(grid_, *pool_, pairForces_, deltaTime, maxNeighbours_,
+                       pairDvx_.data(), pairDvy_.data());
+  const std::uint32_t *order = grid_.order().data();
+  pool_->parallelFor(0, count, UPDATE_CHUNK,
+                     [&](std::size_t begin, std::size_t end) {
+                       for (std::size_t slot = begin; slot < end; ++slot) {
+                         particles_.vx[order[slot]] += pairDvx_[slot];
+                         particles_.vy[order[slot]] += pairDvy_[slot];
+                       }
+                     });
 }
 
 /************************************************************/
 void ParticleSystem::update(float deltaTime) {
-  /* Run through each particle and apply our system to it */
-  for (auto it = particles_.begin(); it != particles_.end(); ++it) {
-    /* Apply Gravity */
-    sf::Vector2f vel{gravity_.x * deltaTime, gravity_.y * deltaTime};
-    (*it).updateVelocity(vel);
-
-    /* Apply thrust */
-    sf::Vector2f vertexPosition{(*it).getDrawVertex().position.x,
-                                (*it).getDrawVertex().position.y};
-    vertexPosition.x += (*it).getVelocity().x * deltaTime * particle_speed_;
-    vertexPosition.y += (*it).getVelocity().y * deltaTime * particle_speed_;
-    (*it).setDrawVertexPosition(vertexPosition);
-
-    /* If they are set to disolve, disolve */
-    if (dissolve_) {
-      (*it).updateDrawVertexColorAlpha(dissolutionRate_);
-    }
-
-    if ((*it).getDrawVertex().position.x > static_cast<float>(canvasSize_.x) ||
-        (*it).getDrawVertex().position.x < 0 ||
-        (*it).getDrawVertex().position.y > static_cast<float>(canvasSize_.y) ||
-        (*it).getDrawVertex().position.y < 0 ||
-        (*it).getDrawVertex().color.a < 10) {
-      it = particles_.erase(it);
-      if (it == particles_.end()) {
-        return;
+  APP_PROFILE_SCOPE("ParticleSystem::update");
+  KernelParams params;
+  params.gravityX = gravity_.x * deltaTime;
+  params.gravityY = gravity_.y * deltaTime;
+  params.thrust = deltaTime * particle_speed_;
+  lastThrust_ = params.thrust;
+  params.maxX = static_cast<float>(canvasSize_.x);
+  params.maxY = static_cast<float>(canvasSize_.y);
+  params.aging = dissolve_ ? deltaTime * AGING_PER_RATE *
+                                 static_cast<float>(dissolutionRate_)
+                           : 0.0F;
+  params.lifetimeColors = lifetimeTable_.data();
+  params.lifetimeMask = lifetimeTable_.mask();
+  params.bounds = boundsMode_;
+  params.fields = &forceFields_;
+  params.deltaTime = deltaTime;
+  params.fieldTime = fieldTime_;
+  const KernelFn kernel = selectKernel(kernelFeaturesOf(params), kernelIsa_);
+  if (sortDue()) {
+    sortSpatially();
+  }
+  ++stepsSinceSort_;
+  if (decomposition_.active()) {
+    decomposition_.locate(sorted_, liveCount(), [this](std::size_t i) {
+      return positionY(i);
+    });
+  }
+  if (!pairForces_.empty()) {
+    if (compact_) {
+      /* The grid needs full-precision positions; only the velocities
+       * change */
+      unpack(particles_);
+      applyPairForces(deltaTime);
+      pack(particles_);
+      particles_.clear();
+    } else {
+      applyPairForces(deltaTime);
+    }
+  }
+  if (decomposition_.active()) {
+    updateSharded(kernel, params);
+  } else {
+    updateChunks(kernel, params);
+  }
+  fieldTime_ += deltaTime;
+  verticesDirty_ = true;
+  unpackedDirty_ = true;
+}
+
+/************************************************************/
+void ParticleSystem::updateChunks(KernelFn kernel,
+                                  const KernelParams &params) {
+  /* Integrate and cull chunks in parallel; each chunk lists its survivors
+   * in its own slice of survivors_. The kernel was picked for this
+   * step's features, so the chunks run without per-particle feature
+   * tests. */
+  const std::size_t count = liveCount();
+  const std::size_t chunks = (count + UPDATE_CHUNK - 1) / UPDATE_CHUNK;
+  aliveMask_.resize(count);
+  survivors_.resize(count);
+  chunkOffsets_.resize(chunks + 1);
+  pool_->parallelFor(0, chunks, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t chunk = first; chunk < last; ++chunk) {
+      const std::size_t begin = chunk * UPDATE_CHUNK;
+      const std::size_t end = std::min(begin + UPDATE_CHUNK, count);
+      chunkOffsets_[chunk + 1] =
+          compact_ ? updatePacked(kernel, begin, end, params)
+                   : kernel(particles_, begin, end, params, aliveMask_.data(),
+                            survivors_.data());
+    }
+  });
+
+  /* Prefix sum turns survivor counts into output offsets */
+  chunkOffsets_[0] = 0;
+  for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+    chunkOffsets_[chunk + 1] += chunkOffsets_[chunk];
+  }
+  const std::size_t alive = chunks == 0 ? 0 : chunkOffsets_[chunks];
+
+  if (alive != count && sorted_ > 0) {
+    /* Survivors keep their order, so the sorted ones stay in front */
+    const std::size_t chunk = sorted_ / UPDATE_CHUNK;
+    std::size_t below = chunkOffsets_[std::min(chunk, chunks)];
+    if (chunk < chunks) {
+      const std::uint32_t *first = survivors_.data() + chunk * UPDATE_CHUNK;
+      const std::uint32_t *last =
+          first + (chunkOffsets_[chunk + 1] - chunkOffsets_[chunk]);
+      below += static_cast<std::size_t>(
+          std::lower_bound(first, last, sorted_) - first);
+    }
+    sorted_ = below;
+  }
+  const auto keepSurvivors = [&](auto &store, auto &back) {
+    if (chunks == 1) {
+      store.compact(survivors_.data(), alive);
+      return;
+    }
+    /* Chunks cannot compact in place concurrently, so gather the
+     * survivors into the back store and swap */
+    back.resize(alive);
+    pool_->parallelFor(0, chunks, 1, [&](std::size_t first, std::size_t last) {
+      for (std::size_t chunk = first; chunk < last; ++chunk) {
+        back.gather(store, survivors_.data() + chunk * UPDATE_CHUNK,
+                    chunkOffsets_[chunk + 1] - chunkOffsets_[chunk],
+                    chunkOffsets_[chunk]);
       }
+    });
+    std::swap(store, back);
+  };
+  if (alive != count) {
+    if (compact_) {
+      keepSurvivors(packed_, packedBack_);
+    } else {
+      keepSurvivors(particles_, back_);
     }
   }
 }
 
-}  // namespace app
\ No newline at end of file
+/************************************************************/
+void ParticleSystem::updateSharded(KernelFn kernel,
+                                   const KernelParams &params) {
+  /* Chunks never straddle two shards, so each shard finds its survivors
+   * in chunks of its own; the chunks of all shards share the pool, which
+   * keeps it busy however unevenly the particles spread */
+  const std::size_t count = liveCount();
+  const std::size_t shards = decomposition_.getStrips() + 1;
+  shardChunks_.resize(shards + 1);
+  shardChunks_[0] = 0;
+  for (std::size_t shard = 0; shard < shards; ++shard) {
+    const std::size_t size =
+        decomposition_.end(shard) - decomposition_.begin(shard);
+    shardChunks_[shard + 1] =
+        shardChunks_[shard] + (size + UPDATE_CHUNK - 1) / UPDATE_CHUNK;
+  }
+  const std::size_t chunks = shardChunks_[shards];
+  aliveMask_.resize(count);
+  survivors_.resize(count);
+  chunkOffsets_.resize(chunks);
+  const auto chunkBegin = [&](std::size_t shard, std::size_t chunk) {
+    return decomposition_.begin(shard) +
+           (chunk - shardChunks_[shard]) * UPDATE_CHUNK;
+  };
+  pool_->parallelFor(0, chunks, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t chunk = first; chunk < last; ++chunk) {
+      const auto shard = static_cast<std::size_t>(
+          std::upper_bound(shardChunks_.begin(), shardChunks_.end(), chunk) -
+          shardChunks_.begin() - 1);
+      const std::size_t begin = chunkBegin(shard, chunk);
+      const std::size_t end =
+          std::min(begin + UPDATE_CHUNK, decomposition_.end(shard));
+      chunkOffsets_[chunk] =
+          compact_ ? updatePacked(kernel, begin, end, params)
+                   : kernel(particles_, begin, end, params, aliveMask_.data(),
+                            survivors_.data());
+    }
+  });
+
+  /* Each shard posts its survivors towards the strip they are in now */
+  decomposition_.clearOutboxes();
+  pool_->parallelFor(0, shards, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t shard = first; shard < last; ++shard) {
+      decomposition_.post(shard, [&](const auto &post) {
+        for (std::size_t chunk = shardChunks_[shard];
+             chunk < shardChunks_[shard + 1]; ++chunk) {
+          const std::uint32_t *survivors =
+              survivors_.data() + chunkBegin(shard, chunk);
+          for (std::size_t k = 0; k < chunkOffsets_[chunk]; ++k) {
+            post(survivors[k], positionY(survivors[k]));
+          }
+        }
+      });
+    }
+  });
+  std::size_t alive{0};
+  for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+    alive += chunkOffsets_[chunk];
+  }
+
+  const auto regroup = [&](auto &store, auto &back) {
+    back.resize(alive);
+    decomposition_.migrate(*pool_, [&](const std::uint32_t *indices,
+                                       std::size_t size, std::size_t offset) {
+      back.gather(store, indices, size, offset);
+    });
+    std::swap(store, back);
+  };
+  if (!decomposition_.settled()) {
+    if (compact_) {
+      regroup(packed_, packedBack_);
+    } else {
+      regroup(particles_, back_);
+    }
+  }
+  sorted_ = alive;
+}
+
+/************************************************************/
+std::size_t ParticleSystem::updatePacked(KernelFn kernel, std::size_t begin,
+                                         std::size_t end,
+                                         const KernelParams &params) {
+  /* Grows to one chunk per worker once, then stays in cache */
+  thread_local ParticleStore scratch;
+  const std::size_t count = end - begin;
+  scratch.resize(count);
+  packed_.decode(begin, count, scratch, 0, params.maxX, params.maxY);
+  std::uint32_t *survivors = survivors_.data() + begin;
+  const std::size_t alive = kernel(scratch, 0, count, params,
+                                   aliveMask_.data() + begin, survivors);
+  /* The kernel counted from the start of scratch */
+  for (std::size_t i = 0; i < alive; ++i) {
+    survivors[i] += static_cast<std::uint32_t>(begin);
+  }
+  packed_.encode(scratch, 0, count, begin, params.maxX, params.maxY);
+  return alive;
+}
+
+}  // namespace app
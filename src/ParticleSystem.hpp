@@ -9,23 +9,49 @@
 #include <SFML/Graphics/Color.hpp>         // for Color
 #include <SFML/Graphics/Drawable.hpp>      // for Drawable
 #include <SFML/Graphics/RenderStates.hpp>  // for RenderStates
+#include <SFML/Graphics/Vertex.hpp>        // for Vertex
 #include <SFML/System/Vector2.hpp>         // for Vector2f, Vector2u
-#include <algorithm>                       // for uniform_int_distribution
+#include <cstddef>                         // for size_t
+#include <cstdint>                         // for uint64_t, uint32_t
 #include <iosfwd>                          // for string
 #include <memory>
-#include <random>  // for uniform_real_distribution
 #include <vector>  // for vector
 
-#include "Particle.hpp"  // for Particle
+#include "CompactParticleStore.hpp"  // for CompactParticleStore
+#include "DomainDecomposition.hpp"   // for DomainDecomposition
+#include "Emitter.hpp"               // for Emitter, Shape
+#include "ForceField.hpp"            // for ForceField
+#include "KernelFeatures.hpp"        // for BoundsMode
+#include "Lifetime.hpp"              // for LifetimeCurves, LifetimeTable
+#include "MortonSorter.hpp"          // for MortonSorter
+#include "PairForce.hpp"             // for PairForce
+#include "Particle.hpp"              // for Particle
+#include "ParticleKernel.hpp"        // for KernelIsa, KernelFn
+#include "ParticleSnapshot.hpp"      // for ParticleSnapshot
+#include "ParticleStore.hpp"         // for ParticleStore
+#include "SpatialGrid.hpp"           // for SpatialGrid
+#include "detail/Random.hpp"         // for CounterRng
+#include "detail/ThreadPool.hpp"     // for ThreadPool
 namespace sf {
 class RenderTarget;
 }
 
 namespace app {
 
-enum class Shape { CIRCLE = 0, SQUARE = 1 };
-using UniRealDist = std::uniform_real_distribution<>;
-using UniIntDist = std::uniform_int_distribution<>;
+/* What emit() does once the pool is full */
+enum class OverflowPolicy {
+  DROP_NEW = 0,                /*< Discard the new particles */
+  RECYCLE_OLDEST = 1,          /*< Evict the longest-lived particles */
+  RECYCLE_MOST_TRANSPARENT = 2 /*< Evict the faintest particles */
+};
+
+/* Pool counters; every requested particle ends up in exactly one */
+struct PoolStats {
+  std::uint64_t allocated{0}; /*< Placed into a free slot */
+  std::uint64_t recycled{0};  /*< Placed by evicting a live particle */
+  std::uint64_t dropped{0};   /*< Discarded by DROP_NEW or oversized emits */
+  std::uint64_t culled{0};    /*< Live particles evicted by a lower budget */
+};
 
 class ParticleSystem : public sf::Drawable {
  public:
@@ -41,17 +67,38 @@ class ParticleSystem : public sf::Drawable {
 
   void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
   void fuel(int numParticles);  /*< Adds new particles */
+  void emit(std::size_t count); /*< Adds new particles in bulk */
+  /* Adds counts[i] particles from emitters[i], all in one batch */
+  void emit(const std::vector<Emitter> &emitters,
+            const std::vector<std::size_t> &counts);
   void update(float deltaTime); /*< Updates particles */
+  void clear();                 /*< Removes all particles */
   [[nodiscard]] int getDissolutionRate() const { return dissolutionRate_; }
   [[nodiscard]] int getNumberOfParticles() const {
-    return static_cast<int>(particles_.size());
+    return static_cast<int>(liveCount());
   }
   [[nodiscard]] float getParticleSpeed() const { return particle_speed_; }
+  [[nodiscard]] bool getDissolve() const { return dissolve_; }
+  [[nodiscard]] Shape getShape() const { return shape_; }
+  [[nodiscard]] const sf::Vector2f &getGravity() const { return gravity_; }
+  [[nodiscard]] const sf::Vector2f &getPosition() const { return startPos_; }
+  [[nodiscard]] const sf::Vector2u &getCanvasSize() const {
+    return canvasSize_;
+  }
   [[nodiscard]] std::string getNumberOfParticlesString() const;
+  /* Render vertices, rebuilt at most once after each update/fuel */
+  [[nodiscard]] const std::vector<sf::Vertex> &getVertices() const;
+  /* Copies the state after the last update, plus where each particle was
+   * before it, for hand-off to another thread */
+  void snapshot(ParticleSnapshot &out) const;
 
-  void setCanvasSize(const sf::Vector2u &newSize) { canvasSize_ = newSize; }
+  /* Compact mode re-quantizes the particles to the new canvas */
+  void setCanvasSize(const sf::Vector2u &newSize);
+  /* How fast particles age while dissolving: the default 4 is real time,
+   * 8 twice as fast, 0 stops them ageing */
   void setDissolutionRate(sf::Uint8 rate) { dissolutionRate_ = rate; }
   void setDissolve() { dissolve_ = !dissolve_; }
+  void setDissolve(bool enabled) { dissolve_ = enabled; }
   void setDistribution() {
     shape_ = static_cast<Shape>((static_cast<int>(shape_) + 1) % 2);
   }
@@ -61,25 +108,254 @@ class ParticleSystem : public sf::Drawable {
   }
   void setGravity(const sf::Vector2f &gravity) { gravity_ = gravity; }
   void setParticleSpeed(float speed) { particle_speed_ = speed; }
+  /* Instruction set of the update kernel; falls back if unsupported */
+  void setKernelIsa(KernelIsa isa) { kernelIsa_ = isa; }
+  /* What happens at the canvas edges, culling by default */
+  void setBoundsMode(BoundsMode mode) { boundsMode_ = mode; }
+  [[nodiscard]] BoundsMode getBoundsMode() const { return boundsMode_; }
+  /* Each new particle expires after a random lifetime in [min, max]
+   * seconds; both are kept above zero */
+  void setLifetime(float min, float max);
+  [[nodiscard]] float getLifetimeMin() const { return lifetimeMin_; }
+  [[nodiscard]] float getLifetimeMax() const { return lifetimeMax_; }
+  /* Colour and alpha over normalized age, baked into a table right here
+   * rather than evaluated per particle */
+  void setLifetimeCurves(const LifetimeCurves &curves);
+  [[nodiscard]] const LifetimeCurves &getLifetimeCurves() const {
+    return curves_;
+  }
+  /* Reorders the particles along a Z-order curve at the start of an
+   * update, so neighbours on the canvas become neighbours in memory for
+   * the pair forces, the rasterizer and the GPU. Sorts every interval
+   * steps (0 = never) and whenever the sampled disorder exceeds threshold
+   * (0 = never); both 0, the default, is off. Sorted particles lose
+   * their emission order, so evicting the oldest thins them out evenly. */
+  void setSpatialSort(std::uint32_t interval, float threshold);
+  [[nodiscard]] std::uint32_t getSortInterval() const { return sortInterval_; }
+  [[nodiscard]] float getSortThreshold() const { return sortThreshold_; }
+  [[nodiscard]] bool getSpatialSort() const {
+    return sortInterval_ != 0 || sortThreshold_ > 0;
+  }
+  void sortSpatially(); /*< Sorts right away */
+  /* MortonSorter::disorder of the particles, 0 = in Z-order */
+  [[nodiscard]] float getDisorder() const;
+  /* Updates since the last sort, and how many leading particles are in
+   * spatial rather than emission order, grouped by strip when sharded;
+   * restored from checkpoints */
+  [[nodiscard]] std::uint32_t getStepsSinceSort() const {
+    return stepsSinceSort_;
+  }
+  void setStepsSinceSort(std::uint32_t steps) { stepsSinceSort_ = steps; }
+  [[nodiscard]] std::size_t getSortedCount() const { return sorted_; }
+  /* Keeps the particles in a CompactParticleStore, 16 rather than 28 bytes
+   * each, for counts where the update is bound by memory bandwidth. An
+   * update unpacks one chunk at a time into per-thread scratch, runs the
+   * usual kernel there and packs the result; snapshots stay packed until
+   * the render thread expands them. Pair forces and getParticles() work on
+   * a full-precision copy. Precision is CompactParticleStore's; switching
+   * converts the live particles. Off by default. */
+  void setCompact(bool compact);
+  [[nodiscard]] bool getCompact() const { return compact_; }
+  /* Splits the canvas into shards horizontal strips and keeps the
+   * particles grouped by strip, so each worker updates and interacts
+   * mostly with memory of its own: pair forces see the strip plus a ghost
+   * zone of its neighbours' particles instead of one grid over the whole
+   * canvas, and particles that cross an edge migrate through per-strip
+   * outboxes after the update. Results depend on the shard count, never
+   * on the thread count. Replaces the spatial sort; fewer than 2, the
+   * default, is off. */
+  void setShards(std::size_t shards);
+  [[nodiscard]] std::size_t getShards() const {
+    return decomposition_.getStrips();
+  }
+  /* Particles that changed strips in the last update */
+  [[nodiscard]] std::size_t getMigrated() const {
+    return decomposition_.getMigrated();
+  }
+  /* Pool used for emission and update, ThreadPool::instance() by default */
+  void setThreadPool(ThreadPool &pool) { pool_ = &pool; }
+  /* Hard limit on live particles, 0 = unbounded. All per-particle
+   * buffers are preallocated, so a warmed-up system at capacity emits and
+   * updates without touching the heap. Shrinking evicts the oldest. */
+  void setCapacity(std::size_t capacity);
+  void setOverflowPolicy(OverflowPolicy policy) { overflowPolicy_ = policy; }
+  [[nodiscard]] std::size_t getCapacity() const { return capacity_; }
+  /* Soft limit on live particles below the capacity, 0 = none. Unlike
+   * setCapacity it never touches the buffers, so it can move every frame.
+   * Lowering it culls at once: the most transparent particles under
+   * RECYCLE_MOST_TRANSPARENT, the oldest otherwise. */
+  void setBudget(std::size_t budget);
+  [[nodiscard]] std::size_t getBudget() const { return budget_; }
+  [[nodiscard]] OverflowPolicy getOverflowPolicy() const {
+    return overflowPolicy_;
+  }
+  [[nodiscard]] const PoolStats &getPoolStats() const { return poolStats_; }
+  /* Force fields, all evaluated in one pass fused with integration.
+   * add returns the index for later setForceField/removeForceField. */
+  std::size_t addForceField(const ForceField &field);
+  void setForceField(std::size_t index, const ForceField &field) {
+    forceFields_[index] = field;
+  }
+  void removeForceField(std::size_t index);
+  void clearForceFields() { forceFields_.clear(); }
+  [[nodiscard]] const std::vector<ForceField> &getForceFields() const {
+    return forceFields_;
+  }
+  /* Particle-particle interactions, evaluated before integration over a
+   * uniform grid rebuilt every step */
+  void addPairForce(const PairForce &force) { pairForces_.push_back(force); }
+  void clearPairForces() { pairForces_.clear(); }
+  [[nodiscard]] const std::vector<PairForce> &getPairForces() const {
+    return pairForces_;
+  }
+  /* Grid cell edge in pixels, 0 = the largest force radius */
+  void setInteractionCellSize(float cellSize) {
+    interactionCellSize_ = cellSize;
+  }
+  [[nodiscard]] float getInteractionCellSize() const {
+    return interactionCellSize_;
+  }
+  /* Neighbours considered per particle and force */
+  void setMaxNeighbours(std::size_t count) { maxNeighbours_ = count; }
+  [[nodiscard]] std::size_t getMaxNeighbours() const { return maxNeighbours_; }
+  /* Reseeds emission; the same seed reproduces the same particles.
+   * emitted resumes a sequence after that many particles. */
+  void setSeed(std::uint64_t seed, std::uint64_t emitted = 0);
+  [[nodiscard]] std::uint64_t getSeed() const { return seed_; }
+  [[nodiscard]] std::uint64_t getEmitted() const { return emitted_; }
+  /* Simulated seconds so far; animates NOISE fields */
+  void setFieldTime(float time) { fieldTime_ = time; }
+  [[nodiscard]] float getFieldTime() const { return fieldTime_; }
+  /* Raw particle state, e.g. for checkpoints; unpacked on demand in
+   * compact mode. setParticles replaces all particles; they must fit the
+   * capacity. The first sorted of them are in spatial order, see
+   * getSortedCount(). */
+  [[nodiscard]] const ParticleStore &getParticles() const;
+  void setParticles(const ParticleStore &particles, std::size_t sorted = 0);
   void setPosition(float x, float y) {
     startPos_.x = x;
     startPos_.y = y;
   }
 
  private:
+  /* Emits into out slots [begin, end) */
+  void emitBlock(ParticleStore &out, std::size_t begin, std::size_t end,
+                 std::uint64_t sequence, const Emitter &emitter);
+  /* Grows the particles to last and runs fill(out, offset, begin, end) in
+   * parallel over the new slots [first, last), each to be written to out
+   * at slot - offset. Compact mode packs them from staging afterwards. */
+  template <typename Fill>
+  void fillSlots(std::size_t first, std::size_t last, const Fill &fill);
+  /* Runs fn on the store the particles live in */
+  template <typename Fn>
+  void withStore(const Fn &fn) {
+    if (compact_) {
+      fn(packed_);
+    } else {
+      fn(particles_);
+    }
+  }
+  [[nodiscard]] std::size_t liveCount() const {
+    return compact_ ? packed_.size() : particles_.size();
+  }
+  void snapshotPacked(ParticleSnapshot &out) const;
+  /* Kernel over packed chunk [begin, end), see setCompact */
+  std::size_t updatePacked(KernelFn kernel, std::size_t begin,
+                           std::size_t end, const KernelParams &params);
+  /* Kernel over all particles, chunk by chunk, survivors kept in order */
+  void updateChunks(KernelFn kernel, const KernelParams &params);
+  /* Kernel shard by shard, survivors regrouped by strip, see setShards */
+  void updateSharded(KernelFn kernel, const KernelParams &params);
+  /* Position the shards are told apart by, packed or not */
+  [[nodiscard]] float positionY(std::size_t index) const;
+  void pack(const ParticleStore &from);
+  void unpack(ParticleStore &to) const;
+  /* Where to keep the particles for the capacity, by mode */
+  void reserveStores();
+  /* Frees slots for count new particles, returns how many fit */
+  std::size_t makeRoom(std::size_t count);
+  /* The lower of capacity and budget, 0 = unbounded */
+  [[nodiscard]] std::size_t liveLimit() const;
+  void evictMostTransparent(std::size_t count);
+  /* Evicts the count oldest particles. Sorted particles all count as old
+   * as the oldest of them, and are thinned out evenly rather than cut
+   * away one region of the canvas at a time. */
+  void evictOldest(std::size_t count);
+  [[nodiscard]] bool sortDue() const;
+  void applyPairForces(float deltaTime);
+
+  static constexpr std::size_t EMIT_BLOCK = 4096;
+  static constexpr std::size_t UPDATE_CHUNK = 16384;
+  static constexpr std::size_t PACK_STAGING = 65536; /*< Emit slice, packed */
+  static constexpr std::uint64_t RNG_DRAWS = 5;  /*< Counters per particle */
+  static constexpr float AGING_PER_RATE = 0.25F; /*< Real time at rate 4 */
+  static constexpr float MIN_LIFETIME = 0.001F;  /*< Seconds */
+
   bool dissolve_;        /*< Dissolution enabled? */
   float particle_speed_; /*< Pixels per second (at most) */
 
   sf::Color transparent_; /*< sf::Color(0, 0, 0, 0) */
 
-  sf::Uint8 dissolutionRate_; /*< Rate particles disolve */
+  sf::Uint8 dissolutionRate_; /*< Speed particles age at */
   Shape shape_;               /*< Shape of distribution */
 
   sf::Vector2f gravity_;    /*< Influences particle velocities */
   sf::Vector2f startPos_;   /*< Particle origin */
   sf::Vector2u canvasSize_; /*< Limits of particle travel */
+  float lastThrust_{0};     /*< deltaTime * speed of the last update */
+
+  float lifetimeMin_{1.0F}; /*< Seconds */
+  float lifetimeMax_{1.5F}; /*< Seconds */
+  LifetimeCurves curves_{LifetimeCurves::fade()};
+  LifetimeTable lifetimeTable_; /*< curves_, baked */
+
+  std::size_t capacity_{0}; /*< Live particle limit, 0 = none */
+  std::size_t budget_{0};   /*< Soft limit below capacity_, 0 = none */
+  OverflowPolicy overflowPolicy_{OverflowPolicy::DROP_NEW};
+  PoolStats poolStats_; /*< Emission outcome counters */
+
+  std::uint64_t seed_;                   /*< Seed of rng_ */
+  CounterRng rng_;                       /*< Emission randomness */
+  std::uint64_t emitted_{0};             /*< Particles emitted since seeding */
+  std::vector<std::size_t> emitOffsets_; /*< First slot per emitter */
+
+  KernelIsa kernelIsa_;                     /*< Update kernel code path */
+  BoundsMode boundsMode_{BoundsMode::CULL}; /*< Canvas edge handling */
+  std::vector<std::uint8_t> aliveMask_;     /*< Survival mask of last step */
+  std::vector<std::uint32_t> survivors_;    /*< Compaction indices */
+  std::vector<std::size_t> chunkOffsets_;   /*< Survivor offset per chunk */
+  ThreadPool *pool_;                        /*< Runs emission and update */
+
+  std::vector<ForceField> forceFields_; /*< Fields, in order */
+  float fieldTime_{0};                  /*< Simulated seconds, for NOISE */
+
+  std::vector<PairForce> pairForces_; /*< Interactions, in order */
+  float interactionCellSize_{0};      /*< 0 = largest force radius */
+  std::size_t maxNeighbours_{32};     /*< Per particle and force */
+  SpatialGrid grid_;                  /*< Neighbour lookup */
+  std::vector<float> pairDvx_;        /*< Velocity change, grid order */
+  std::vector<float> pairDvy_;        /*< Velocity change, grid order */
+
+  std::uint32_t sortInterval_{0};   /*< Steps between sorts, 0 = never */
+  float sortThreshold_{0};          /*< Disorder forcing a sort, 0 = never */
+  std::uint32_t stepsSinceSort_{0}; /*< Updates since the last sort */
+  std::size_t sorted_{0};           /*< Leading particles in spatial order */
+  MortonSorter sorter_;             /*< Spatial order */
+
+  DomainDecomposition decomposition_;     /*< Strips, when sharded */
+  std::vector<std::size_t> shardChunks_; /*< First chunk per shard, + end */
+
+  ParticleStore particles_; /*< SoA particle attributes */
+  ParticleStore back_;      /*< Compaction target; staging when compact */
+
+  bool compact_{false};                  /*< Particles live in packed_ */
+  CompactParticleStore packed_;          /*< Particles in compact mode */
+  CompactParticleStore packedBack_;      /*< Compaction target, compact */
+  mutable ParticleStore unpacked_;       /*< getParticles() when compact */
+  mutable bool unpackedDirty_{true};
 
-  std::vector<Particle> particles_;
+  mutable std::vector<sf::Vertex> vertices_; /*< Batched draw buffer */
+  mutable bool verticesDirty_{true};
 };
 
 }  // namespace app
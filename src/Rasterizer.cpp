@@ -0,0 +1,153 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "Rasterizer.hpp"
+
+#include <SFML/Config.hpp>          // for Uint8
+#include <SFML/Graphics/Image.hpp>  // for Image
+#include <algorithm>                // for clamp, fill, min
+#include <fstream>                  // for ofstream
+
+#include "detail/Profiler.hpp"  // for APP_PROFILE_SCOPE
+
+namespace app {
+
+namespace {
+
+struct Point {
+  float x;
+  float y;
+  sf::Color color;
+};
+
+/* sf::BlendAlpha in 8 bit: color = src * a + dst * (1 - a) and
+ * alpha = a + dstAlpha * (1 - a). (v + 127) / 255 rounds v / 255 to the
+ * nearest integer, ties cannot happen. */
+sf::Uint8 mix(unsigned int src, unsigned int dst, unsigned int alpha) {
+  return static_cast<sf::Uint8>((src * alpha + dst * (255U - alpha) + 127U) /
+                                255U);
+}
+
+void blend(sf::Color &dst, const sf::Color &src) {
+  const unsigned int alpha = src.a;
+  dst.r = mix(src.r, dst.r, alpha);
+  dst.g = mix(src.g, dst.g, alpha);
+  dst.b = mix(src.b, dst.b, alpha);
+  dst.a = static_cast<sf::Uint8>(alpha +
+                                 (dst.a * (255U - alpha) + 127U) / 255U);
+}
+
+}  // namespace
+
+/************************************************************/
+Rasterizer::Rasterizer(sf::Vector2u size) : pool_(&ThreadPool::instance()) {
+  setSize(size);
+}
+
+/************************************************************/
+void Rasterizer::setSize(sf::Vector2u size) {
+  size_ = size;
+  columns_ = (size.x + TILE - 1) / TILE;
+  rows_ = (size.y + TILE - 1) / TILE;
+  pixels_.resize(static_cast<std::size_t>(size.x) * size.y);
+}
+
+/************************************************************/
+void Rasterizer::clear(const sf::Color &color) {
+  std::fill(pixels_.begin(), pixels_.end(), color);
+}
+
+/************************************************************/
+void Rasterizer::draw(const ParticleStore &particles) {
+  drawPoints(particles.size(), [&particles](std::size_t i) {
+    return Point{particles.x[i], particles.y[i], particles.color[i]};
+  });
+}
+
+/************************************************************/
+void Rasterizer::draw(const std::vector<sf::Vertex> &vertices) {
+  drawPoints(vertices.size(), [&vertices](std::size_t i) {
+    return Point{vertices[i].position.x, vertices[i].position.y,
+                 vertices[i].color};
+  });
+}
+
+/************************************************************/
+template <typename Points>
+void Rasterizer::drawPoints(std::size_t count, const Points &points) {
+  APP_PROFILE_SCOPE("Rasterizer::draw");
+  const std::size_t tiles = columns_ * rows_;
+  if (count == 0 || tiles == 0) {
+    return;
+  }
+  ThreadPool &pool = *pool_;
+  const auto width = static_cast<float>(size_.x);
+  const auto height = static_cast<float>(size_.y);
+
+  /* Bin by tile. Transparent points leave the pixel as it is, so they are
+   * culled with the off-screen ones; NaN positions fail every comparison
+   * and are culled as well. The sort is stable, so every tile blends its
+   * points in store order. */
+  tiles_.bin(count, tiles, pool, [&](std::size_t i) {
+    const Point point = points(i);
+    if (point.color.a != 0 && point.x >= 0 && point.x < width &&
+        point.y >= 0 && point.y < height) {
+      return static_cast<std::uint32_t>(
+          static_cast<std::size_t>(point.y) / TILE * columns_ +
+          static_cast<std::size_t>(point.x) / TILE);
+    }
+    return CountingSort::SKIP;
+  });
+  const std::vector<std::uint32_t> &tileStart = tiles_.starts();
+
+  splats_.resize(tileStart[tiles]);
+  tiles_.scatter(pool, [&](std::size_t i, std::uint32_t slot) {
+    const Point point = points(i);
+    splats_[slot] = Splat{
+        static_cast<std::uint32_t>(static_cast<std::size_t>(point.y) *
+                                       size_.x +
+                                   static_cast<std::size_t>(point.x)),
+        point.color};
+  });
+
+  /* Blend: one tile of pixels stays in cache while its splats land */
+  pool.parallelFor(0, tiles, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t tile = first; tile < last; ++tile) {
+      for (std::uint32_t s = tileStart[tile]; s < tileStart[tile + 1];
+           ++s) {
+        blend(pixels_[splats_[s].pixel], splats_[s].color);
+      }
+    }
+  });
+}
+
+/************************************************************/
+bool Rasterizer::save(const std::string &path) const {
+  static_assert(sizeof(sf::Color) == 4, "pixels must be packed RGBA");
+  const std::string ppm{".ppm"};
+  if (path.size() < ppm.size() ||
+      path.compare(path.size() - ppm.size(), ppm.size(), ppm) != 0) {
+    sf::Image image;
+    image.create(size_.x, size_.y,
+                 reinterpret_cast<const sf::Uint8 *>(pixels_.data()));
+    return image.saveToFile(path);
+  }
+  /* PPM has no alpha channel; like a window, the frame shows the colors
+   * as blended over the clear color */
+  std::ofstream out{path, std::ios::binary | std::ios::trunc};
+  out << "P6\n" << size_.x << ' ' << size_.y << "\n255\n";
+  std::vector<char> row(static_cast<std::size_t>(size_.x) * 3);
+  for (unsigned int y = 0; y < size_.y; ++y) {
+    for (unsigned int x = 0; x < size_.x; ++x) {
+      const sf::Color &pixel = getPixel(x, y);
+      row[3 * x] = static_cast<char>(pixel.r);
+      row[3 * x + 1] = static_cast<char>(pixel.g);
+      row[3 * x + 2] = static_cast<char>(pixel.b);
+    }
+    out.write(row.data(), static_cast<std::streamsize>(row.size()));
+  }
+  return out.good();
+}
+
+}  // namespace app
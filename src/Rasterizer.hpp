@@ -0,0 +1,78 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_RASTERIZER_HPP
+#define SFMLTEST_RASTERIZER_HPP
+
+#include <SFML/Graphics/Color.hpp>   // for Color
+#include <SFML/Graphics/Vertex.hpp>  // for Vertex
+#include <SFML/System/Vector2.hpp>   // for Vector2u
+#include <cstddef>                   // for size_t
+#include <cstdint>                   // for uint32_t
+#include <string>                    // for string
+#include <vector>                    // for vector
+
+#include "ParticleStore.hpp"         // for ParticleStore
+#include "detail/CountingSort.hpp"   // for CountingSort
+#include "detail/ThreadPool.hpp"     // for ThreadPool
+
+namespace app {
+
+/* CPU renderer for the particle points, no window or GL context needed.
+ * Every point covers the pixel it falls into and is blended like sf::Points
+ * with sf::BlendAlpha, in store order. Points are binned into square tiles
+ * with a parallel, stable CountingSort, then the tiles are blended in
+ * parallel; tiles own disjoint pixels, so the result does not depend on the
+ * thread count. */
+class Rasterizer {
+ public:
+  explicit Rasterizer(sf::Vector2u size = {});
+
+  void setThreadPool(ThreadPool &pool) { pool_ = &pool; }
+  /* Resizes the framebuffer; its content is undefined until clear() */
+  void setSize(sf::Vector2u size);
+  [[nodiscard]] const sf::Vector2u &getSize() const { return size_; }
+
+  void clear(const sf::Color &color = sf::Color::Black);
+  void draw(const ParticleStore &particles);
+  void draw(const std::vector<sf::Vertex> &vertices);
+
+  /* RGBA pixels, row by row from the top left, as in sf::Image */
+  [[nodiscard]] const std::vector<sf::Color> &getPixels() const {
+    return pixels_;
+  }
+  [[nodiscard]] const sf::Color &getPixel(unsigned int x,
+                                          unsigned int y) const {
+    return pixels_[static_cast<std::size_t>(y) * size_.x + x];
+  }
+  /* Binary PPM for .ppm paths, otherwise whatever sf::Image writes for
+   * the extension (png, bmp, tga, jpg) */
+  bool save(const std::string &path) const;
+
+  static constexpr unsigned int TILE = 64; /*< Tile edge in pixels */
+
+ private:
+  /* Pixel and color of one point, in tile order */
+  struct Splat {
+    std::uint32_t pixel;
+    sf::Color color;
+  };
+
+  template <typename Points>
+  void drawPoints(std::size_t count, const Points &points);
+
+
+  sf::Vector2u size_;
+  std::size_t columns_{0}; /*< Tiles per row */
+  std::size_t rows_{0};    /*< Tile rows */
+  std::vector<sf::Color> pixels_;
+
+  CountingSort tiles_;        /*< Visible points by tile */
+  std::vector<Splat> splats_; /*< Visible points, tile order */
+  ThreadPool *pool_;          /*< Bins and blends */
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_RASTERIZER_HPP
@@ -0,0 +1,707 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "Recording.hpp"
+
+#include <SFML/Config.hpp>  // for Uint8
+#include <algorithm>        // for min
+#include <array>            // for array
+#include <cstring>          // for memcpy
+#include <string>           // for string, to_string
+
+#include "EmitterManager.hpp"     // for EmitterManager
+#include "ParticleSystem.hpp"     // for ParticleSystem
+#include "detail/ByteStream.hpp"  // for ByteReader, ByteWriter
+
+namespace app {
+
+namespace {
+
+constexpr std::uint32_t VERSION = 6;
+constexpr std::size_t ALIGNMENT = 64;     /*< Of headers and arrays */
+constexpr std::uint8_t END_RECORD = 0xFF; /*< Type byte closing the log */
+constexpr std::array<char, 4> LOG_MAGIC{'S', 'F', 'R', 'C'};
+constexpr std::array<char, 4> STATE_MAGIC{'S', 'F', 'S', 'T'};
+
+struct LogHeader {
+  std::array<char, 4> magic{LOG_MAGIC};
+  std::uint32_t version{VERSION};
+  float deltaTime{0}; /*< Seconds per step */
+  std::uint32_t reserved0{0};
+  std::array<std::uint64_t, 6> reserved{};
+};
+static_assert(sizeof(LogHeader) == ALIGNMENT);
+
+struct StateHeader {
+  std::array<char, 4> magic{STATE_MAGIC};
+  std::uint32_t version{VERSION};
+  std::uint64_t step{0};          /*< Steps simulated before this state */
+  std::uint64_t logOffset{0};     /*< First log record of that step */
+  std::uint64_t recordStep{0};    /*< Step of the record before it */
+  std::uint64_t blockBytes{0};    /*< Whole state, header included */
+  std::uint64_t settingsBytes{0}; /*< Padded, follows the header */
+  std::uint64_t count{0};         /*< Particles */
+  std::uint64_t sorted{0};        /*< Leading particles in spatial order */
+};
+static_assert(sizeof(StateHeader) == ALIGNMENT);
+
+/* Bytes of one particle array, padded so the next one stays aligned */
+std::size_t arrayBytes(std::size_t count) {
+  return (count * sizeof(float) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+std::string checkpointPath(const std::string &path) { return path + ".ckpt"; }
+
+/* Enums travel as one byte and are range checked on the way back */
+template <typename Enum>
+void putEnum(ByteWriter &out, Enum value) {
+  out.put(static_cast<std::uint8_t>(value));
+}
+
+template <typename Enum>
+Enum getEnum(ByteReader &in, std::uint8_t values, bool &valid) {
+  const auto value = in.get<std::uint8_t>();
+  valid = valid && value < values;
+  return static_cast<Enum>(value < values ? value : 0);
+}
+
+void putColor(ByteWriter &out, const sf::Color &color) {
+  out.put(std::array<sf::Uint8, 4>{color.r, color.g, color.b, color.a});
+}
+
+sf::Color getColor(ByteReader &in) {
+  const auto rgba = in.get<std::array<sf::Uint8, 4>>();
+  return sf::Color{rgba[0], rgba[1], rgba[2], rgba[3]};
+}
+
+void putField(ByteWriter &out, const ForceField &field) {
+  putEnum(out, field.type);
+  out.put(field.position.x);
+  out.put(field.position.y);
+  out.put(field.strength);
+  out.put(field.radius);
+  out.put(field.frequency);
+}
+
+ForceField getField(ByteReader &in, bool &valid) {
+  ForceField field;
+  field.type = getEnum<ForceFieldType>(in, 4, valid);
+  field.position.x = in.get<float>();
+  field.position.y = in.get<float>();
+  field.strength = in.get<float>();
+  field.radius = in.get<float>();
+  field.frequency = in.get<float>();
+  return field;
+}
+
+void putPairForce(ByteWriter &out, const PairForce &force) {
+  putEnum(out, force.type);
+  out.put(force.radius);
+  out.put(force.strength);
+}
+
+PairForce getPairForce(ByteReader &in, bool &valid) {
+  PairForce force;
+  force.type = getEnum<PairForceType>(in, 3, valid);
+  force.radius = in.get<float>();
+  force.strength = in.get<float>();
+  return force;
+}
+
+void putEmitter(ByteWriter &out, const Emitter &emitter) {
+  out.put(emitter.position.x);
+  out.put(emitter.position.y);
+  out.put(emitter.rate);
+  putEnum(out, emitter.shape);
+  out.put(emitter.speed);
+  putColor(out, emitter.colorMin);
+  putColor(out, emitter.colorMax);
+  out.put(static_cast<std::uint8_t>(emitter.enabled));
+}
+
+Emitter getEmitter(ByteReader &in, bool &valid) {
+  Emitter emitter;
+  emitter.position.x = in.get<float>();
+  emitter.position.y = in.get<float>();
+  emitter.rate = in.get<float>();
+  emitter.shape = getEnum<Shape>(in, 2, valid);
+  emitter.speed = in.get<float>();
+  emitter.colorMin = getColor(in);
+  emitter.colorMax = getColor(in);
+  emitter.enabled = in.get<std::uint8_t>() != 0;
+  return emitter;
+}
+
+void putCurves(ByteWriter &out, const LifetimeCurves &curves) {
+  out.put(static_cast<std::uint8_t>(curves.count));
+  out.put(static_cast<std::uint8_t>(curves.tint));
+  for (std::size_t i = 0; i < curves.count; ++i) {
+    out.put(curves.stops[i].age);
+    putColor(out, curves.stops[i].color);
+  }
+}
+
+LifetimeCurves getCurves(ByteReader &in, bool &valid) {
+  LifetimeCurves curves;
+  const auto count = in.get<std::uint8_t>();
+  valid = valid && count <= MAX_CURVE_STOPS;
+  curves.count = std::min<std::size_t>(count, MAX_CURVE_STOPS);
+  curves.tint = in.get<std::uint8_t>() != 0;
+  for (std::size_t i = 0; i < curves.count; ++i) {
+    curves.stops[i].age = in.get<float>();
+    curves.stops[i].color = getColor(in);
+  }
+  return curves;
+}
+
+void putVector(ByteWriter &out, const sf::Vector2f &vector) {
+  out.put(vector.x);
+  out.put(vector.y);
+}
+
+sf::Vector2f getVector(ByteReader &in) {
+  const auto x = in.get<float>();
+  return sf::Vector2f{x, in.get<float>()};
+}
+
+/* Payload only; the type byte is written by the caller */
+void encodeCommand(ByteWriter &out, const Command &command) {
+  switch (command.type) {
+    case CommandType::EMIT:
+    case CommandType::SET_DISSOLUTION_RATE:
+    case CommandType::SET_BUDGET:
+    case CommandType::SET_SHARDS:
+      out.putVarint(command.count);
+      break;
+    case CommandType::SET_POSITION:
+    case CommandType::SET_GRAVITY:
+    case CommandType::SET_LIFETIME:
+      putVector(out, command.vector);
+      break;
+    case CommandType::SET_DISSOLVE:
+    case CommandType::SET_COMPACT:
+      out.put(static_cast<std::uint8_t>(command.flag));
+      break;
+    case CommandType::SET_SPEED:
+      out.put(command.value);
+      break;
+    case CommandType::SET_SHAPE:
+      putEnum(out, command.shape);
+      break;
+    case CommandType::SET_OVERFLOW:
+      putEnum(out, command.policy);
+      break;
+    case CommandType::SET_BOUNDS:
+      putEnum(out, command.bounds);
+      break;
+    case CommandType::SET_FIELD:
+      out.putVarint(command.count);
+      putField(out, command.field);
+      break;
+    case CommandType::ADD_PAIR_FORCE:
+      putPairForce(out, command.pairForce);
+      break;
+    case CommandType::ADD_EMITTER:
+      putEmitter(out, command.emitter);
+      break;
+    case CommandType::SET_CURVES:
+      putCurves(out, command.curves);
+      break;
+    case CommandType::SET_SPATIAL_SORT:
+      out.putVarint(command.count);
+      out.put(command.value);
+      break;
+    case CommandType::CLEAR_PAIR_FORCES:
+    case CommandType::CLEAR_EMITTERS:
+      break;
+  }
+}
+
+bool decodeCommand(ByteReader &in, std::uint8_t type, Command &command) {
+  bool valid =
+      type <= static_cast<std::uint8_t>(CommandType::SET_SHARDS);
+  if (!valid) {
+    return false;
+  }
+  command = Command{};
+  command.type = static_cast<CommandType>(type);
+  switch (command.type) {
+    case CommandType::EMIT:
+    case CommandType::SET_DISSOLUTION_RATE:
+    case CommandType::SET_BUDGET:
+    case CommandType::SET_SHARDS:
+      command.count = static_cast<std::uint32_t>(in.getVarint());
+      break;
+    case CommandType::SET_POSITION:
+    case CommandType::SET_GRAVITY:
+    case CommandType::SET_LIFETIME:
+      command.vector = getVector(in);
+      break;
+    case CommandType::SET_DISSOLVE:
+    case CommandType::SET_COMPACT:
+      command.flag = in.get<std::uint8_t>() != 0;
+      break;
+    case CommandType::SET_SPEED:
+      command.value = in.get<float>();
+      break;
+    case CommandType::SET_SHAPE:
+      command.shape = getEnum<Shape>(in, 2, valid);
+      break;
+    case CommandType::SET_OVERFLOW:
+      command.policy = getEnum<OverflowPolicy>(in, 3, valid);
+      break;
+    case CommandType::SET_BOUNDS:
+      command.bounds = getEnum<BoundsMode>(
+          in, static_cast<std::uint8_t>(BOUNDS_MODES), valid);
+      break;
+    case CommandType::SET_FIELD:
+      command.count = static_cast<std::uint32_t>(in.getVarint());
+      command.field = getField(in, valid);
+      break;
+    case CommandType::ADD_PAIR_FORCE:
+      command.pairForce = getPairForce(in, valid);
+      break;
+    case CommandType::ADD_EMITTER:
+      command.emitter = getEmitter(in, valid);
+      break;
+    case CommandType::SET_CURVES:
+      command.curves = getCurves(in, valid);
+      break;
+    case CommandType::SET_SPATIAL_SORT:
+      command.count = static_cast<std::uint32_t>(in.getVarint());
+      command.value = in.get<float>();
+      break;
+    case CommandType::CLEAR_PAIR_FORCES:
+    case CommandType::CLEAR_EMITTERS:
+      break;
+  }
+  return valid && in.ok();
+}
+
+/* Everything an update depends on besides the particles */
+void putSettings(ByteWriter &out, const ParticleSystem &system,
+                 const EmitterManager &emitters) {
+  out.put(system.getSeed());
+  out.put(system.getEmitted());
+  out.put(system.getFieldTime());
+  out.put(static_cast<std::uint8_t>(system.getDissolve()));
+  out.put(static_cast<std::uint8_t>(system.getDissolutionRate()));
+  out.put(system.getParticleSpeed());
+  out.put(system.getLifetimeMin());
+  out.put(system.getLifetimeMax());
+  putCurves(out, system.getLifetimeCurves());
+  putEnum(out, system.getShape());
+  putVector(out, system.getGravity());
+  putVector(out, system.getPosition());
+  out.put(system.getCanvasSize().x);
+  out.put(system.getCanvasSize().y);
+  out.putVarint(system.getCapacity());
+  out.putVarint(system.getBudget());
+  putEnum(out, system.getOverflowPolicy());
+  putEnum(out, system.getBoundsMode());
+  out.put(system.getInteractionCellSize());
+  out.putVarint(system.getMaxNeighbours());
+  out.putVarint(system.getSortInterval());
+  out.put(system.getSortThreshold());
+  out.putVarint(system.getStepsSinceSort());
+  out.put(static_cast<std::uint8_t>(system.getCompact()));
+  out.putVarint(system.getShards());
+  out.putVarint(system.getForceFields().size());
+  for (const auto &field : system.getForceFields()) {
+    putField(out, field);
+  }
+  out.putVarint(system.getPairForces().size());
+  for (const auto &force : system.getPairForces()) {
+    putPairForce(out, force);
+  }
+  out.putVarint(emitters.size());
+  for (std::size_t i = 0; i < emitters.size(); ++i) {
+    putEmitter(out, emitters.get(i));
+    out.put(emitters.getOwed(i));
+  }
+}
+
+bool getSettings(ByteReader &in, ParticleSystem &system,
+                 EmitterManager &emitters) {
+  bool valid{true};
+  const auto seed = in.get<std::uint64_t>();
+  const auto emitted = in.get<std::uint64_t>();
+  system.setSeed(seed, emitted);
+  system.setFieldTime(in.get<float>());
+  system.setDissolve(in.get<std::uint8_t>() != 0);
+  system.setDissolutionRate(in.get<sf::Uint8>());
+  system.setParticleSpeed(in.get<float>());
+  const auto lifetimeMin = in.get<float>();
+  system.setLifetime(lifetimeMin, in.get<float>());
+  system.setLifetimeCurves(getCurves(in, valid));
+  system.setShape(getEnum<Shape>(in, 2, valid));
+  system.setGravity(getVector(in));
+  system.setPosition(getVector(in));
+  const auto width = in.get<unsigned int>();
+  system.setCanvasSize(sf::Vector2u{width, in.get<unsigned int>()});
+  const std::size_t capacity = in.getVarint();
+  if (capacity != system.getCapacity()) {
+    system.setCapacity(capacity);
+  }
+  system.setBudget(in.getVarint());
+  system.setOverflowPolicy(getEnum<OverflowPolicy>(in, 3, valid));
+  system.setBoundsMode(
+      getEnum<BoundsMode>(in, static_cast<std::uint8_t>(BOUNDS_MODES), valid));
+  system.setInteractionCellSize(in.get<float>());
+  system.setMaxNeighbours(in.getVarint());
+  const auto sortInterval = static_cast<std::uint32_t>(in.getVarint());
+  system.setSpatialSort(sortInterval, in.get<float>());
+  system.setStepsSinceSort(static_cast<std::uint32_t>(in.getVarint()));
+  system.setCompact(in.get<std::uint8_t>() != 0);
+  system.setShards(in.getVarint());
+  system.clearForceFields();
+  for (auto count = in.getVarint(); count > 0 && in.ok(); --count) {
+    system.addForceField(getField(in, valid));
+  }
+  system.clearPairForces();
+  for (auto count = in.getVarint(); count > 0 && in.ok(); --count) {
+    system.addPairForce(getPairForce(in, valid));
+  }
+  emitters.clear();
+  for (auto count = in.getVarint(); count > 0 && in.ok(); --count) {
+    const std::size_t index = emitters.add(getEmitter(in, valid));
+    emitters.setOwed(index, in.get<float>());
+  }
+  return valid && in.ok();
+}
+
+/* Appends a full state to out; the header is patched in at the end */
+void writeState(std::vector<std::uint8_t> &out, const StateHeader &base,
+                const ParticleSystem &system, const EmitterManager &emitters) {
+  const std::size_t start = out.size();
+  ByteWriter writer{out};
+  writer.put(base);
+  putSettings(writer, system, emitters);
+  writer.pad(ALIGNMENT);
+  const std::size_t settingsEnd = out.size();
+
+  const ParticleStore &particles = system.getParticles();
+  const std::size_t count = particles.size();
+  static_assert(sizeof(sf::Color) == sizeof(float));
+  for (const void *array :
+       {static_cast<const void *>(particles.x.data()),
+        static_cast<const void *>(particles.y.data()),
+        static_cast<const void *>(particles.vx.data()),
+        static_cast<const void *>(particles.vy.data()),
+        static_cast<const void *>(particles.color.data()),
+        static_cast<const void *>(particles.age.data()),
+        static_cast<const void *>(particles.lifetime.data())}) {
+    writer.putBytes(array, count * sizeof(float));
+    writer.pad(ALIGNMENT);
+  }
+
+  StateHeader header = base;
+  header.blockBytes = out.size() - start;
+  header.settingsBytes = settingsEnd - start - sizeof(StateHeader);
+  header.count = count;
+  header.sorted = system.getSortedCount();
+  std::memcpy(out.data() + start, &header, sizeof(header));
+}
+
+/* Validates the state at data and restores system, emitters and, through
+ * particles, the particles */
+bool readState(const std::uint8_t *data, std::size_t size,
+               StateHeader &header, ParticleStore &particles,
+               ParticleSystem &system, EmitterManager &emitters) {
+  if (size < sizeof(StateHeader)) {
+    return false;
+  }
+  std::memcpy(&header, data, sizeof(header));
+  /* Every size is checked against the block before it is added to or
+   * multiplied, so a hostile header cannot overflow the sums */
+  if (header.magic != STATE_MAGIC || header.version != VERSION ||
+      header.blockBytes > size || header.blockBytes < sizeof(StateHeader) ||
+      header.settingsBytes > header.blockBytes - sizeof(StateHeader)) {
+    return false;
+  }
+  const std::size_t body =
+      header.blockBytes - sizeof(StateHeader) - header.settingsBytes;
+  if (header.count > body / (7 * sizeof(float)) ||
+      7 * arrayBytes(header.count) > body) {
+    return false;
+  }
+  ByteReader settings{data + sizeof(StateHeader), header.settingsBytes};
+  if (!getSettings(settings, system, emitters)) {
+    return false;
+  }
+
+  const std::size_t count = header.count;
+  particles.resize(count);
+  const std::uint8_t *array =
+      data + sizeof(StateHeader) + header.settingsBytes;
+  for (void *target : {static_cast<void *>(particles.x.data()),
+                       static_cast<void *>(particles.y.data()),
+                       static_cast<void *>(particles.vx.data()),
+                       static_cast<void *>(particles.vy.data()),
+                       static_cast<void *>(particles.color.data()),
+                       static_cast<void *>(particles.age.data()),
+                       static_cast<void *>(particles.lifetime.data())}) {
+    std::memcpy(target, array, count * sizeof(float));
+    array += arrayBytes(count);
+  }
+  system.setParticles(particles, header.sorted);
+  return true;
+}
+
+}  // namespace
+
+/************************************************************/
+bool Recorder::open(const std::string &path, const ParticleSystem &system,
+                    const EmitterManager &emitters, float deltaTime,
+                    std::uint64_t checkpointInterval) {
+  close();
+  log_.open(path, std::ios::binary | std::ios::trunc);
+  interval_ = checkpointInterval;
+  if (log_.is_open() && interval_ > 0) {
+    checkpoints_.open(checkpointPath(path), std::ios::binary | std::ios::trunc);
+    if (!checkpoints_.is_open()) {
+      log_.close();
+    }
+  }
+  if (!log_.is_open()) {
+    return false;
+  }
+  step_ = 0;
+  recordStep_ = 0;
+  buffer_.clear();
+
+  /* Header, then the state to start from; its records follow right after */
+  LogHeader header;
+  header.deltaTime = deltaTime;
+  ByteWriter{buffer_}.put(header);
+  writeState(buffer_, StateHeader{}, system, emitters);
+  StateHeader state;
+  std::memcpy(&state, buffer_.data() + sizeof(LogHeader), sizeof(state));
+  state.logOffset = buffer_.size();
+  std::memcpy(buffer_.data() + sizeof(LogHeader), &state, sizeof(state));
+  bytes_ = buffer_.size();
+  flush();
+  return log_.good();
+}
+
+/************************************************************/
+void Recorder::record(const Command &command) {
+  if (!isOpen()) {
+    return;
+  }
+  const std::size_t before = buffer_.size();
+  ByteWriter out{buffer_};
+  out.putVarint(step_ - recordStep_);
+  out.put(static_cast<std::uint8_t>(command.type));
+  encodeCommand(out, command);
+  recordStep_ = step_;
+  bytes_ += buffer_.size() - before;
+}
+
+/************************************************************/
+void Recorder::step(const ParticleSystem &system,
+                    const EmitterManager &emitters) {
+  if (!isOpen()) {
+    return;
+  }
+  ++step_;
+  flush();
+  if (interval_ > 0 && step_ % interval_ == 0) {
+    StateHeader header;
+    header.step = step_;
+    header.logOffset = bytes_;
+    header.recordStep = recordStep_;
+    state_.clear();
+    writeState(state_, header, system, emitters);
+    checkpoints_.write(reinterpret_cast<const char *>(state_.data()),
+                       static_cast<std::streamsize>(state_.size()));
+  }
+}
+
+/************************************************************/
+void Recorder::close() {
+  if (!isOpen()) {
+    return;
+  }
+  ByteWriter out{buffer_};
+  out.putVarint(step_ - recordStep_);
+  out.put(END_RECORD);
+  flush();
+  log_.close();
+  checkpoints_.close();
+}
+
+/************************************************************/
+void Recorder::flush() {
+  log_.write(reinterpret_cast<const char *>(buffer_.data()),
+             static_cast<std::streamsize>(buffer_.size()));
+  buffer_.clear();
+}
+
+/************************************************************/
+bool Replayer::open(const std::string &path, std::string &error) {
+  std::ifstream file{path, std::ios::binary | std::ios::ate};
+  if (!file.is_open()) {
+    error = "cannot open " + path;
+    return false;
+  }
+  log_.resize(static_cast<std::size_t>(file.tellg()));
+  file.seekg(0);
+  file.read(reinterpret_cast<char *>(log_.data()),
+            static_cast<std::streamsize>(log_.size()));
+  LogHeader header;
+  if (!file || log_.size() < sizeof(LogHeader)) {
+    error = path + " is not a session log";
+    return false;
+  }
+  std::memcpy(&header, log_.data(), sizeof(header));
+  if (header.magic != LOG_MAGIC || header.version != VERSION) {
+    error = path + " is not a version " + std::to_string(VERSION) +
+            " session log";
+    return false;
+  }
+  deltaTime_ = header.deltaTime;
+
+  /* Walk the stream once, so a damaged log fails here and not halfway
+   * through a replay. A log without end record, cut off between two
+   * commands, still replays up to its last command. */
+  StateHeader start;
+  if (log_.size() >= sizeof(LogHeader) + sizeof(StateHeader)) {
+    std::memcpy(&start, log_.data() + sizeof(LogHeader), sizeof(start));
+  }
+  if (start.magic != STATE_MAGIC ||
+      start.logOffset != sizeof(LogHeader) + start.blockBytes ||
+      start.logOffset > log_.size()) {
+    error = path + " has no complete initial state";
+    return false;
+  }
+  cursor_ = start.logOffset;
+  recordStep_ = 0;
+  steps_ = 0;
+  std::uint64_t recordStep{0};
+  Command command;
+  std::size_t next{0};
+  while (cursor_ < log_.size()) {
+    ByteReader in{log_.data(), log_.size()};
+    in.seek(cursor_);
+    const auto delta = in.getVarint();
+    if (in.get<std::uint8_t>() == END_RECORD && in.ok()) {
+      steps_ = recordStep_ + delta;
+      break;
+    }
+    if (!peek(recordStep, command, next)) {
+      error = "corrupt command at byte " + std::to_string(cursor_);
+      return false;
+    }
+    recordStep_ = recordStep;
+    steps_ = recordStep + 1;
+    cursor_ = next;
+  }
+
+  /* Index the checkpoints by their headers alone */
+  checkpointSteps_.clear();
+  checkpointOffsets_.clear();
+  checkpointPath_ = checkpointPath(path);
+  std::ifstream checkpoints{checkpointPath_, std::ios::binary | std::ios::ate};
+  /* A block must fit the file, seek() allocates that much for it */
+  const auto fileBytes =
+      checkpoints ? static_cast<std::uint64_t>(checkpoints.tellg()) : 0;
+  checkpoints.seekg(0);
+  std::uint64_t offset{0};
+  StateHeader state;
+  while (checkpoints.read(reinterpret_cast<char *>(&state), sizeof(state)) &&
+         state.magic == STATE_MAGIC && state.version == VERSION &&
+         state.step <= steps_ && state.blockBytes >= sizeof(state) &&
+         state.blockBytes <= fileBytes - offset) {
+    checkpointSteps_.push_back(state.step);
+    checkpointOffsets_.push_back(offset);
+    offset += state.blockBytes;
+    checkpoints.seekg(static_cast<std::streamoff>(offset));
+  }
+  step_ = 0;
+  cursor_ = 0;
+  return true;
+}
+
+/************************************************************/
+bool Replayer::seek(std::uint64_t step, ParticleSystem &system,
+                    EmitterManager &emitters) {
+  step = std::min(step, steps_);
+  /* Latest checkpoint at or before step, else the start of the log */
+  std::size_t index = checkpointSteps_.size();
+  while (index > 0 && checkpointSteps_[index - 1] > step) {
+    --index;
+  }
+  bool loaded{false};
+  if (index > 0) {
+    std::ifstream file{checkpointPath_, std::ios::binary};
+    StateHeader header;
+    file.seekg(static_cast<std::streamoff>(checkpointOffsets_[index - 1]));
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+      block_.resize(header.blockBytes);
+      std::memcpy(block_.data(), &header, sizeof(header));
+      file.read(reinterpret_cast<char *>(block_.data() + sizeof(header)),
+                static_cast<std::streamsize>(block_.size() - sizeof(header)));
+      loaded = file && loadState(block_.data(), block_.size(), system,
+                                 emitters);
+    }
+  }
+  if (!loaded &&
+      !loadState(log_.data() + sizeof(LogHeader),
+                 log_.size() - sizeof(LogHeader), system, emitters)) {
+    return false;
+  }
+  while (step_ < step && this->step(system, emitters)) {
+  }
+  return true;
+}
+
+/************************************************************/
+bool Replayer::step(ParticleSystem &system, EmitterManager &emitters) {
+  if (cursor_ == 0 || step_ >= steps_) {
+    return false;
+  }
+  std::uint64_t recordStep{0};
+  Command command;
+  std::size_t next{0};
+  while (peek(recordStep, command, next) && recordStep == step_) {
+    applyCommand(command, system, emitters);
+    recordStep_ = recordStep;
+    cursor_ = next;
+  }
+  emitters.emit(system, deltaTime_);
+  system.update(deltaTime_);
+  ++step_;
+  return true;
+}
+
+/************************************************************/
+bool Replayer::peek(std::uint64_t &step, Command &command,
+                    std::size_t &next) const {
+  ByteReader in{log_.data(), log_.size()};
+  in.seek(cursor_);
+  step = recordStep_ + in.getVarint();
+  const auto type = in.get<std::uint8_t>();
+  if (!in.ok() || type == END_RECORD || !decodeCommand(in, type, command)) {
+    return false;
+  }
+  next = in.offset();
+  return true;
+}
+
+/************************************************************/
+bool Replayer::loadState(const std::uint8_t *data, std::size_t size,
+                         ParticleSystem &system, EmitterManager &emitters) {
+  StateHeader header;
+  if (!readState(data, size, header, particles_, system, emitters) ||
+      header.logOffset > log_.size()) {
+    return false;
+  }
+  cursor_ = header.logOffset;
+  recordStep_ = header.recordStep;
+  step_ = header.step;
+  return true;
+}
+
+}  // namespace app
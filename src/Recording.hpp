@@ -0,0 +1,105 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_RECORDING_HPP
+#define SFMLTEST_RECORDING_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t, uint64_t
+#include <fstream>  // for ofstream
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "Command.hpp"        // for Command
+#include "ParticleStore.hpp"  // for ParticleStore
+
+namespace app {
+
+class EmitterManager;
+class ParticleSystem;
+
+/* Session logs, version 6.
+ *
+ * The log holds a 64 byte header, the full state at the start, then the
+ * command stream: per command the steps since the previous one (varint),
+ * its type byte and its payload. An end record closes the stream.
+ *
+ * Checkpoints go to log + ".ckpt": full states, back to back. A state is a
+ * 64 byte header, the settings, then the particle arrays x, y, vx, vy,
+ * color, age and lifetime; every part starts 64 byte aligned, so a mapped
+ * file can be used as arrays in place. Each state knows where in the log
+ * its step starts, which makes seeking a matter of loading the nearest
+ * state. */
+class Recorder {
+ public:
+  /* Starts a log of system and emitters at path. With checkpointInterval
+   * > 0 the full state is also saved every that many steps. */
+  bool open(const std::string &path, const ParticleSystem &system,
+            const EmitterManager &emitters, float deltaTime,
+            std::uint64_t checkpointInterval = 0);
+  /* Logs a command that is applied before the next step */
+  void record(const Command &command);
+  /* Call after every step; writes out the step and maybe a checkpoint */
+  void step(const ParticleSystem &system, const EmitterManager &emitters);
+  void close();
+
+  [[nodiscard]] bool isOpen() const { return log_.is_open(); }
+  [[nodiscard]] std::uint64_t getSteps() const { return step_; }
+  [[nodiscard]] std::uint64_t getBytes() const { return bytes_; }
+
+ private:
+  void flush();
+
+  std::ofstream log_;
+  std::ofstream checkpoints_;
+  std::vector<std::uint8_t> buffer_; /*< Encoded, not yet written */
+  std::uint64_t step_{0};            /*< Steps recorded */
+  std::uint64_t recordStep_{0};      /*< Step of the last command */
+  std::uint64_t bytes_{0};           /*< Log size including buffer_ */
+  std::uint64_t interval_{0};        /*< Steps per checkpoint, 0 = none */
+  std::vector<std::uint8_t> state_;  /*< Checkpoint being written */
+};
+
+/* Drives a ParticleSystem from a log, headless and deterministic */
+class Replayer {
+ public:
+  /* Loads the log and indexes the checkpoints next to it, if any */
+  bool open(const std::string &path, std::string &error);
+  /* Restores the state before step: loads the nearest earlier checkpoint
+   * and simulates the remaining steps */
+  bool seek(std::uint64_t step, ParticleSystem &system,
+            EmitterManager &emitters);
+  /* Runs the next step: its commands, the emitters, then the update.
+   * Returns false once all recorded steps have run. */
+  bool step(ParticleSystem &system, EmitterManager &emitters);
+
+  [[nodiscard]] std::uint64_t getStep() const { return step_; }
+  [[nodiscard]] std::uint64_t getSteps() const { return steps_; }
+  [[nodiscard]] float getDeltaTime() const { return deltaTime_; }
+  [[nodiscard]] const std::vector<std::uint64_t> &getCheckpoints() const {
+    return checkpointSteps_;
+  }
+
+ private:
+  /* Decodes the record at cursor_; false at the end of the stream */
+  bool peek(std::uint64_t &step, Command &command, std::size_t &next) const;
+  bool loadState(const std::uint8_t *data, std::size_t size,
+                 ParticleSystem &system, EmitterManager &emitters);
+
+  std::vector<std::uint8_t> log_;              /*< Whole log */
+  std::string checkpointPath_;                 /*< Empty = none */
+  std::vector<std::uint64_t> checkpointSteps_; /*< Ascending */
+  std::vector<std::uint64_t> checkpointOffsets_;
+  std::vector<std::uint8_t> block_; /*< Checkpoint being loaded */
+  ParticleStore particles_;         /*< Checkpoint particles */
+  float deltaTime_{0};
+  std::size_t cursor_{0};       /*< Next record */
+  std::uint64_t recordStep_{0}; /*< Step of the record before cursor_ */
+  std::uint64_t step_{0};       /*< Steps simulated */
+  std::uint64_t steps_{0};      /*< Steps in the log */
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_RECORDING_HPP
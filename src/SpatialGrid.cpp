@@ -0,0 +1,96 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "SpatialGrid.hpp"
+
+#include <algorithm>  // for clamp, max, min
+#include <cmath>      // for ceil
+
+#include "detail/Profiler.hpp"  // for APP_PROFILE_SCOPE
+
+namespace app {
+
+/************************************************************/
+void SpatialGrid::setCellSize(float cellSize) {
+  if (cellSize > 0 && cellSize != cellSize_) {
+    cellSize_ = cellSize;
+    resizeCells();
+  }
+}
+
+/************************************************************/
+void SpatialGrid::setBounds(float width, float height) {
+  if (width != width_ || height != height_) {
+    width_ = width;
+    height_ = height;
+    resizeCells();
+  }
+}
+
+/************************************************************/
+void SpatialGrid::setRowWindow(std::size_t first, std::size_t count) {
+  if (first != windowFirst_ || count != windowRows_) {
+    windowFirst_ = first;
+    windowRows_ = count;
+    resizeCells();
+  }
+}
+
+/************************************************************/
+void SpatialGrid::resizeCells() {
+  columns_ = std::max<std::size_t>(
+      1, static_cast<std::size_t>(std::ceil(width_ / cellSize_)));
+  const std::size_t canvasRows = std::max<std::size_t>(
+      1, static_cast<std::size_t>(std::ceil(height_ / cellSize_)));
+  firstRow_ = std::min(windowFirst_, canvasRows - 1);
+  rows_ = canvasRows - firstRow_;
+  if (windowRows_ != 0) {
+    rows_ = std::min(rows_, windowRows_);
+  }
+}
+
+/************************************************************/
+void SpatialGrid::reserve(std::size_t particles) {
+  binning_.reserve(particles);
+  order_.reserve(particles);
+  for (auto *attribute : {&x_, &y_, &vx_, &vy_}) {
+    attribute->reserve(particles);
+  }
+}
+
+/************************************************************/
+std::size_t SpatialGrid::cellOf(float x, float y) const {
+  const float column = std::clamp(x / cellSize_, 0.0F,
+                                  static_cast<float>(columns_ - 1));
+  const float row =
+      std::clamp(y / cellSize_, static_cast<float>(firstRow_),
+                 static_cast<float>(firstRow_ + rows_ - 1));
+  return (static_cast<std::size_t>(row) - firstRow_) * columns_ +
+         static_cast<std::size_t>(column);
+}
+
+/************************************************************/
+void SpatialGrid::build(const ParticleStore &store, ThreadPool &pool) {
+  APP_PROFILE_SCOPE("SpatialGrid::build");
+  if (columns_ == 0) {
+    resizeCells();
+  }
+  const std::size_t count = store.size();
+  binning_.bin(count, columns_ * rows_, pool, [&](std::size_t i) {
+    return static_cast<std::uint32_t>(cellOf(store.x[i], store.y[i]));
+  });
+  order_.resize(count);
+  for (auto *attribute : {&x_, &y_, &vx_, &vy_}) {
+    attribute->resize(count);
+  }
+  binning_.scatter(pool, [&](std::size_t i, std::uint32_t slot) {
+    order_[slot] = static_cast<std::uint32_t>(i);
+    x_[slot] = store.x[i];
+    y_[slot] = store.y[i];
+    vx_[slot] = store.vx[i];
+    vy_[slot] = store.vy[i];
+  });
+}
+
+}  // namespace app
@@ -0,0 +1,79 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_SPATIALGRID_HPP
+#define SFMLTEST_SPATIALGRID_HPP
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
+#include <vector>   // for vector
+
+#include "ParticleStore.hpp"         // for ParticleStore
+#include "detail/CountingSort.hpp"   // for CountingSort
+#include "detail/ThreadPool.hpp"     // for ThreadPool
+
+namespace app {
+
+/* Uniform grid over the canvas, rebuilt from scratch every step.
+ * build() bins particles with a parallel, stable CountingSort and keeps a
+ * cell-ordered copy of positions and velocities, so neighbour loops read
+ * contiguous memory. Particles of cell c occupy sorted slots
+ * [cellStart()[c], cellStart()[c + 1]); order()[slot] is the store index.
+ * Positions outside the canvas are clamped into the border cells.
+ * A row window restricts the grid to a band of the canvas: cells keep the
+ * place they have in the full grid, so rows are numbered from the first
+ * row of the window. */
+class SpatialGrid {
+ public:
+  void setCellSize(float cellSize);
+  void setBounds(float width, float height);
+  /* Restricts the grid to count rows from first; count 0 is the whole
+   * canvas */
+  void setRowWindow(std::size_t first, std::size_t count);
+  void reserve(std::size_t particles);
+
+  void build(const ParticleStore &store, ThreadPool &pool);
+
+  [[nodiscard]] float getCellSize() const { return cellSize_; }
+  [[nodiscard]] std::size_t getColumns() const { return columns_; }
+  [[nodiscard]] std::size_t getRows() const { return rows_; }
+  [[nodiscard]] std::size_t getFirstRow() const { return firstRow_; }
+  [[nodiscard]] std::size_t size() const { return order_.size(); }
+  [[nodiscard]] std::size_t cellOf(float x, float y) const;
+
+  [[nodiscard]] const std::vector<std::uint32_t> &cellStart() const {
+    return binning_.starts();
+  }
+  [[nodiscard]] const std::vector<std::uint32_t> &order() const {
+    return order_;
+  }
+  /* Particle attributes in cell order */
+  [[nodiscard]] const std::vector<float> &x() const { return x_; }
+  [[nodiscard]] const std::vector<float> &y() const { return y_; }
+  [[nodiscard]] const std::vector<float> &vx() const { return vx_; }
+  [[nodiscard]] const std::vector<float> &vy() const { return vy_; }
+
+ private:
+  void resizeCells();
+
+  float cellSize_{8.0F};
+  float width_{0};
+  float height_{0};
+  std::size_t columns_{0};
+  std::size_t rows_{0};
+  std::size_t windowFirst_{0}; /*< Requested row window */
+  std::size_t windowRows_{0};  /*< 0 = whole canvas */
+  std::size_t firstRow_{0};    /*< Canvas row of row 0 */
+
+  CountingSort binning_;             /*< Cell per particle, first slots */
+  std::vector<std::uint32_t> order_; /*< Store index per slot */
+  std::vector<float> x_;
+  std::vector<float> y_;
+  std::vector<float> vx_;
+  std::vector<float> vy_;
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_SPATIALGRID_HPP
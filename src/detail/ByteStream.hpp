@@ -0,0 +1,122 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_BYTESTREAM_HPP
+#define SFMLTEST_BYTESTREAM_HPP
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint8_t, uint64_t
+#include <cstring>      // for memcpy
+#include <type_traits>  // for is_trivially_copyable_v
+#include <vector>       // for vector
+
+namespace app {
+
+/* Appends values to a byte buffer. Plain values are stored as their
+ * in-memory bytes, little-endian on every supported target. */
+class ByteWriter {
+ public:
+  explicit ByteWriter(std::vector<std::uint8_t> &out) : out_(out) {}
+
+  template <typename T>
+  void put(const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const std::size_t at = out_.size();
+    out_.resize(at + sizeof(T));
+    std::memcpy(out_.data() + at, &value, sizeof(T));
+  }
+
+  /* LEB128: 7 bits per byte, small values take one byte */
+  void putVarint(std::uint64_t value) {
+    while (value >= 0x80U) {
+      out_.push_back(static_cast<std::uint8_t>(value | 0x80U));
+      value >>= 7U;
+    }
+    out_.push_back(static_cast<std::uint8_t>(value));
+  }
+
+  void putBytes(const void *data, std::size_t size) {
+    const auto *bytes = static_cast<const std::uint8_t *>(data);
+    out_.insert(out_.end(), bytes, bytes + size);
+  }
+
+  /* Zero bytes up to the next multiple of alignment */
+  void pad(std::size_t alignment) {
+    out_.resize((out_.size() + alignment - 1) / alignment * alignment);
+  }
+
+  [[nodiscard]] std::size_t size() const { return out_.size(); }
+
+ private:
+  std::vector<std::uint8_t> &out_;
+};
+
+/* Reads what ByteWriter wrote. Reading past the end fails and leaves the
+ * reader failed; callers check ok() once after a batch of reads. */
+class ByteReader {
+ public:
+  ByteReader(const std::uint8_t *data, std::size_t size)
+      : data_(data), size_(size) {}
+
+  template <typename T>
+  T get() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    T value{};
+    if (take(sizeof(T))) {
+      std::memcpy(&value, data_ + offset_ - sizeof(T), sizeof(T));
+    }
+    return value;
+  }
+
+  std::uint64_t getVarint() {
+    std::uint64_t value{0};
+    for (unsigned shift = 0; shift < 64U; shift += 7U) {
+      if (!take(1)) {
+        return 0;
+      }
+      const std::uint8_t byte = data_[offset_ - 1];
+      value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+      if ((byte & 0x80U) == 0) {
+        return value;
+      }
+    }
+    failed_ = true;
+    return 0;
+  }
+
+  void getBytes(void *data, std::size_t size) {
+    if (take(size)) {
+      std::memcpy(data, data_ + offset_ - size, size);
+    }
+  }
+
+  void skip(std::size_t size) { take(size); }
+  void seek(std::size_t offset) {
+    failed_ = failed_ || offset > size_;
+    offset_ = failed_ ? size_ : offset;
+  }
+
+  [[nodiscard]] bool ok() const { return !failed_; }
+  [[nodiscard]] bool atEnd() const { return offset_ >= size_; }
+  [[nodiscard]] std::size_t offset() const { return offset_; }
+
+ private:
+  bool take(std::size_t size) {
+    if (failed_ || size > size_ - offset_) {
+      failed_ = true;
+      return false;
+    }
+    offset_ += size;
+    return true;
+  }
+
+  const std::uint8_t *data_;
+  std::size_t size_;
+  std::size_t offset_{0};
+  bool failed_{false};
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_BYTESTREAM_HPP
@@ -0,0 +1,116 @@
+//
+// Created by Michael Wittmann on 18/10/2026.
+//
+
+#ifndef SFMLTEST_COUNTINGSORT_HPP
+#define SFMLTEST_COUNTINGSORT_HPP
+
+#include <algorithm>  // for clamp, min
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint32_t
+#include <vector>     // for vector
+
+#include "ThreadPool.hpp"  // for ThreadPool
+
+namespace app {
+
+/* Parallel, stable counting sort of items [0, count) into buckets.
+ * bin() splits the items into a few large blocks, histograms each block
+ * in parallel and turns the histograms into every block's first slot per
+ * bucket; scatter() then hands each item its slot, again in parallel.
+ * Bucket-major, block-minor offsets keep the items of a bucket in index
+ * order. Between the two, starts() already tells how the buckets fill,
+ * e.g. to skip a scatter that would change nothing. */
+class CountingSort {
+ public:
+  static constexpr std::uint32_t SKIP = ~std::uint32_t{0}; /*< No bucket */
+
+  void reserve(std::size_t items) { keys_.reserve(items); }
+
+  /* key(i) is the bucket of item i, or SKIP to leave it out */
+  template <typename Key>
+  void bin(std::size_t count, std::size_t buckets, ThreadPool &pool,
+           const Key &key);
+  /* Calls place(i, slot) once for every binned item */
+  template <typename Place>
+  void scatter(ThreadPool &pool, const Place &place);
+
+  /* Bucket b gets slots [starts()[b], starts()[b + 1]) */
+  [[nodiscard]] const std::vector<std::uint32_t> &starts() const {
+    return starts_;
+  }
+
+ private:
+  static constexpr std::size_t CHUNK = 16384; /*< Min items per block */
+
+  std::size_t count_{0};
+  std::size_t buckets_{0};
+  std::size_t blocks_{1};
+  std::size_t blockSize_{0};
+  std::vector<std::uint32_t> keys_;        /*< Bucket per item */
+  std::vector<std::uint32_t> blockCounts_; /*< [block][bucket] histogram */
+  std::vector<std::uint32_t> starts_;      /*< First slot per bucket */
+};
+
+/************************************************************/
+template <typename Key>
+void CountingSort::bin(std::size_t count, std::size_t buckets,
+                       ThreadPool &pool, const Key &key) {
+  count_ = count;
+  buckets_ = buckets;
+  /* Few large blocks: every block carries a full histogram */
+  blocks_ = std::clamp<std::size_t>((count + CHUNK - 1) / CHUNK, 1,
+                                    pool.concurrency() * 2);
+  blockSize_ = (count + blocks_ - 1) / blocks_;
+
+  keys_.resize(count);
+  blockCounts_.assign(blocks_ * buckets, 0);
+  pool.parallelFor(0, blocks_, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t block = first; block < last; ++block) {
+      std::uint32_t *counts = blockCounts_.data() + block * buckets;
+      const std::size_t end = std::min(count, (block + 1) * blockSize_);
+      for (std::size_t i = block * blockSize_; i < end; ++i) {
+        const std::uint32_t bucket = key(i);
+        keys_[i] = bucket;
+        if (bucket != SKIP) {
+          ++counts[bucket];
+        }
+      }
+    }
+  });
+
+  /* Exclusive prefix sum, bucket-major and block-minor */
+  starts_.resize(buckets + 1);
+  std::uint32_t running{0};
+  for (std::size_t bucket = 0; bucket < buckets; ++bucket) {
+    starts_[bucket] = running;
+    for (std::size_t block = 0; block < blocks_; ++block) {
+      std::uint32_t &slot = blockCounts_[block * buckets + bucket];
+      const std::uint32_t inBlock = slot;
+      slot = running;
+      running += inBlock;
+    }
+  }
+  starts_[buckets] = running;
+}
+
+/************************************************************/
+template <typename Place>
+void CountingSort::scatter(ThreadPool &pool, const Place &place) {
+  pool.parallelFor(0, blocks_, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t block = first; block < last; ++block) {
+      std::uint32_t *next = blockCounts_.data() + block * buckets_;
+      const std::size_t end = std::min(count_, (block + 1) * blockSize_);
+      for (std::size_t i = block * blockSize_; i < end; ++i) {
+        const std::uint32_t bucket = keys_[i];
+        if (bucket != SKIP) {
+          place(i, next[bucket]++);
+        }
+      }
+    }
+  });
+}
+
+}  // namespace app
+
+#endif  // SFMLTEST_COUNTINGSORT_HPP
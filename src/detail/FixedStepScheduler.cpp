@@ -0,0 +1,66 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "FixedStepScheduler.hpp"
+
+#include <cmath>  // for isfinite
+
+namespace app {
+
+FixedStepScheduler::FixedStepScheduler(float stepRate, sf::Uint32 maxSteps)
+    : maxSteps_(maxSteps) {
+  setStepRate(stepRate);
+}
+
+/************************************************************/
+void FixedStepScheduler::setStepRate(float stepRate) {
+  constexpr sf::Int64 second = 1000000;
+  /* Checked before the cast, which a zero, NaN or tiny rate overflows;
+   * any of them, and rates under 1 or above 1000000, run once a second */
+  const float micros = 1000000.0F / stepRate;
+  if (!(stepRate > 0.0F) || !std::isfinite(micros) || !(micros >= 1.0F) ||
+      micros > static_cast<float>(second)) {
+    step_ = sf::microseconds(second);
+    return;
+  }
+  step_ = sf::microseconds(static_cast<sf::Int64>(micros));
+}
+
+/************************************************************/
+sf::Uint32 FixedStepScheduler::advance(sf::Time elapsed) {
+  if (elapsed > sf::Time::Zero) {
+    accumulator_ += elapsed;
+  }
+  const sf::Int64 step = step_.asMicroseconds();
+  auto due = static_cast<sf::Uint64>(accumulator_.asMicroseconds() / step);
+  if (due > maxSteps_) {
+    /* Spiral-of-death clamp: forget what we cannot catch up on */
+    const sf::Time kept =
+        sf::microseconds(step * static_cast<sf::Int64>(maxSteps_));
+    dropped_ += accumulator_ - kept;
+    accumulator_ = kept;
+    due = maxSteps_;
+  }
+  accumulator_ -= sf::microseconds(step * static_cast<sf::Int64>(due));
+  steps_ += due;
+  return static_cast<sf::Uint32>(due);
+}
+
+/************************************************************/
+float FixedStepScheduler::getStepRate() const {
+  return 1.0F / step_.asSeconds();
+}
+
+/************************************************************/
+float FixedStepScheduler::getAlpha() const {
+  return static_cast<float>(accumulator_.asMicroseconds()) /
+         static_cast<float>(step_.asMicroseconds());
+}
+
+/************************************************************/
+sf::Time FixedStepScheduler::getTimeToNextStep() const {
+  return step_ - accumulator_;
+}
+
+}  // namespace app
@@ -0,0 +1,57 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_FIXEDSTEPSCHEDULER_HPP
+#define SFMLTEST_FIXEDSTEPSCHEDULER_HPP
+
+#include <SFML/Config.hpp>       // for Uint32
+#include <SFML/System/Time.hpp>  // for Time
+
+namespace app {
+
+/* Per-frame pacing counters */
+struct FrameStats {
+  sf::Uint32 simSteps{0}; /*< Steps simulated since the previous frame */
+  sf::Time droppedTime;   /*< Sim time dropped since the previous frame */
+  sf::Time simTime;       /*< Time spent simulating since the previous frame */
+  sf::Time renderTime;    /*< Time spent drawing the previous frame */
+};
+
+/* Accumulator-based fixed timestep.
+ * Real time is fed in with advance(), which hands back how many fixed steps
+ * are due. Time is kept in integer microseconds, so the step sequence does
+ * not drift. If more than maxSteps are due at once (the simulation cannot
+ * keep up), the surplus is dropped instead of being caught up later, which
+ * keeps a slow frame from snowballing. */
+class FixedStepScheduler {
+ public:
+  explicit FixedStepScheduler(float stepRate = 50.0F, sf::Uint32 maxSteps = 5);
+
+  void setStepRate(float stepRate); /*< Steps per second */
+  void setMaxSteps(sf::Uint32 maxSteps) { maxSteps_ = maxSteps; }
+
+  /* Feeds elapsed real time, returns the number of steps to run now */
+  sf::Uint32 advance(sf::Time elapsed);
+
+  [[nodiscard]] sf::Time getStep() const { return step_; }
+  [[nodiscard]] float getStepRate() const;
+  /* Fraction of a step accumulated but not yet simulated, in [0, 1) */
+  [[nodiscard]] float getAlpha() const;
+  [[nodiscard]] sf::Time getAccumulatedTime() const { return accumulator_; }
+  [[nodiscard]] sf::Time getTimeToNextStep() const;
+  /* Total time discarded by the catch-up clamp */
+  [[nodiscard]] sf::Time getDroppedTime() const { return dropped_; }
+  [[nodiscard]] sf::Uint64 getStepCount() const { return steps_; }
+
+ private:
+  sf::Time step_;        /*< Length of one fixed step */
+  sf::Time accumulator_; /*< Real time not simulated yet */
+  sf::Time dropped_;     /*< Real time never simulated */
+  sf::Uint32 maxSteps_;  /*< Catch-up clamp per advance() */
+  sf::Uint64 steps_{0};  /*< Steps handed out so far */
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_FIXEDSTEPSCHEDULER_HPP
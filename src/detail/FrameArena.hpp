@@ -0,0 +1,43 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_FRAMEARENA_HPP
+#define SFMLTEST_FRAMEARENA_HPP
+
+#include <cstddef>          // for byte, size_t
+#include <memory_resource>  // for monotonic_buffer_resource
+#include <vector>           // for vector
+
+namespace app {
+
+/* Scratch memory for one frame. Temporary containers of the frame loop
+ * allocate from a block reserved up front and are all released together
+ * by reset() at the end of the frame, so steady-state frames never reach
+ * the global heap. Requests beyond the block fall back to new/delete. */
+class FrameArena {
+ public:
+  static constexpr std::size_t DEFAULT_SIZE = std::size_t{1} << 20U;
+
+  explicit FrameArena(std::size_t bytes = DEFAULT_SIZE)
+      : storage_(bytes),
+        resource_(storage_.data(), storage_.size(),
+                  std::pmr::new_delete_resource()) {}
+  FrameArena(const FrameArena &) = delete;
+  FrameArena(FrameArena &&) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+  FrameArena &operator=(FrameArena &&) = delete;
+  ~FrameArena() = default;
+
+  [[nodiscard]] std::pmr::memory_resource *resource() { return &resource_; }
+  /* Frees everything allocated this frame; the block is reused */
+  void reset() { resource_.release(); }
+
+ private:
+  std::vector<std::byte> storage_;
+  std::pmr::monotonic_buffer_resource resource_;
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_FRAMEARENA_HPP
@@ -0,0 +1,65 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_HALF_HPP
+#define SFMLTEST_HALF_HPP
+
+#include <bit>      // for bit_cast
+#include <cstdint>  // for uint16_t, uint32_t
+
+namespace app {
+
+/* IEEE 754 binary16 conversions in plain integer arithmetic, so they build
+ * anywhere. Every case is computed and the right one selected, so loops
+ * over them vectorise (given -fno-trapping-math). Zeros, subnormals,
+ * infinities and NaN are handled; toHalf rounds to nearest even. After
+ * Fabian Giesen's float/half routines. */
+
+[[nodiscard]] inline float fromHalf(std::uint16_t half) {
+  constexpr std::uint32_t shiftedExp = 0x7C00U << 13U;
+  constexpr std::uint32_t magic = 113U << 23U;
+  const auto bits = static_cast<std::uint32_t>(half);
+  const std::uint32_t exp = (bits << 13U) & shiftedExp;
+  const std::uint32_t normal =
+      ((bits & 0x7FFFU) << 13U) + ((127U - 15U) << 23U);
+  /* Infinity and NaN keep the maximum exponent */
+  const std::uint32_t special = normal + ((128U - 16U) << 23U);
+  /* Subnormals are renormalized through the FPU */
+  const std::uint32_t subnormal =
+      std::bit_cast<std::uint32_t>(std::bit_cast<float>(normal + (1U << 23U)) -
+                                   std::bit_cast<float>(magic));
+  const std::uint32_t out = exp == shiftedExp ? special
+                            : exp == 0        ? subnormal
+                                              : normal;
+  return std::bit_cast<float>(out | ((bits & 0x8000U) << 16U));
+}
+
+[[nodiscard]] inline std::uint16_t toHalf(float value) {
+  constexpr std::uint32_t infinity = 255U << 23U;
+  constexpr std::uint32_t overflow = (127U + 16U) << 23U;
+  constexpr std::uint32_t smallest = (127U - 14U) << 23U;
+  constexpr std::uint32_t denormMagic = ((127U - 15U) + (23U - 10U) + 1U)
+                                        << 23U;
+  const std::uint32_t raw = std::bit_cast<std::uint32_t>(value);
+  const std::uint32_t bits = raw & 0x7FFFFFFFU;
+  /* Too large: infinity, NaN stays quiet NaN */
+  const std::uint32_t special = bits > infinity ? 0x7E00U : 0x7C00U;
+  /* Too small for a normal half: the addition shifts the mantissa into
+   * place and rounds it */
+  const std::uint32_t subnormal =
+      std::bit_cast<std::uint32_t>(std::bit_cast<float>(bits) +
+                                   std::bit_cast<float>(denormMagic)) -
+      denormMagic;
+  /* Rebias the exponent, round the mantissa to nearest even */
+  const std::uint32_t normal =
+      (bits + ((15U - 127U) << 23U) + 0xFFFU + ((bits >> 13U) & 1U)) >> 13U;
+  const std::uint32_t out = bits >= overflow  ? special
+                            : bits < smallest ? subnormal
+                                              : normal;
+  return static_cast<std::uint16_t>(out | ((raw >> 16U) & 0x8000U));
+}
+
+}  // namespace app
+
+#endif  // SFMLTEST_HALF_HPP
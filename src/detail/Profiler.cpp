@@ -0,0 +1,220 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "Profiler.hpp"
+
+#include <algorithm>  // for min, sort
+#include <chrono>     // for steady_clock, duration_cast
+#include <cmath>      // for ceil
+#include <cstddef>    // for ptrdiff_t
+#include <fstream>    // for ofstream
+#include <iomanip>    // for setprecision
+#include <map>        // for map
+
+namespace app {
+std::vector<Scope<ProfileRing>> Profiler::rings_;
+std::vector<ProfileRing *> Profiler::free_;
+std::mutex Profiler::mutex_;
+}  // namespace app
+
+namespace app {
+
+namespace {
+const auto epoch = std::chrono::steady_clock::now();
+thread_local ProfileRing *tlsRing = nullptr; /*< Ring of this thread */
+
+/* Nearest-rank percentile of sorted durations, in microseconds */
+double percentile(const std::pmr::vector<std::int64_t> &sorted, double p) {
+  const auto rank = static_cast<std::size_t>(
+      std::ceil(p * static_cast<double>(sorted.size())));
+  const std::size_t index = rank == 0 ? 0 : rank - 1;
+  return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+/* Phase names are literals, only quotes and backslashes need escaping */
+void writeJsonString(std::ofstream &out, const char *text) {
+  out << '"';
+  for (const char *c = text; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\';
+    }
+    out << *c;
+  }
+  out << '"';
+}
+}  // namespace
+
+/************************************************************/
+void ProfileRing::push(const char *name, std::int64_t begin,
+                       std::int64_t end) {
+  const std::uint64_t index = head_.load(std::memory_order_relaxed);
+  claimed_.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  Slot &slot = slots_[index % CAPACITY];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.begin.store(begin, std::memory_order_relaxed);
+  slot.end.store(end, std::memory_order_relaxed);
+  head_.store(index + 1, std::memory_order_release);
+}
+
+/************************************************************/
+void ProfileRing::read(std::pmr::vector<ProfileEvent> &out) const {
+  const std::uint64_t head = head_.load(std::memory_order_acquire);
+  const std::uint64_t first = head > CAPACITY ? head - CAPACITY : 0;
+  const std::size_t start = out.size();
+  for (std::uint64_t i = first; i < head; ++i) {
+    const Slot &slot = slots_[i % CAPACITY];
+    out.push_back({slot.name.load(std::memory_order_relaxed),
+                   slot.begin.load(std::memory_order_relaxed),
+                   slot.end.load(std::memory_order_relaxed), thread_});
+  }
+  /* Slots below claimed - CAPACITY may have been rewritten during the copy */
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const std::uint64_t claimed = claimed_.load(std::memory_order_relaxed);
+  if (claimed > first + CAPACITY) {
+    const auto stale = static_cast<std::ptrdiff_t>(
+        std::min<std::uint64_t>(claimed - CAPACITY - first, head - first));
+    out.erase(out.begin() + static_cast<std::ptrdiff_t>(start),
+              out.begin() + static_cast<std::ptrdiff_t>(start) + stale);
+  }
+}
+
+/************************************************************/
+std::int64_t Profiler::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch)
+      .count();
+}
+
+/************************************************************/
+class Profiler::Lease {
+ public:
+  Lease() = default;
+  Lease(const Lease &) = delete;
+  Lease &operator=(const Lease &) = delete;
+  ~Lease() {
+    if (ring != nullptr) {
+      tlsRing = nullptr;
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_.push_back(ring);
+    }
+  }
+
+  ProfileRing *ring{nullptr};
+};
+
+/************************************************************/
+ProfileRing &Profiler::threadRing() {
+  if (tlsRing == nullptr) {
+    /* First event of this thread. A finished thread's ring is handed on,
+     * so short-lived threads such as the capture writers do not add a
+     * ring each; its events stay visible to the exporter until the new
+     * owner overwrites them */
+    thread_local Lease lease;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+      rings_.push_back(create_scope<ProfileRing>(
+          static_cast<std::uint32_t>(rings_.size())));
+      lease.ring = rings_.back().get();
+    } else {
+      lease.ring = free_.back();
+      free_.pop_back();
+      lease.ring->setName(nullptr);
+    }
+    tlsRing = lease.ring;
+  }
+  return *tlsRing;
+}
+
+/************************************************************/
+void Profiler::record(const char *name, std::int64_t begin,
+                      std::int64_t end) {
+  threadRing().push(name, begin, end);
+}
+
+/************************************************************/
+void Profiler::setThreadName(const char *name) { threadRing().setName(name); }
+
+/************************************************************/
+std::pmr::vector<ProfileEvent> Profiler::events(
+    std::pmr::memory_resource *resource) {
+  std::pmr::vector<ProfileEvent> out{resource};
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &ring : rings_) {
+    ring->read(out);
+  }
+  return out;
+}
+
+/************************************************************/
+std::pmr::vector<PhaseStats> Profiler::summary(
+    std::pmr::memory_resource *resource) {
+  std::pmr::map<std::string_view, std::pmr::vector<std::int64_t>> durations{
+      resource};
+  {
+    /* One ring at a time keeps the copy small */
+    std::pmr::vector<ProfileEvent> events{resource};
+    events.reserve(ProfileRing::CAPACITY);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &ring : rings_) {
+      events.clear();
+      ring->read(events);
+      for (const auto &event : events) {
+        if (event.name != nullptr) {
+          durations[event.name].push_back(event.end - event.begin);
+        }
+      }
+    }
+  }
+  std::pmr::vector<PhaseStats> stats{resource};
+  stats.reserve(durations.size());
+  for (auto &[name, phase] : durations) {
+    std::sort(phase.begin(), phase.end());
+    stats.push_back({name, phase.size(), percentile(phase, 0.50),
+                     percentile(phase, 0.95), percentile(phase, 0.99)});
+  }
+  return stats;
+}
+
+/************************************************************/
+bool Profiler::exportChromeTrace(const std::string &path) {
+  std::ofstream out{path};
+  if (!out) {
+    return false;
+  }
+  /* Complete ("X") events, timestamps in microseconds */
+  out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto &event : events()) {
+    if (event.name == nullptr) {
+      continue;
+    }
+    out << (first ? "\n" : ",\n") << "{\"name\":";
+    writeJsonString(out, event.name);
+    const auto duration = event.end - event.begin;
+    out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+        << ",\"ts\":" << static_cast<double>(event.begin) / 1000.0
+        << ",\"dur\":" << static_cast<double>(duration) / 1000.0 << '}';
+    first = false;
+  }
+  /* Thread names as metadata events */
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &ring : rings_) {
+      if (ring->name() == nullptr) {
+        continue;
+      }
+      out << (first ? "\n" : ",\n")
+          << R"({"name":"thread_name","ph":"M","pid":1,"tid":)"
+          << ring->thread() << R"(,"args":{"name":)";
+      writeJsonString(out, ring->name());
+      out << "}}";
+      first = false;
+    }
+  }
+  out << "\n]}\n";
+  return static_cast<bool>(out);
+}
+
+}  // namespace app
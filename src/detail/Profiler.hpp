@@ -0,0 +1,132 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_PROFILER_HPP
+#define SFMLTEST_PROFILER_HPP
+
+#include <array>            // for array
+#include <atomic>           // for atomic
+#include <cstddef>          // for size_t
+#include <cstdint>          // for int64_t, uint64_t, uint32_t
+#include <memory_resource>  // for memory_resource, polymorphic_allocator
+#include <mutex>            // for mutex
+#include <string>           // for string
+#include <string_view>      // for string_view
+#include <vector>           // for vector
+
+#include "Core.hpp"  // for Scope
+
+/* Scoped timers. With APP_PROFILE undefined (ENABLE_PROFILING=OFF) they
+ * expand to nothing; names must be string literals or __func__ */
+#ifdef APP_PROFILE
+#define APP_PROFILE_CONCAT_(a, b) a##b
+#define APP_PROFILE_CONCAT(a, b) APP_PROFILE_CONCAT_(a, b)
+#define APP_PROFILE_SCOPE(name) \
+  const ::app::ProfileScope APP_PROFILE_CONCAT(profileScope, __LINE__) { name }
+#define APP_PROFILE_FUNCTION() APP_PROFILE_SCOPE(__func__)
+#define APP_PROFILE_THREAD(name) ::app::Profiler::setThreadName(name)
+#else
+#define APP_PROFILE_SCOPE(name)
+#define APP_PROFILE_FUNCTION()
+#define APP_PROFILE_THREAD(name)
+#endif
+
+namespace app {
+
+/* One timed scope, times in nanoseconds since program start */
+struct ProfileEvent {
+  const char *name{nullptr};
+  std::int64_t begin{0};
+  std::int64_t end{0};
+  std::uint32_t thread{0}; /*< Index of the recording thread */
+};
+
+/* Percentiles of one phase over the events still held in the rings */
+struct PhaseStats {
+  std::string_view name; /*< The literal passed to APP_PROFILE_SCOPE */
+  std::size_t count{0};
+  double p50{0}; /*< Microseconds */
+  double p95{0};
+  double p99{0};
+};
+
+/* Single-writer ring of the newest events of one thread. The owner never
+ * blocks; readers copy the slots and drop whatever the owner overwrote
+ * meanwhile (seqlock style), so a snapshot is never torn */
+class ProfileRing {
+ public:
+  static constexpr std::size_t CAPACITY = 4096;
+
+  explicit ProfileRing(std::uint32_t thread) : thread_(thread) {}
+
+  void push(const char *name, std::int64_t begin, std::int64_t end);
+  /* Appends the held events, oldest first */
+  void read(std::pmr::vector<ProfileEvent> &out) const;
+
+  [[nodiscard]] std::uint32_t thread() const { return thread_; }
+  [[nodiscard]] const char *name() const { return name_; }
+  void setName(const char *name) { name_ = name; }
+
+ private:
+  struct Slot {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<std::int64_t> begin{0};
+    std::atomic<std::int64_t> end{0};
+  };
+
+  std::array<Slot, CAPACITY> slots_;
+  std::atomic<std::uint64_t> claimed_{0}; /*< Writes started */
+  std::atomic<std::uint64_t> head_{0};    /*< Writes finished */
+  std::uint32_t thread_;
+  std::atomic<const char *> name_{nullptr}; /*< Trace thread name */
+};
+
+/* Process-wide collection of per-thread rings */
+class Profiler {
+ public:
+  /* Nanoseconds since program start */
+  static std::int64_t now();
+  static void record(const char *name, std::int64_t begin, std::int64_t end);
+  static void setThreadName(const char *name);
+
+  /* Events of all threads currently held in the rings */
+  static std::pmr::vector<ProfileEvent> events(
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+  /* Rolling p50/p95/p99 per phase, sorted by name. All temporaries come
+   * from resource, so a frame arena keeps this off the heap */
+  static std::pmr::vector<PhaseStats> summary(
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+  /* Writes the held events as Chrome trace_event JSON (chrome://tracing,
+   * Perfetto); returns false if the file cannot be written */
+  static bool exportChromeTrace(const std::string &path);
+
+ private:
+  class Lease; /*< Returns a thread's ring to free_ when the thread exits */
+
+  static ProfileRing &threadRing();
+
+  static std::vector<Scope<ProfileRing>> rings_;
+  static std::vector<ProfileRing *> free_; /*< Rings of finished threads */
+  static std::mutex mutex_; /*< Guards rings_ and free_, not the rings */
+};
+
+/* RAII timer behind APP_PROFILE_SCOPE */
+class ProfileScope {
+ public:
+  explicit ProfileScope(const char *name)
+      : name_(name), begin_(Profiler::now()) {}
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope(ProfileScope &&) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+  ProfileScope &operator=(ProfileScope &&) = delete;
+  ~ProfileScope() { Profiler::record(name_, begin_, Profiler::now()); }
+
+ private:
+  const char *name_;
+  std::int64_t begin_;
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_PROFILER_HPP
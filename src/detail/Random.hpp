@@ -0,0 +1,63 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_RANDOM_HPP
+#define SFMLTEST_RANDOM_HPP
+
+#include <cstdint>  // for uint32_t, uint64_t
+
+namespace app {
+
+/* Counter-based random number generator (Widynski's "Squares").
+ * Output depends only on (key, counter), so any range of counters can be
+ * generated independently - e.g. on different threads - and the result is
+ * bit-identical to a sequential run with the same seed. */
+class CounterRng {
+ public:
+  constexpr CounterRng() : key_(makeKey(0)) {}
+  constexpr explicit CounterRng(std::uint64_t seed) : key_(makeKey(seed)) {}
+
+  [[nodiscard]] constexpr std::uint32_t operator()(
+      std::uint64_t counter) const {
+    std::uint64_t x = counter * key_;
+    const std::uint64_t y = x;
+    const std::uint64_t z = y + key_;
+    x = x * x + y;
+    x = (x >> 32U) | (x << 32U);
+    x = x * x + z;
+    x = (x >> 32U) | (x << 32U);
+    x = x * x + y;
+    x = (x >> 32U) | (x << 32U);
+    return static_cast<std::uint32_t>((x * x + z) >> 32U);
+  }
+
+  /* Uniform float in [0, 1) with 24 bits of precision */
+  [[nodiscard]] constexpr float uniform(std::uint64_t counter) const {
+    constexpr float scale = 1.0F / 16777216.0F;
+    return static_cast<float>((*this)(counter) >> 8U) * scale;
+  }
+
+  /* Uniform float in [lo, hi) */
+  [[nodiscard]] constexpr float uniform(std::uint64_t counter, float lo,
+                                        float hi) const {
+    return lo + (hi - lo) * uniform(counter);
+  }
+
+  [[nodiscard]] constexpr std::uint64_t key() const { return key_; }
+
+ private:
+  /* splitmix64 finalizer; the key must be odd to keep the sequence full */
+  static constexpr std::uint64_t makeKey(std::uint64_t seed) {
+    std::uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+    return (z ^ (z >> 31U)) | 1U;
+  }
+
+  std::uint64_t key_;
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_RANDOM_HPP
@@ -0,0 +1,72 @@
+//
+// Created by Michael Wittmann on 18/10/2026.
+//
+
+#ifndef SFMLTEST_SPSCQUEUE_HPP
+#define SFMLTEST_SPSCQUEUE_HPP
+
+#include <algorithm>  // for max
+#include <atomic>     // for atomic
+#include <bit>        // for bit_ceil
+#include <cstddef>    // for size_t
+#include <vector>     // for vector
+
+namespace app {
+
+/* Lock-free single-producer/single-consumer FIFO over a preallocated ring.
+ * One thread push()es, another pop()s; neither ever waits or allocates,
+ * and a full queue refuses the value rather than blocking. Each side keeps
+ * a cached copy of the other's index, so the shared cache lines are only
+ * touched when the cache runs out. */
+template <typename T>
+class SpscQueue {
+ public:
+  /* Room for at least capacity values, rounded up to a power of two */
+  explicit SpscQueue(std::size_t capacity)
+      : slots_(std::bit_ceil(std::max<std::size_t>(capacity, 1))),
+        mask_(slots_.size() - 1) {}
+
+  /* Producer side; returns false, queueing nothing, when full */
+  bool push(const T &value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - headCache_ == slots_.size()) {
+      headCache_ = head_.load(std::memory_order_acquire);
+      if (tail - headCache_ == slots_.size()) {
+        return false;
+      }
+    }
+    slots_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /* Consumer side; returns false when empty */
+  bool pop(T &out) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tailCache_) {
+      tailCache_ = tail_.load(std::memory_order_acquire);
+      if (head == tailCache_) {
+        return false;
+      }
+    }
+    out = slots_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  [[nodiscard]] std::size_t capacity() const { return slots_.size(); }
+
+ private:
+  static constexpr std::size_t CACHE_LINE = 64;
+
+  std::vector<T> slots_;
+  std::size_t mask_;
+  alignas(CACHE_LINE) std::atomic<std::size_t> head_{0}; /*< Next to pop */
+  std::size_t tailCache_{0}; /*< Owned by the consumer */
+  alignas(CACHE_LINE) std::atomic<std::size_t> tail_{0}; /*< Next to push */
+  std::size_t headCache_{0}; /*< Owned by the producer */
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_SPSCQUEUE_HPP
@@ -0,0 +1,181 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>  // for max
+
+#include "Profiler.hpp"  // for APP_PROFILE_SCOPE, APP_PROFILE_THREAD
+
+namespace app {
+Scope<ThreadPool> ThreadPool::instance_;
+std::mutex ThreadPool::instanceMutex_;
+}  // namespace app
+
+namespace app {
+
+namespace {
+thread_local const ThreadPool *tlsPool = nullptr; /*< Pool of this worker */
+thread_local std::size_t tlsQueue = 0;            /*< Queue of this worker */
+}  // namespace
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  const std::size_t total =
+      threads == 0
+          ? std::max<std::size_t>(1, std::thread::hardware_concurrency())
+          : threads;
+  /* The thread calling parallelFor always helps, so spawn one less */
+  const std::size_t workers = total - 1;
+  for (std::size_t i = 0; i <= workers; ++i) {
+    queues_.push_back(create_scope<WorkQueue>());
+  }
+  workers_.reserve(workers);
+  for (std::size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back([this, i]() { workerLoop(i); });
+  }
+}
+
+/************************************************************/
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stop_ = true;
+  }
+  wakeUp_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+/************************************************************/
+void ThreadPool::Initialize(std::size_t threads) {
+  std::lock_guard<std::mutex> lock(instanceMutex_);
+  if (instance_ == nullptr) {
+    instance_ = create_scope<ThreadPool>(threads);
+  }
+}
+
+/************************************************************/
+ThreadPool &ThreadPool::instance() {
+  std::lock_guard<std::mutex> lock(instanceMutex_);
+  if (instance_ == nullptr) {
+    instance_ = create_scope<ThreadPool>();
+  }
+  return *instance_;
+}
+
+/************************************************************/
+std::size_t ThreadPool::currentQueue() const {
+  /* Threads outside the pool share the last queue */
+  return tlsPool == this ? tlsQueue : workers_.size();
+}
+
+/************************************************************/
+void ThreadPool::run(Task task) {
+  std::atomic<std::size_t> remaining{task.end - task.begin};
+  task.remaining = &remaining;
+  const std::size_t queue = currentQueue();
+  execute(task, queue);
+  /* Help out until every piece of this job has finished */
+  while (remaining.load(std::memory_order_acquire) != 0) {
+    if (!tryRunOne(queue)) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+/************************************************************/
+void ThreadPool::execute(Task task, std::size_t queue) {
+  /* Split off upper halves for thieves, keep the lower half */
+  while (task.end - task.begin > task.grain) {
+    Task upper = task;
+    upper.begin = task.begin + (task.end - task.begin) / 2;
+    if (!queues_[queue]->pushBack(upper)) {
+      break; /* Queue full, run the rest inline */
+    }
+    task.end = upper.begin;
+    queuedTasks_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+      {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+      }
+      wakeUp_.notify_one();
+    }
+  }
+  {
+    APP_PROFILE_SCOPE("ThreadPool::task");
+    task.run(task.body, task.begin, task.end);
+  }
+  task.remaining->fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+}
+
+/************************************************************/
+bool ThreadPool::tryRunOne(std::size_t queue) {
+  Task task;
+  bool found = queues_[queue]->popBack(task);
+  for (std::size_t i = 1; !found && i < queues_.size(); ++i) {
+    found = queues_[(queue + i) % queues_.size()]->popFront(task);
+  }
+  if (!found) {
+    return false;
+  }
+  queuedTasks_.fetch_sub(1, std::memory_order_acq_rel);
+  execute(task, queue);
+  return true;
+}
+
+/************************************************************/
+void ThreadPool::workerLoop(std::size_t index) {
+  tlsPool = this;
+  tlsQueue = index;
+  APP_PROFILE_THREAD("pool worker");
+  while (!stop_.load(std::memory_order_acquire)) {
+    if (tryRunOne(index)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+    wakeUp_.wait(lock, [this]() {
+      return stop_.load(std::memory_order_acquire) ||
+             queuedTasks_.load(std::memory_order_seq_cst) > 0;
+    });
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+/************************************************************/
+bool ThreadPool::WorkQueue::pushBack(const Task &task) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (count == CAPACITY) {
+    return false;
+  }
+  ring[(head + count) % CAPACITY] = task;
+  ++count;
+  return true;
+}
+
+/************************************************************/
+bool ThreadPool::WorkQueue::popBack(Task &task) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (count == 0) {
+    return false;
+  }
+  --count;
+  task = ring[(head + count) % CAPACITY];
+  return true;
+}
+
+/************************************************************/
+bool ThreadPool::WorkQueue::popFront(Task &task) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (count == 0) {
+    return false;
+  }
+  task = ring[head];
+  head = (head + 1) % CAPACITY;
+  --count;
+  return true;
+}
+
+}  // namespace app
@@ -0,0 +1,111 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_THREADPOOL_HPP
+#define SFMLTEST_THREADPOOL_HPP
+
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <mutex>               // for mutex
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+#include "Core.hpp"  // for Scope
+
+namespace app {
+
+/* Persistent pool of worker threads with one work-stealing deque each.
+ * Owners pop their newest task, idle workers steal the oldest (largest)
+ * task of a sibling. Tasks are plain structs held in fixed-size rings, so
+ * scheduling never touches the heap. */
+class ThreadPool {
+ public:
+  /* threads = 0 sizes the pool from std::thread::hardware_concurrency() */
+  explicit ThreadPool(std::size_t threads = 0);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ThreadPool &operator=(ThreadPool &&) = delete;
+  ~ThreadPool();
+
+  /* Shared pool; Initialize() may be called once up front to override the
+   * thread count, otherwise the pool is created on first use */
+  static void Initialize(std::size_t threads = 0);
+  static ThreadPool &instance();
+
+  /* Threads taking part in a parallelFor, including the caller */
+  [[nodiscard]] std::size_t concurrency() const { return workers_.size() + 1; }
+
+  /* Runs body(first, last) over disjoint sub-ranges of [begin, end), split
+   * in halves down to grain, and returns once all of them are done. The
+   * calling thread helps, so nested calls from inside a task are fine. */
+  template <typename Body>
+  void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                   const Body &body) {
+    if (begin >= end) {
+      return;
+    }
+    if (workers_.empty() || end - begin <= grain) {
+      body(begin, end);
+      return;
+    }
+    Task task;
+    task.run = [](const void *fn, std::size_t first, std::size_t last) {
+      (*static_cast<const Body *>(fn))(first, last);
+    };
+    task.body = &body;
+    task.begin = begin;
+    task.end = end;
+    task.grain = grain == 0 ? 1 : grain;
+    run(task);
+  }
+
+ private:
+  using RunFn = void (*)(const void *body, std::size_t begin,
+                         std::size_t end);
+  struct Task {
+    RunFn run{nullptr};
+    const void *body{nullptr};
+    std::size_t begin{0};
+    std::size_t end{0};
+    std::size_t grain{1};
+    std::atomic<std::size_t> *remaining{nullptr}; /*< Items left in job */
+  };
+
+  /* Fixed-capacity deque guarded by a mutex; owner uses the back,
+   * thieves take from the front */
+  struct WorkQueue {
+    static constexpr std::size_t CAPACITY = 256;
+    std::mutex mutex;
+    std::vector<Task> ring = std::vector<Task>(CAPACITY);
+    std::size_t head{0}; /*< Oldest task */
+    std::size_t count{0};
+
+    bool pushBack(const Task &task);
+    bool popBack(Task &task);
+    bool popFront(Task &task);
+  };
+
+  void run(Task task);
+  void execute(Task task, std::size_t queue);
+  bool tryRunOne(std::size_t queue);
+  void workerLoop(std::size_t index);
+  [[nodiscard]] std::size_t currentQueue() const;
+
+  std::vector<Scope<WorkQueue>> queues_; /*< One per worker + external */
+  std::vector<std::thread> workers_;
+  std::atomic<std::size_t> queuedTasks_{0};
+  std::atomic<std::size_t> sleepers_{0}; /*< Workers waiting on wakeUp_ */
+  std::atomic<bool> stop_{false};
+  std::mutex sleepMutex_;
+  std::condition_variable wakeUp_;
+
+  static Scope<ThreadPool> instance_;
+  static std::mutex instanceMutex_;
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_THREADPOOL_HPP
@@ -0,0 +1,53 @@
+//
+// Created by Michael Wittmann on 17/10/2026.
+//
+
+#ifndef SFMLTEST_TRIPLEBUFFER_HPP
+#define SFMLTEST_TRIPLEBUFFER_HPP
+
+#include <array>    // for array
+#include <atomic>   // for atomic
+#include <cstdint>  // for uint8_t
+
+namespace app {
+
+/* Lock-free single-producer/single-consumer triple buffer.
+ * The writer fills back() and publish()es it; the reader calls update() to
+ * pick up the newest published value and reads front(). Neither side ever
+ * waits, and the reader always sees the latest complete value. */
+template <typename T>
+class TripleBuffer {
+ public:
+  /* Writer side */
+  T &back() { return buffers_[back_]; }
+  void publish() {
+    back_ = static_cast<std::uint8_t>(
+        middle_.exchange(static_cast<std::uint8_t>(back_ | FRESH),
+                         std::memory_order_acq_rel) &
+        INDEX);
+  }
+
+  /* Reader side; returns true if a newer value was picked up */
+  bool update() {
+    if ((middle_.load(std::memory_order_relaxed) & FRESH) == 0) {
+      return false;
+    }
+    front_ = static_cast<std::uint8_t>(
+        middle_.exchange(front_, std::memory_order_acq_rel) & INDEX);
+    return true;
+  }
+  const T &front() const { return buffers_[front_]; }
+
+ private:
+  static constexpr std::uint8_t INDEX = 0x3;
+  static constexpr std::uint8_t FRESH = 0x4; /*< Middle not yet read */
+
+  std::array<T, 3> buffers_{};
+  std::uint8_t front_{0};               /*< Owned by the reader */
+  std::atomic<std::uint8_t> middle_{1}; /*< Shared, index | FRESH */
+  std::uint8_t back_{2};                /*< Owned by the writer */
+};
+
+}  // namespace app
+
+#endif  // SFMLTEST_TRIPLEBUFFER_HPP
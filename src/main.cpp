@@ -2,9 +2,29 @@
 // Created by Michael Wittmann on 05/06/2020.
 //
 
+#include <spdlog/fmt/fmt.h>  // for print
+
+#include <cstdio>  // for stderr, stdout
+#include <string>  // for string
+
 #include "App.hpp"
+#include "Headless.hpp"  // for HeadlessOptions, runHeadless
 
-int main() {
+int main(int argc, char *argv[]) {
+  app::HeadlessOptions options;
+  std::string error;
+  if (!app::parseCommandLine(argc, argv, options, error)) {
+    fmt::print(stderr, "{}\n{}", error, app::commandLineUsage());
+    return 1;
+  }
+  if (options.help) {
+    fmt::print(stdout, "{}", app::commandLineUsage());
+    return 0;
+  }
+  /* No window, font or GL context: runs on CI and batch machines */
+  if (options.headless) {
+    return app::runHeadless(options);
+  }
   app::App application;
   return application.Run();
 }
@@ -0,0 +1,67 @@
+//
+// Created by Michael Wittmann on 18/10/2026.
+//
+
+#ifndef SFMLTEST_TESTPARTICLES_HPP
+#define SFMLTEST_TESTPARTICLES_HPP
+
+#include <SFML/Config.hpp>          // for Uint8
+#include <SFML/Graphics/Color.hpp>  // for Color
+#include <SFML/System/Vector2.hpp>  // for Vector2f, Vector2u
+#include <cstddef>                  // for size_t
+#include <cstdint>                  // for uint64_t
+
+#include "KernelFeatures.hpp"     // for BoundsMode
+#include "ParticleStore.hpp"      // for ParticleStore
+#include "ParticleSystem.hpp"     // for ParticleSystem
+#include "detail/Random.hpp"      // for CounterRng
+#include "detail/ThreadPool.hpp"  // for ThreadPool
+
+namespace app::test {
+
+/* Area particles are scattered over, may reach past the canvas */
+struct Bounds {
+  float left{0};
+  float top{0};
+  float right{0};
+  float bottom{0};
+};
+
+/* count particles spread evenly over bounds, velocities in [-speed,
+ * speed], lifetimes in [0.5, 2] seconds of which 30% have passed, and a
+ * red channel that tells them apart. The same seed gives the same
+ * particles. */
+inline ParticleStore scatter(std::size_t count, std::uint64_t seed,
+                             const Bounds &bounds, float speed = 1.0F) {
+  const CounterRng rng{seed};
+  ParticleStore store;
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint64_t counter = i * 5;
+    store.push(sf::Vector2f{rng.uniform(counter, bounds.left, bounds.right),
+                            rng.uniform(counter + 1, bounds.top,
+                                        bounds.bottom)},
+               sf::Vector2f{rng.uniform(counter + 2, -speed, speed),
+                            rng.uniform(counter + 3, -speed, speed)},
+               sf::Color{static_cast<sf::Uint8>(i), 20, 30, 40},
+               rng.uniform(counter + 4, 0.5F, 2.0F));
+    store.age.back() = store.lifetime.back() * 0.3F;
+  }
+  return store;
+}
+
+/* Seeded system on pool, falling down a canvas that wraps around; a
+ * bounce one step apart would send a particle off in another direction,
+ * wrapping keeps positions of runs that are compared continuous */
+inline ParticleSystem wrappingSystem(ThreadPool &pool, sf::Vector2u canvas,
+                                     std::uint64_t seed, float gravity) {
+  ParticleSystem system{canvas};
+  system.setThreadPool(pool);
+  system.setSeed(seed);
+  system.setBoundsMode(BoundsMode::WRAP);
+  system.setGravity(0.0F, gravity);
+  return system;
+}
+
+}  // namespace app::test
+
+#endif  // SFMLTEST_TESTPARTICLES_HPP
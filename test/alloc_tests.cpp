@@ -0,0 +1,126 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "PairForce.hpp"
+#include "ParticleSnapshot.hpp"
+#include "ParticleSystem.hpp"
+#include "detail/FrameArena.hpp"
+#include "detail/Profiler.hpp"
+
+/* Global operator new is replaced for this whole executable, so it is
+ * built on its own instead of being part of the tests target. Over-aligned
+ * types are not counted; the frame loop has none. */
+namespace {
+std::atomic<bool> counting{false};
+std::atomic<std::size_t> allocations{0};
+
+void *allocate(std::size_t size) {
+  if (counting.load(std::memory_order_relaxed)) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+
+/* Heap allocations made by body, on any thread */
+template <typename Body>
+std::size_t countAllocations(const Body &body) {
+  allocations = 0;
+  counting = true;
+  body();
+  counting = false;
+  return allocations.load();
+}
+}  // namespace
+
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+TEST_CASE("Steady-state frames do not allocate", "[alloc]") {
+  constexpr std::size_t capacity = 50000;
+  app::ParticleSystem system{sf::Vector2u{800, 600}};
+  system.setSeed(3);
+  system.setCapacity(capacity);
+  system.setOverflowPolicy(app::OverflowPolicy::RECYCLE_OLDEST);
+  system.setDissolve();
+  app::ParticleSnapshot snapshot;
+  std::vector<sf::Vertex> vertices;
+  app::FrameArena arena;
+  std::size_t phases{0};
+
+  /* What the sim and render threads do per frame, plus the HUD's once a
+   * second profiler summary */
+  const auto frame = [&]() {
+    const app::ProfileScope scope{"frame"};
+    system.emit(2000);
+    system.update(0.02F);
+    system.snapshot(snapshot);
+    snapshot.interpolate(0.5F, vertices);
+    phases = app::Profiler::summary(arena.resource()).size();
+    arena.reset();
+  };
+
+  /* Warm up until the pool is full and every buffer has its final size */
+  for (int i = 0; i < 60; ++i) {
+    frame();
+  }
+  REQUIRE(system.getNumberOfParticles() == capacity);
+  REQUIRE(phases > 0);
+
+  REQUIRE(countAllocations([&]() {
+            for (int i = 0; i < 60; ++i) {
+              frame();
+            }
+          }) == 0);
+}
+
+TEST_CASE("Steady-state sharded frames do not allocate", "[alloc]") {
+  constexpr std::size_t capacity = 50000;
+  app::ParticleSystem system{sf::Vector2u{800, 600}};
+  system.setSeed(3);
+  system.setCapacity(capacity);
+  system.setOverflowPolicy(app::OverflowPolicy::RECYCLE_OLDEST);
+  system.setDissolve();
+  system.setShards(3);
+  SECTION("Full precision") {}
+  SECTION("Compact, with pair forces") {
+    system.setCompact(true);
+    system.addPairForce({app::PairForceType::REPULSION, 6.0F, 2.0F});
+  }
+  const auto frame = [&]() {
+    system.emit(2000);
+    system.update(0.02F);
+  };
+
+  for (int i = 0; i < 60; ++i) {
+    frame();
+  }
+  /* Evicting sorted particles thins them, so some old ones still die */
+  REQUIRE(static_cast<std::size_t>(system.getNumberOfParticles()) >
+          capacity * 9 / 10);
+  REQUIRE(system.getMigrated() > 0);
+
+  REQUIRE(countAllocations([&]() {
+            for (int i = 0; i < 60; ++i) {
+              frame();
+            }
+          }) == 0);
+}
+
+TEST_CASE("Allocation counter sees heap allocations", "[alloc]") {
+  REQUIRE(countAllocations([]() {
+            auto *value = new int{1};
+            delete value;
+          }) == 1);
+}
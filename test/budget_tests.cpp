@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+#include <cstddef>
+
+#include "BudgetController.hpp"
+
+namespace {
+
+const sf::Time TARGET = sf::milliseconds(16);
+constexpr std::size_t CAPACITY = 2000000;
+
+/* A machine where a frame costs a fixed part plus a price per particle;
+ * the user keeps emitting, so the budget is always full */
+struct Machine {
+  sf::Time fixed{sf::milliseconds(1)};
+  float nanosPerParticle{10};
+
+  std::size_t run(app::BudgetController &controller, int frames) const {
+    std::size_t particles{0};
+    for (int i = 0; i < frames; ++i) {
+      particles =
+          controller.getBudget() == 0 ? CAPACITY : controller.getBudget();
+      const sf::Time cost =
+          fixed + sf::microseconds(static_cast<sf::Int64>(
+                      static_cast<float>(particles) * nanosPerParticle /
+                      1000));
+      /* Split like the app: most of it simulating, the rest drawing */
+      controller.update(cost * 0.75F, cost * 0.25F, particles);
+    }
+    return particles;
+  }
+};
+
+}  // namespace
+
+TEST_CASE("The budget settles where a frame fits the target", "[budget]") {
+  app::BudgetController controller{TARGET};
+  controller.setLimits(1000, CAPACITY);
+  REQUIRE(controller.getBudget() == CAPACITY);
+  REQUIRE(controller.getState() == app::BudgetState::MEASURING);
+
+  /* 2M particles cost 21 ms, about 1.2M fit */
+  Machine machine;
+  const std::size_t particles = machine.run(controller, 600);
+  REQUIRE(controller.getLoad() <= 1.0F);
+  REQUIRE(controller.getLoad() >= app::BudgetController::LOW_WATER);
+  REQUIRE(controller.getState() == app::BudgetState::STEADY);
+  REQUIRE(particles < CAPACITY);
+  REQUIRE(particles > 1000000);
+}
+
+TEST_CASE("The budget follows slower and faster hardware", "[budget]") {
+  app::BudgetController controller{TARGET};
+  controller.setLimits(1000, CAPACITY);
+  Machine machine;
+  const std::size_t before = machine.run(controller, 600);
+
+  /* Three times the price per particle: shed load within a second */
+  machine.nanosPerParticle = 30;
+  const std::size_t slow = machine.run(controller, 60);
+  REQUIRE(controller.getLoad() <= 1.0F);
+  REQUIRE(slow < before / 2);
+
+  /* Ten times cheaper: grow back until the capacity is the limit */
+  machine.nanosPerParticle = 3;
+  const std::size_t fast = machine.run(controller, 600);
+  REQUIRE(fast == CAPACITY);
+  REQUIRE(controller.getState() == app::BudgetState::HEADROOM);
+}
+
+TEST_CASE("Load near the target scales emission and speeds dissolution",
+          "[budget]") {
+  app::BudgetController controller{TARGET};
+  controller.setLimits(1000, 0);
+  REQUIRE(controller.getBudget() == 0);
+  REQUIRE(controller.getEmissionScale() == 1.0F);
+
+  /* Well under the target: full emission, no boost, no limit to raise */
+  for (int i = 0; i < app::BudgetController::DECISION_FRAMES; ++i) {
+    controller.update(sf::milliseconds(4), sf::milliseconds(4), 5000);
+  }
+  REQUIRE(controller.getState() == app::BudgetState::HEADROOM);
+  REQUIRE(controller.getBudget() == 0);
+  REQUIRE(controller.getEmissionScale() == 1.0F);
+  REQUIRE(controller.getDissolutionBoost() == 0);
+
+  /* Just under it: emission is tapered and dissolution helps out */
+  controller.reset();
+  bool changed{false};
+  for (int i = 0; i < app::BudgetController::DECISION_FRAMES; ++i) {
+    changed = controller.update(sf::microseconds(11840),
+                                sf::microseconds(3200), 5000);
+  }
+  REQUIRE(changed);
+  REQUIRE(controller.getState() == app::BudgetState::STEADY);
+  REQUIRE(controller.getBudget() == 0);
+  REQUIRE(controller.getEmissionScale() > 0.0F);
+  REQUIRE(controller.getEmissionScale() < 1.0F);
+  REQUIRE(controller.getDissolutionBoost() > 0);
+
+  /* Far over it: no emission, most boost, a budget at last */
+  for (int i = 0; i < app::BudgetController::DECISION_FRAMES; ++i) {
+    controller.update(sf::milliseconds(30), sf::milliseconds(10), 1500);
+  }
+  REQUIRE(controller.getState() == app::BudgetState::OVER);
+  REQUIRE(controller.getEmissionScale() == 0.0F);
+  REQUIRE(controller.getDissolutionBoost() ==
+          app::BudgetController::MAX_BOOST);
+  REQUIRE(controller.getBudget() == 1000);
+}
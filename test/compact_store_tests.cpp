@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "CompactParticleStore.hpp"
+#include "ParticleSnapshot.hpp"
+#include "ParticleStore.hpp"
+#include "ParticleSystem.hpp"
+#include "TestParticles.hpp"
+#include "detail/Half.hpp"
+#include "detail/ThreadPool.hpp"
+
+namespace {
+
+constexpr float WIDTH = 400.0F;
+constexpr float HEIGHT = 300.0F;
+const sf::Vector2u CANVAS{400, 300};
+
+app::ParticleStore scatter(std::size_t count) {
+  return app::test::scatter(count, 9, {0.0F, 0.0F, WIDTH, HEIGHT}, 3.0F);
+}
+
+app::ParticleSystem makeSystem(app::ThreadPool &pool, bool compact) {
+  app::ParticleSystem system = app::test::wrappingSystem(pool, CANVAS, 77,
+                                                         20.0F);
+  system.setCompact(compact);
+  return system;
+}
+
+/* Distance on the wrapped canvas */
+float wrapped(float a, float b, float extent) {
+  const float distance = std::abs(a - b);
+  return std::min(distance, extent - distance);
+}
+
+}  // namespace
+
+TEST_CASE("Half floats convert exactly where binary16 can", "[compact]") {
+  REQUIRE(app::toHalf(1.0F) == 0x3C00);
+  REQUIRE(app::toHalf(-2.0F) == 0xC000);
+  REQUIRE(app::toHalf(65504.0F) == 0x7BFF);
+  REQUIRE(app::toHalf(1e6F) == 0x7C00);
+  REQUIRE(app::toHalf(std::numeric_limits<float>::infinity()) == 0x7C00);
+  REQUIRE(app::toHalf(std::ldexp(1.0F, -24)) == 0x0001);
+  /* Ties round to even */
+  REQUIRE(app::toHalf(1.0F + std::ldexp(1.0F, -11)) == 0x3C00);
+  REQUIRE(app::toHalf(1.0F + 3 * std::ldexp(1.0F, -11)) == 0x3C02);
+  REQUIRE(std::isnan(app::fromHalf(app::toHalf(std::nanf("")))));
+
+  /* Every finite half and both infinities survive a round trip */
+  for (std::uint32_t bits = 0; bits <= 0xFFFFU; ++bits) {
+    const auto half = static_cast<std::uint16_t>(bits);
+    if ((half & 0x7C00U) == 0x7C00U && (half & 0x03FFU) != 0) {
+      continue;
+    }
+    REQUIRE(app::toHalf(app::fromHalf(half)) == half);
+  }
+}
+
+TEST_CASE("Packing keeps particles within one quantization step",
+          "[compact]") {
+  const auto store = scatter(5000);
+  app::CompactParticleStore packed;
+  packed.resize(store.size());
+  packed.encode(store, 0, store.size(), 0, WIDTH, HEIGHT);
+  app::ParticleStore unpacked;
+  unpacked.resize(store.size());
+  packed.decode(0, packed.size(), unpacked, 0, WIDTH, HEIGHT);
+
+  const float stepX = app::compactStep(WIDTH);
+  for (std::size_t i = 0; i < store.size(); ++i) {
+    REQUIRE(std::abs(unpacked.x[i] - store.x[i]) <= stepX * 0.5F + 1e-4F);
+    REQUIRE(std::abs(unpacked.vx[i] - store.vx[i]) <=
+            std::abs(store.vx[i]) * 1e-3F);
+    REQUIRE(std::abs(unpacked.lifetime[i] - store.lifetime[i]) <=
+            store.lifetime[i] * 1e-3F);
+    REQUIRE(std::abs(unpacked.age[i] - store.age[i]) <=
+            store.age[i] * 1e-3F);
+    REQUIRE(unpacked.color[i] == store.color[i]);
+  }
+
+  /* Unpacked particles pack to the same bits, so checkpoints of a compact
+   * system restore exactly */
+  app::CompactParticleStore again;
+  again.resize(unpacked.size());
+  again.encode(unpacked, 0, unpacked.size(), 0, WIDTH, HEIGHT);
+  REQUIRE(again.x == packed.x);
+  REQUIRE(again.y == packed.y);
+  REQUIRE(again.vx == packed.vx);
+  REQUIRE(again.age == packed.age);
+  REQUIRE(again.lifetime == packed.lifetime);
+
+  /* Outside the canvas clamps to the edge; never-expiring particles do
+   * not age into NaN */
+  app::ParticleStore outside;
+  outside.push({-20.0F, 500.0F}, {}, sf::Color::White);
+  packed.encode(outside, 0, 1, 0, WIDTH, HEIGHT);
+  packed.decode(0, 1, unpacked, 0, WIDTH, HEIGHT);
+  REQUIRE(unpacked.x[0] == 0.0F);
+  REQUIRE(unpacked.y[0] == HEIGHT);
+  REQUIRE(unpacked.age[0] == 0.0F);
+  REQUIRE(std::isinf(unpacked.lifetime[0]));
+}
+
+TEST_CASE("A compact system follows the full-precision one", "[compact]") {
+  app::ThreadPool pool{4};
+  app::ParticleSystem full = makeSystem(pool, false);
+  app::ParticleSystem compact = makeSystem(pool, true);
+  REQUIRE(compact.getCompact());
+  for (auto *system : {&full, &compact}) {
+    system->emit(40000);
+    for (int step = 0; step < 50; ++step) {
+      system->update(0.02F);
+    }
+  }
+  REQUIRE(compact.getNumberOfParticles() == full.getNumberOfParticles());
+  const app::ParticleStore &expected = full.getParticles();
+  const app::ParticleStore &actual = compact.getParticles();
+  float worst{0};
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    worst = std::max({worst, wrapped(actual.x[i], expected.x[i], WIDTH),
+                      wrapped(actual.y[i], expected.y[i], HEIGHT)});
+  }
+  /* Mostly the half-precision velocities: each gravity kick rounds to
+   * the step of the velocity it lands on. Particles travel up to 500 px
+   * in these 50 steps. */
+  REQUIRE(worst < 2.5F);
+
+  /* Ageing rounds to the fixed-point age, so particles expire on about
+   * the same steps */
+  for (auto *system : {&full, &compact}) {
+    system->setDissolve(true);
+    system->setLifetime(0.2F, 0.6F);
+    system->clear();
+    system->emit(40000);
+  }
+  for (int step = 0; step < 25; ++step) {
+    full.update(0.02F);
+    compact.update(0.02F);
+    REQUIRE(std::abs(compact.getNumberOfParticles() -
+                     full.getNumberOfParticles()) <= 400);
+  }
+}
+
+TEST_CASE("Packed snapshots expand at upload", "[compact]") {
+  app::ThreadPool pool{2};
+  app::ParticleSystem system = makeSystem(pool, true);
+  system.emit(3000);
+  system.update(0.02F);
+
+  app::ParticleSnapshot snapshot;
+  system.snapshot(snapshot);
+  REQUIRE(sizeof(app::PackedPoint) == 12);
+  REQUIRE(app::CompactParticleStore::BYTES_PER_PARTICLE == 16);
+  REQUIRE(snapshot.vertices.empty());
+  REQUIRE(snapshot.size() == 3000);
+
+  std::vector<sf::Vertex> expanded;
+  const auto &current = snapshot.current(expanded);
+  const auto &vertices = system.getVertices();
+  REQUIRE(current.size() == vertices.size());
+  for (std::size_t i = 0; i < current.size(); ++i) {
+    REQUIRE(current[i].position == vertices[i].position);
+    REQUIRE(current[i].color == vertices[i].color);
+  }
+  /* The previous positions undo the last step */
+  std::vector<sf::Vertex> start;
+  snapshot.interpolate(0.0F, start);
+  const app::ParticleStore &particles = system.getParticles();
+  for (std::size_t i = 0; i < start.size(); ++i) {
+    const float x = particles.x[i] - particles.vx[i] * 0.02F * 100.0F;
+    if (x > 1.0F && x < WIDTH - 1.0F) {
+      REQUIRE(std::abs(start[i].position.x - x) < 0.05F);
+    }
+  }
+}
+
+TEST_CASE("Switching modes and resizing keep the particles", "[compact]") {
+  app::ThreadPool pool{2};
+  app::ParticleSystem system = makeSystem(pool, false);
+  system.setCapacity(5000);
+  system.emit(5000);
+  system.update(0.02F);
+  const app::ParticleStore before = system.getParticles();
+
+  system.setCompact(true);
+  system.setCanvasSize(sf::Vector2u{800, 600});
+  REQUIRE(system.getNumberOfParticles() == 5000);
+  const app::ParticleStore &after = system.getParticles();
+  for (std::size_t i = 0; i < before.size(); ++i) {
+    /* One step of the small canvas, then one of the large */
+    REQUIRE(std::abs(after.x[i] - before.x[i]) <=
+            app::compactStep(WIDTH) * 0.5F +
+                app::compactStep(800.0F) * 0.5F + 1e-4F);
+  }
+
+  /* Capacity and eviction work on the packed particles */
+  system.setOverflowPolicy(app::OverflowPolicy::RECYCLE_OLDEST);
+  system.emit(1000);
+  REQUIRE(system.getNumberOfParticles() == 5000);
+  system.setCompact(false);
+  REQUIRE(system.getNumberOfParticles() == 5000);
+  REQUIRE_FALSE(system.getCompact());
+}
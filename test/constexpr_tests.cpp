@@ -1,5 +1,9 @@
+#include <array>
 #include <catch2/catch.hpp>
 
+#include "KernelFeatures.hpp"
+#include "detail/Random.hpp"
+
 constexpr unsigned int Factorial(unsigned int number) {
   return number <= 1 ? number : Factorial(number - 1) * number;
 }
@@ -10,3 +14,63 @@ TEST_CASE("Factorials are computed with constexpr", "[factorial]") {
   STATIC_REQUIRE(Factorial(3) == 6);
   STATIC_REQUIRE(Factorial(10) == 3628800);
 }
+
+TEST_CASE("Counter RNG is deterministic per seed and counter", "[random]") {
+  constexpr app::CounterRng rng{42};
+  STATIC_REQUIRE(rng(0) == 188429881U);
+  STATIC_REQUIRE(rng(1) == 2814463016U);
+  STATIC_REQUIRE(rng(1000000) == 3792307455U);
+  STATIC_REQUIRE(app::CounterRng{42}(1) == rng(1));
+  STATIC_REQUIRE(app::CounterRng{43}(1) != rng(1));
+  STATIC_REQUIRE(rng.uniform(5) >= 0.0F);
+  STATIC_REQUIRE(rng.uniform(5) < 1.0F);
+}
+
+namespace {
+
+/* Every index maps to a combination that maps back to it */
+constexpr bool kernelIndexRoundTrips() {
+  for (std::size_t index = 0; index < app::KERNEL_VARIANTS; ++index) {
+    if (app::kernelIndex(app::kernelFeatures(index)) != index) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Every combination gets its own slot inside the table */
+constexpr bool kernelIndexCoversAllCombinations() {
+  std::array<bool, app::KERNEL_VARIANTS> seen{};
+  for (std::size_t bounds = 0; bounds < app::BOUNDS_MODES; ++bounds) {
+    for (int flags = 0; flags < 8; ++flags) {
+      const app::KernelFeatures features{(flags & 1) != 0, (flags & 2) != 0,
+                                         (flags & 4) != 0,
+                                         static_cast<app::BoundsMode>(bounds)};
+      const std::size_t index = app::kernelIndex(features);
+      if (index >= app::KERNEL_VARIANTS || seen[index]) {
+        return false;
+      }
+      seen[index] = true;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST_CASE("Kernel dispatch maps each feature set to its own kernel",
+          "[kernel]") {
+  STATIC_REQUIRE(app::KERNEL_VARIANTS == 24);
+  STATIC_REQUIRE(app::kernelIndex(app::KernelFeatures{}) == 0);
+  STATIC_REQUIRE(app::kernelIndex(app::KernelFeatures{
+                     true, true, true, app::BoundsMode::BOUNCE}) ==
+                 app::KERNEL_VARIANTS - 1);
+  STATIC_REQUIRE(app::kernelFeatures(1).dissolve);
+  STATIC_REQUIRE(!app::kernelFeatures(1).gravity);
+  STATIC_REQUIRE(app::kernelFeatures(2).gravity);
+  STATIC_REQUIRE(app::kernelFeatures(4).fields);
+  STATIC_REQUIRE(app::kernelFeatures(8).bounds == app::BoundsMode::WRAP);
+  STATIC_REQUIRE(app::kernelFeatures(16).bounds == app::BoundsMode::BOUNCE);
+  STATIC_REQUIRE(kernelIndexRoundTrips());
+  STATIC_REQUIRE(kernelIndexCoversAllCombinations());
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <array>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "DomainDecomposition.hpp"
+#include "PairForce.hpp"
+#include "ParticleStore.hpp"
+#include "ParticleSystem.hpp"
+#include "SpatialGrid.hpp"
+#include "TestParticles.hpp"
+#include "detail/ThreadPool.hpp"
+
+namespace {
+
+constexpr float WIDTH = 400.0F;
+constexpr float HEIGHT = 300.0F;
+const sf::Vector2u CANVAS{400, 300};
+
+app::ParticleSystem makeSystem(app::ThreadPool &pool, std::size_t shards) {
+  app::ParticleSystem system = app::test::wrappingSystem(pool, CANVAS, 31,
+                                                         40.0F);
+  system.setShards(shards);
+  return system;
+}
+
+/* Particles as a sorted list, to compare systems that order them apart */
+std::vector<std::array<float, 4>> contents(const app::ParticleStore &store) {
+  std::vector<std::array<float, 4>> out;
+  for (std::size_t i = 0; i < store.size(); ++i) {
+    out.push_back({store.x[i], store.y[i], store.vx[i], store.vy[i]});
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+/* The first sorted particles are grouped by strip */
+bool grouped(const app::ParticleSystem &system,
+             const app::DomainDecomposition &strips) {
+  const app::ParticleStore &store = system.getParticles();
+  for (std::size_t i = 1; i < system.getSortedCount(); ++i) {
+    if (strips.stripOf(store.y[i]) < strips.stripOf(store.y[i - 1])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST_CASE("Strips split the canvas evenly", "[shards]") {
+  app::DomainDecomposition strips;
+  strips.setStrips(4, HEIGHT);
+  REQUIRE(strips.active());
+  REQUIRE(strips.stripOf(-5.0F) == 0);
+  REQUIRE(strips.stripOf(74.9F) == 0);
+  REQUIRE(strips.stripOf(75.0F) == 1);
+  REQUIRE(strips.stripOf(299.0F) == 3);
+  REQUIRE(strips.stripOf(400.0F) == 3);
+  strips.setStrips(1, HEIGHT);
+  REQUIRE_FALSE(strips.active());
+  REQUIRE(strips.getStrips() == 0);
+}
+
+TEST_CASE("A sharded system keeps its particles grouped by strip",
+          "[shards]") {
+  app::ThreadPool pool{4};
+  app::ParticleSystem system = makeSystem(pool, 5);
+  app::DomainDecomposition strips;
+  strips.setStrips(5, HEIGHT);
+  system.emit(30000);
+  REQUIRE(system.getSortedCount() == 0);
+
+  std::size_t migrated{0};
+  for (int step = 0; step < 30; ++step) {
+    if (step % 10 == 0) {
+      system.emit(2000);
+    }
+    system.update(0.02F);
+    REQUIRE(system.getSortedCount() ==
+            static_cast<std::size_t>(system.getNumberOfParticles()));
+    REQUIRE(grouped(system, strips));
+    migrated += system.getMigrated();
+  }
+  REQUIRE(migrated > 0);
+
+  /* Compact mode and a new canvas regroup at the next update */
+  system.setCompact(true);
+  system.setCanvasSize(sf::Vector2u{400, 600});
+  REQUIRE(system.getSortedCount() == 0);
+  system.update(0.02F);
+  strips.setStrips(5, 600.0F);
+  REQUIRE(grouped(system, strips));
+  REQUIRE(system.getNumberOfParticles() == 36000);
+}
+
+TEST_CASE("Sharding moves particles but updates them the same",
+          "[shards]") {
+  app::ThreadPool pool{4};
+  app::ParticleSystem whole = makeSystem(pool, 0);
+  app::ParticleSystem sharded = makeSystem(pool, 8);
+  for (auto *system : {&whole, &sharded}) {
+    system->setBoundsMode(app::BoundsMode::CULL);
+    system->setDissolve(true);
+    system->emit(40000);
+    for (int step = 0; step < 25; ++step) {
+      system->update(0.02F);
+    }
+  }
+  REQUIRE(sharded.getNumberOfParticles() == whole.getNumberOfParticles());
+  REQUIRE(contents(sharded.getParticles()) == contents(whole.getParticles()));
+}
+
+TEST_CASE("Ghost zones give the pair forces of the whole canvas",
+          "[shards]") {
+  app::ThreadPool pool{4};
+  const std::vector<app::PairForce> forces{
+      {app::PairForceType::REPULSION, 12.0F, 3.0F},
+      {app::PairForceType::COHESION, 5.0F, 1.0F}};
+  constexpr float cellSize = 6.0F;
+  constexpr std::size_t maxNeighbours = 12;
+
+  /* All but the last particles grouped by strip, those unassigned */
+  app::DomainDecomposition strips;
+  strips.setStrips(7, HEIGHT);
+  const app::ParticleStore scattered = app::test::scatter(
+      20000, 5, {-5.0F, -5.0F, WIDTH + 5.0F, HEIGHT + 5.0F});
+  const std::size_t assigned = 18000;
+  std::vector<std::uint32_t> order(scattered.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    order[i] = static_cast<std::uint32_t>(i);
+  }
+  std::stable_sort(order.begin(), order.begin() + assigned,
+                   [&](std::uint32_t a, std::uint32_t b) {
+                     return strips.stripOf(scattered.y[a]) <
+                            strips.stripOf(scattered.y[b]);
+                   });
+  app::ParticleStore expected;
+  expected.resize(scattered.size());
+  expected.gather(scattered, order.data(), order.size(), 0);
+  app::ParticleStore actual = expected;
+
+  app::SpatialGrid grid;
+  grid.setCellSize(cellSize);
+  grid.setBounds(WIDTH, HEIGHT);
+  grid.build(expected, pool);
+  std::vector<float> dvx(expected.size(), 0.0F);
+  std::vector<float> dvy(expected.size(), 0.0F);
+  app::accumulatePairForces(grid, pool, forces, 0.02F, maxNeighbours,
+                            dvx.data(), dvy.data());
+  for (std::size_t slot = 0; slot < grid.size(); ++slot) {
+    expected.vx[grid.order()[slot]] += dvx[slot];
+    expected.vy[grid.order()[slot]] += dvy[slot];
+  }
+
+  strips.locate(assigned, actual.size(),
+                [&](std::size_t i) { return actual.y[i]; });
+  strips.applyPairForces(actual, forces, cellSize, WIDTH, 0.02F,
+                         maxNeighbours, pool);
+  REQUIRE(actual.vx == expected.vx);
+  REQUIRE(actual.vy == expected.vy);
+}
+
+TEST_CASE("Sharded results do not depend on the thread count", "[shards]") {
+  app::ThreadPool single{1};
+  app::ThreadPool many{4};
+  app::ParticleSystem one = makeSystem(single, 4);
+  app::ParticleSystem four = makeSystem(many, 4);
+  for (auto *system : {&one, &four}) {
+    system->addPairForce({app::PairForceType::REPULSION, 6.0F, 2.0F});
+    system->emit(20000);
+    for (int step = 0; step < 15; ++step) {
+      system->update(0.02F);
+    }
+  }
+  REQUIRE(one.getParticles().x == four.getParticles().x);
+  REQUIRE(one.getParticles().vy == four.getParticles().vy);
+}
@@ -0,0 +1,139 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <vector>
+
+#include "Emitter.hpp"
+#include "EmitterManager.hpp"
+#include "ParticleSnapshot.hpp"
+#include "ParticleSystem.hpp"
+#include "detail/ThreadPool.hpp"
+
+namespace {
+
+const sf::Vector2u CANVAS{400, 400};
+
+std::vector<sf::Vertex> vertices(const app::ParticleSystem &system) {
+  return system.getVertices();
+}
+
+}  // namespace
+
+TEST_CASE("Emitters write into one batch in emitter order", "[emitters]") {
+  app::ThreadPool pool{4};
+  app::ParticleSystem system{CANVAS};
+  system.setThreadPool(pool);
+  system.setSeed(1);
+
+  std::vector<app::Emitter> emitters(3);
+  emitters[0].position = {50.0F, 60.0F};
+  emitters[1].position = {200.0F, 100.0F};
+  emitters[1].shape = app::Shape::SQUARE;
+  emitters[1].colorMin = sf::Color{200, 0, 10, 100};
+  emitters[1].colorMax = sf::Color{255, 0, 20, 150};
+  emitters[2].position = {300.0F, 300.0F};
+  const std::vector<std::size_t> counts{5000, 0, 7000};
+  system.emit(emitters, counts);
+  system.emit(emitters, {0, 9000, 0});
+
+  const auto batch = vertices(system);
+  REQUIRE(batch.size() == 21000);
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    const std::size_t source = i < 5000 ? 0 : i < 12000 ? 2 : 1;
+    REQUIRE(batch[i].position == emitters[source].position);
+    const sf::Color &color = batch[i].color;
+    REQUIRE(color.r >= emitters[source].colorMin.r);
+    REQUIRE(color.r <= emitters[source].colorMax.r);
+    REQUIRE(color.b >= emitters[source].colorMin.b);
+    REQUIRE(color.b <= emitters[source].colorMax.b);
+    REQUIRE(color.a >= emitters[source].colorMin.a);
+    REQUIRE(color.a <= emitters[source].colorMax.a);
+  }
+}
+
+TEST_CASE("Many emitters cost the same particles as one", "[emitters]") {
+  /* Identical emitters draw from one counter sequence, so splitting a
+   * batch over them must not change a single particle */
+  app::ParticleSystem one{CANVAS};
+  one.setSeed(9);
+  one.setPosition(120.0F, 80.0F);
+  one.emit(20000);
+
+  app::ParticleSystem many{CANVAS};
+  many.setSeed(9);
+  app::Emitter emitter;
+  emitter.position = {120.0F, 80.0F};
+  const std::vector<app::Emitter> emitters(100, emitter);
+  std::vector<std::size_t> counts(100, 150);
+  counts[3] = 0;
+  counts[99] = 5300;
+  many.emit(emitters, counts);
+
+  one.update(0.02F);
+  many.update(0.02F);
+  app::ParticleSnapshot lhs;
+  app::ParticleSnapshot rhs;
+  one.snapshot(lhs);
+  many.snapshot(rhs);
+  REQUIRE(lhs.vertices.size() == rhs.vertices.size());
+  for (std::size_t i = 0; i < lhs.vertices.size(); ++i) {
+    REQUIRE(lhs.vertices[i].position == rhs.vertices[i].position);
+    REQUIRE(lhs.vertices[i].color == rhs.vertices[i].color);
+  }
+}
+
+TEST_CASE("Emitter speed scales velocities", "[emitters]") {
+  app::ParticleSystem system{CANVAS};
+  system.setSeed(2);
+  app::Emitter emitter;
+  emitter.position = {200.0F, 200.0F};
+  emitter.speed = 0.25F;
+  system.emit({emitter}, {2000});
+  system.update(1.0F);
+  /* Circle velocities are at most 1, times speed 100 px/s */
+  for (const auto &vertex : vertices(system)) {
+    const sf::Vector2f moved = vertex.position - emitter.position;
+    REQUIRE(std::sqrt(moved.x * moved.x + moved.y * moved.y) <= 25.001F);
+  }
+}
+
+TEST_CASE("Emitter manager carries fractional rates", "[emitters]") {
+  app::ParticleSystem system{CANVAS};
+  app::EmitterManager manager;
+  app::Emitter steady;
+  steady.rate = 10.0F;
+  const std::size_t steadyIndex = manager.add(steady);
+  app::Emitter off;
+  off.enabled = false;
+  manager.add(off);
+  REQUIRE(manager.size() == 2);
+
+  /* 2.5 particles per step: 2, 3, 2, 3 */
+  std::vector<int> perStep;
+  for (int step = 0; step < 4; ++step) {
+    const int before = system.getNumberOfParticles();
+    manager.emit(system, 0.25F);
+    perStep.push_back(system.getNumberOfParticles() - before);
+  }
+  REQUIRE(perStep == std::vector<int>{2, 3, 2, 3});
+
+  manager.remove(steadyIndex);
+  REQUIRE(manager.size() == 1);
+  manager.emit(system, 1.0F);
+  REQUIRE(system.getNumberOfParticles() == 10);
+}
+
+TEST_CASE("A full pool trims the last emitters first", "[emitters][pool]") {
+  app::ParticleSystem system{CANVAS};
+  system.setCapacity(10);
+  system.setOverflowPolicy(app::OverflowPolicy::DROP_NEW);
+  std::vector<app::Emitter> emitters(2);
+  emitters[0].position = {10.0F, 10.0F};
+  emitters[1].position = {20.0F, 20.0F};
+  system.emit(emitters, {6, 6});
+
+  const auto batch = vertices(system);
+  REQUIRE(batch.size() == 10);
+  REQUIRE(batch[5].position == emitters[0].position);
+  REQUIRE(batch[6].position == emitters[1].position);
+  REQUIRE(system.getPoolStats().dropped == 2);
+}
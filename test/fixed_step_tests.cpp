@@ -0,0 +1,51 @@
+#include <catch2/catch.hpp>
+#include <limits>
+
+#include "detail/FixedStepScheduler.hpp"
+
+TEST_CASE("Fixed step accumulates partial steps", "[fixedstep]") {
+  app::FixedStepScheduler scheduler{50.0F, 5};
+  REQUIRE(scheduler.getStep() == sf::milliseconds(20));
+  REQUIRE(scheduler.advance(sf::milliseconds(15)) == 0);
+  REQUIRE(scheduler.getAlpha() == Approx(0.75F));
+  REQUIRE(scheduler.advance(sf::milliseconds(15)) == 1);
+  REQUIRE(scheduler.getAlpha() == Approx(0.5F));
+  REQUIRE(scheduler.getTimeToNextStep() == sf::milliseconds(10));
+  REQUIRE(scheduler.getStepCount() == 1);
+}
+
+TEST_CASE("Fixed step clamps catch-up and reports dropped time",
+          "[fixedstep]") {
+  app::FixedStepScheduler scheduler{100.0F, 3};
+  /* A 255+ ms stall must neither run away nor be caught up forever */
+  REQUIRE(scheduler.advance(sf::milliseconds(300)) == 3);
+  REQUIRE(scheduler.getDroppedTime() == sf::milliseconds(270));
+  REQUIRE(scheduler.getAccumulatedTime() == sf::Time::Zero);
+  REQUIRE(scheduler.advance(sf::milliseconds(10)) == 1);
+  REQUIRE(scheduler.getStepCount() == 4);
+}
+
+TEST_CASE("Fixed step falls back to one step a second for bad rates",
+          "[fixedstep]") {
+  app::FixedStepScheduler scheduler{60.0F, 3};
+  for (float rate : {0.0F, -5.0F, std::numeric_limits<float>::quiet_NaN(),
+                     std::numeric_limits<float>::infinity(), 1e-30F, 0.5F,
+                     1e7F}) {
+    scheduler.setStepRate(rate);
+    REQUIRE(scheduler.getStep() == sf::seconds(1));
+  }
+  scheduler.setStepRate(50.0F);
+  REQUIRE(scheduler.getStep() == sf::milliseconds(20));
+}
+
+TEST_CASE("Fixed step count only depends on total time", "[fixedstep]") {
+  app::FixedStepScheduler coarse{60.0F, 1000};
+  app::FixedStepScheduler fine{60.0F, 1000};
+  sf::Uint32 coarseSteps = coarse.advance(sf::milliseconds(1000));
+  sf::Uint32 fineSteps = 0;
+  for (int i = 0; i < 1000; ++i) {
+    fineSteps += fine.advance(sf::milliseconds(1));
+  }
+  REQUIRE(coarseSteps == fineSteps);
+  REQUIRE(coarse.getAccumulatedTime() == fine.getAccumulatedTime());
+}
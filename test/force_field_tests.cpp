@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "ForceField.hpp"
+#include "ParticleStore.hpp"
+#include "TestParticles.hpp"
+
+namespace {
+
+constexpr app::test::Bounds CANVAS{0.0F, 0.0F, 200.0F, 200.0F};
+const sf::Vector2f CENTRE{100.0F, 100.0F};
+
+}  // namespace
+
+TEST_CASE("Attractors pull towards their centre within range", "[fields]") {
+  const auto before = app::test::scatter(1000, 3, CANVAS);
+  auto after = before;
+  const std::vector<app::ForceField> fields{
+      {app::ForceFieldType::ATTRACTOR, CENTRE, 2.0F, 50.0F}};
+  app::applyForceFields(after, 0, after.size(), fields, 0.1F, 0.0F);
+
+  for (std::size_t i = 0; i < before.size(); ++i) {
+    const sf::Vector2f offset = CENTRE - sf::Vector2f{before.x[i], before.y[i]};
+    const sf::Vector2f change{after.vx[i] - before.vx[i],
+                              after.vy[i] - before.vy[i]};
+    const float dist2 = offset.x * offset.x + offset.y * offset.y;
+    if (dist2 >= 50.0F * 50.0F) {
+      REQUIRE(change.x == 0.0F);
+      REQUIRE(change.y == 0.0F);
+    } else {
+      REQUIRE(offset.x * change.x + offset.y * change.y >= 0.0F);
+    }
+  }
+}
+
+TEST_CASE("Vortices push tangentially, drag opposes velocity", "[fields]") {
+  const auto before = app::test::scatter(1000, 3, CANVAS);
+  auto after = before;
+  app::applyForceFields(
+      after, 0, after.size(),
+      {{app::ForceFieldType::VORTEX, CENTRE, 5.0F}}, 0.1F, 0.0F);
+  for (std::size_t i = 0; i < before.size(); ++i) {
+    const float dx = before.x[i] - CENTRE.x;
+    const float dy = before.y[i] - CENTRE.y;
+    const float radial = dx * (after.vx[i] - before.vx[i]) +
+                         dy * (after.vy[i] - before.vy[i]);
+    REQUIRE(radial == Approx(0.0F).margin(1e-4));
+  }
+
+  after = before;
+  app::applyForceFields(after, 0, after.size(),
+                        {{app::ForceFieldType::DRAG, {}, 2.0F}}, 0.1F, 0.0F);
+  for (std::size_t i = 0; i < before.size(); ++i) {
+    REQUIRE(after.vx[i] == Approx(before.vx[i] * 0.8F));
+    REQUIRE(after.vy[i] == Approx(before.vy[i] * 0.8F));
+  }
+}
+
+TEST_CASE("Fused fields match one pass per field", "[fields]") {
+  const std::vector<app::ForceField> fields{
+      {app::ForceFieldType::ATTRACTOR, CENTRE, 2.0F, 80.0F},
+      {app::ForceFieldType::ATTRACTOR, {20.0F, 30.0F}, -1.0F},
+      {app::ForceFieldType::VORTEX, {150.0F, 60.0F}, 3.0F, 120.0F},
+      {app::ForceFieldType::DRAG, {}, 0.5F},
+      {app::ForceFieldType::NOISE, {}, 1.5F, 0.0F, 0.02F},
+      {app::ForceFieldType::VORTEX, CENTRE, 0.0F}};
+  /* Odd bounds cross the internal block size unevenly */
+  constexpr std::size_t begin = 7;
+  constexpr std::size_t end = 1290;
+  const auto before = app::test::scatter(1300, 3, CANVAS);
+
+  auto fused = before;
+  app::applyForceFields(fused, begin, end, fields, 0.02F, 1.25F);
+
+  std::vector<float> expectX(before.size(), 0.0F);
+  std::vector<float> expectY(before.size(), 0.0F);
+  for (const auto &field : fields) {
+    auto single = before;
+    app::applyForceFields(single, begin, end, {field}, 0.02F, 1.25F);
+    for (std::size_t i = 0; i < before.size(); ++i) {
+      expectX[i] += single.vx[i] - before.vx[i];
+      expectY[i] += single.vy[i] - before.vy[i];
+    }
+  }
+  for (std::size_t i = 0; i < before.size(); ++i) {
+    const bool inside = i >= begin && i < end;
+    if (!inside) {
+      REQUIRE(fused.vx[i] == before.vx[i]);
+      REQUIRE(fused.vy[i] == before.vy[i]);
+    }
+    REQUIRE(fused.vx[i] - before.vx[i] == Approx(expectX[i]).margin(1e-5));
+    REQUIRE(fused.vy[i] - before.vy[i] == Approx(expectY[i]).margin(1e-5));
+  }
+}
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "FrameCapture.hpp"
+#include "Rasterizer.hpp"
+
+namespace {
+
+const sf::Vector2u SIZE{16, 8};
+
+std::string tempPath(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<char> readFile(const std::string &path) {
+  std::vector<char> bytes(std::filesystem::file_size(path));
+  std::ifstream in{path, std::ios::binary};
+  in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  return bytes;
+}
+
+/* Frame n lights one pixel, (n % width, n % height) */
+std::vector<sf::Vertex> frame(unsigned int n) {
+  sf::Vertex vertex;
+  vertex.position = {static_cast<float>(n % SIZE.x) + 0.5F,
+                     static_cast<float>(n % SIZE.y) + 0.5F};
+  vertex.color = sf::Color::White;
+  return {vertex};
+}
+
+}  // namespace
+
+TEST_CASE("Capture targets select the output", "[capture]") {
+  app::CaptureSettings settings;
+  REQUIRE(app::parseCaptureTarget("pipe:ffmpeg -i - out.mp4", settings));
+  REQUIRE(settings.output == app::CaptureOutput::PIPE);
+  REQUIRE(settings.target == "ffmpeg -i - out.mp4");
+
+  REQUIRE(app::parseCaptureTarget("session.rgba", settings));
+  REQUIRE(settings.output == app::CaptureOutput::RAW_FILE);
+  REQUIRE(settings.target == "session.rgba");
+
+  REQUIRE(app::parseCaptureTarget("frames/shot.png", settings));
+  REQUIRE(settings.output == app::CaptureOutput::IMAGES);
+  REQUIRE(settings.target == "frames/shot");
+  REQUIRE(settings.format == "png");
+
+  REQUIRE(app::parseCaptureTarget("frames/shot-", settings));
+  REQUIRE(settings.target == "frames/shot-");
+  REQUIRE(settings.format == "ppm");
+
+  REQUIRE_FALSE(app::parseCaptureTarget("pipe:", settings));
+}
+
+TEST_CASE("Raw capture keeps every frame in submission order",
+          "[capture]") {
+  const std::string path = tempPath("frame_capture_tests.rgba");
+  app::CaptureSettings settings;
+  REQUIRE(app::parseCaptureTarget(path, settings));
+  settings.size = SIZE;
+  settings.slots = 64;
+  settings.writers = 3;
+  settings.points = 1;
+
+  app::FrameCapture capture;
+  std::string error;
+  REQUIRE(capture.start(settings, error));
+  REQUIRE(capture.isRunning());
+  constexpr unsigned int frames = 40;
+  for (unsigned int n = 0; n < frames; ++n) {
+    REQUIRE(capture.submit(frame(n)));
+  }
+  capture.stop();
+  REQUIRE_FALSE(capture.isRunning());
+
+  const app::CaptureStats stats = capture.getStats();
+  REQUIRE(stats.captured == frames);
+  REQUIRE(stats.written == frames);
+  REQUIRE(stats.dropped == 0);
+  REQUIRE(stats.failed == 0);
+
+  const std::size_t frameBytes = std::size_t{SIZE.x} * SIZE.y * 4;
+  const std::vector<char> bytes = readFile(path);
+  REQUIRE(bytes.size() == frames * frameBytes);
+  app::Rasterizer reference{SIZE};
+  for (unsigned int n = 0; n < frames; ++n) {
+    reference.clear();
+    reference.draw(frame(n));
+    const char *pixels = bytes.data() + n * frameBytes;
+    REQUIRE(std::equal(pixels, pixels + frameBytes,
+                       reinterpret_cast<const char *>(
+                           reference.getPixels().data())));
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("A full pool drops frames instead of waiting", "[capture]") {
+  const std::string prefix = tempPath("frame_capture_tests_");
+  app::CaptureSettings settings;
+  REQUIRE(app::parseCaptureTarget(prefix + ".ppm", settings));
+  settings.size = sf::Vector2u{256, 256};
+  settings.slots = 1;
+  settings.writers = 1;
+
+  /* Far more points than one writer renders between two submissions */
+  std::vector<sf::Vertex> heavy(200000);
+  for (std::size_t i = 0; i < heavy.size(); ++i) {
+    heavy[i].position = {static_cast<float>(i % 256),
+                         static_cast<float>(i / 256 % 256)};
+    heavy[i].color = sf::Color{255, 128, 0, 100};
+  }
+  app::FrameCapture capture;
+  std::string error;
+  REQUIRE(capture.start(settings, error));
+  constexpr int submissions = 20;
+  int accepted{0};
+  for (int i = 0; i < submissions; ++i) {
+    accepted += capture.submit(heavy) ? 1 : 0;
+  }
+  capture.stop();
+
+  const app::CaptureStats stats = capture.getStats();
+  REQUIRE(stats.dropped > 0);
+  REQUIRE(stats.captured + stats.dropped == submissions);
+  REQUIRE(stats.captured == static_cast<std::uint64_t>(accepted));
+  REQUIRE(stats.written == stats.captured);
+  /* Accepted frames are numbered without gaps */
+  for (std::uint64_t n = 0; n < stats.captured; ++n) {
+    const std::string path =
+        prefix + std::string(6 - std::to_string(n).size(), '0') +
+        std::to_string(n) + ".ppm";
+    REQUIRE(std::filesystem::exists(path));
+    std::filesystem::remove(path);
+  }
+}
@@ -0,0 +1,54 @@
+#include <catch2/catch.hpp>
+#include <cstddef>
+
+#include "Lifetime.hpp"
+#include "Particle.hpp"
+#include "ParticleSystem.hpp"
+
+TEST_CASE("Baked curves hit their stops and hold past the ends",
+          "[lifetime]") {
+  app::LifetimeTable table;
+  table.bake(app::LifetimeCurves::fire());
+  const app::LifetimeCurves fire = app::LifetimeCurves::fire();
+  REQUIRE(table.sample(0.0F) == fire.stops[0].color);
+  REQUIRE(table.sample(1.0F) == fire.stops[fire.count - 1].color);
+  REQUIRE(table.sample(-1.0F) == table.sample(0.0F));
+  REQUIRE(table.sample(2.0F) == table.sample(1.0F));
+  REQUIRE(table.mask() == ~std::uint32_t{0});
+
+  /* Half way between the two stops of fade */
+  table.bake(app::LifetimeCurves::fade());
+  const sf::Color middle = table.sample(0.5F);
+  REQUIRE(middle.a > 120);
+  REQUIRE(middle.a < 135);
+  REQUIRE(table.mask() != ~std::uint32_t{0});
+}
+
+TEST_CASE("Particles expire at the end of their lifetime", "[lifetime]") {
+  app::ParticleSystem system{sf::Vector2u{800, 600}};
+  system.setDissolve();
+  system.setDissolutionRate(4); /* real time */
+  system.setLifetime(0.5F, 0.5F);
+  system.setPosition(400.0F, 300.0F);
+  system.setParticleSpeed(0.0F);
+  system.emit(100);
+  system.update(0.25F);
+  REQUIRE(system.getNumberOfParticles() == 100);
+  /* Half way through, so half faded */
+  const sf::Color emitted = system.getVertices().front().color;
+  REQUIRE(emitted.a > 120);
+  REQUIRE(emitted.a < 135);
+
+  system.emit(100);
+  system.update(0.25F);
+  REQUIRE(system.getNumberOfParticles() == 100);
+  system.update(0.3F);
+  REQUIRE(system.getNumberOfParticles() == 0);
+}
+
+TEST_CASE("Particles stop fading at transparent", "[lifetime]") {
+  app::Particle particle;
+  particle.updateDrawVertexColorAlpha(200);
+  particle.updateDrawVertexColorAlpha(200);
+  REQUIRE(particle.getDrawVertex().color.a == 0);
+}
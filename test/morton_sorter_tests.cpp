@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "MortonSorter.hpp"
+#include "ParticleStore.hpp"
+#include "ParticleSystem.hpp"
+#include "TestParticles.hpp"
+#include "detail/ThreadPool.hpp"
+
+namespace {
+
+/* Over and slightly outside a 100x80 canvas */
+constexpr app::test::Bounds AROUND_CANVAS{-5.0F, -5.0F, 105.0F, 85.0F};
+
+}  // namespace
+
+TEST_CASE("Morton codes interleave x and y", "[morton]") {
+  REQUIRE(app::mortonCode(0.0F, 0.0F, 100.0F, 80.0F) == 0);
+  REQUIRE(app::mortonCode(100.0F, 0.0F, 100.0F, 80.0F) == 0x55555U);
+  REQUIRE(app::mortonCode(0.0F, 80.0F, 100.0F, 80.0F) == 0xAAAAAU);
+  REQUIRE(app::mortonCode(200.0F, -10.0F, 100.0F, 80.0F) == 0x55555U);
+  /* The top left quadrant comes before the top right one */
+  REQUIRE(app::mortonCode(49.0F, 39.0F, 100.0F, 80.0F) <
+          app::mortonCode(51.0F, 0.0F, 100.0F, 80.0F));
+}
+
+TEST_CASE("Parallel radix sort matches a stable sort by code", "[morton]") {
+  const auto store = app::test::scatter(100003, 5, AROUND_CANVAS);
+  app::ThreadPool pool{4};
+  app::MortonSorter sorter;
+  sorter.sort(store, 100.0F, 80.0F, pool);
+
+  std::vector<std::uint32_t> expected(store.size());
+  std::iota(expected.begin(), expected.end(), 0U);
+  const auto code = [&](std::uint32_t i) {
+    return app::mortonCode(store.x[i], store.y[i], 100.0F, 80.0F);
+  };
+  std::stable_sort(
+      expected.begin(), expected.end(),
+      [&](std::uint32_t a, std::uint32_t b) { return code(a) < code(b); });
+  REQUIRE(sorter.order() == expected);
+  REQUIRE(sorter.getPasses() == 2);
+
+  /* Everyone in one corner: the high digit is zero for all */
+  auto corner = app::test::scatter(1000, 5, AROUND_CANVAS);
+  for (auto &x : corner.x) {
+    x = std::clamp(x * 0.001F, 0.0F, 0.1F);
+  }
+  corner.y.assign(corner.size(), 0.0F);
+  sorter.sort(corner, 100.0F, 80.0F, pool);
+  REQUIRE(sorter.getPasses() == 1);
+  REQUIRE(std::is_sorted(sorter.order().begin(), sorter.order().end(),
+                         [&](std::uint32_t a, std::uint32_t b) {
+                           return app::mortonCode(corner.x[a], 0, 100, 80) <
+                                  app::mortonCode(corner.x[b], 0, 100, 80);
+                         }));
+}
+
+TEST_CASE("Sorting the system reorders but keeps every particle",
+          "[morton][system]") {
+  app::ThreadPool pool{4};
+  app::ParticleSystem system{sf::Vector2u{100, 80}};
+  system.setThreadPool(pool);
+  system.setSeed(3);
+  system.setParticleSpeed(1000.0F);
+  system.emit(20000);
+  system.update(0.02F);
+  REQUIRE(system.getDisorder() > 0.3F);
+
+  auto before = system.getParticles().x;
+  system.sortSpatially();
+  REQUIRE(system.getDisorder() == 0.0F);
+  REQUIRE(system.getSortedCount() == system.getParticles().size());
+  auto after = system.getParticles().x;
+  REQUIRE(after != before);
+  std::sort(before.begin(), before.end());
+  std::sort(after.begin(), after.end());
+  REQUIRE(after == before);
+
+  /* Culling keeps the sorted ones in front, new ones go behind them */
+  system.update(0.02F);
+  const std::size_t sorted = system.getSortedCount();
+  REQUIRE(sorted == system.getParticles().size());
+  system.emit(100);
+  REQUIRE(system.getSortedCount() == sorted);
+}
+
+TEST_CASE("Sorts run on their interval or once disorder builds up",
+          "[morton][system]") {
+  app::ParticleSystem system{sf::Vector2u{100, 80}};
+  system.setSeed(4);
+  system.setBoundsMode(app::BoundsMode::WRAP);
+  system.emit(5000);
+  system.setSpatialSort(3, 0.0F);
+  system.update(0.02F);
+  system.update(0.02F);
+  system.update(0.02F);
+  REQUIRE(system.getSortedCount() == 0);
+  system.update(0.02F);
+  REQUIRE(system.getSortedCount() == 5000);
+  REQUIRE(system.getStepsSinceSort() == 1);
+
+  /* Fresh particles all start in one spot, so only motion disorders them */
+  system.setSpatialSort(0, 0.2F);
+  system.emit(5000);
+  const float disorder = system.getDisorder();
+  system.update(0.02F);
+  REQUIRE(system.getSortedCount() == (disorder > 0.2F ? 10000U : 5000U));
+  for (int i = 0; i < 50; ++i) {
+    system.update(0.02F);
+    REQUIRE(system.getDisorder() <= 0.5F);
+  }
+  REQUIRE(system.getSortedCount() == 10000);
+}
+
+TEST_CASE("Evicting the oldest thins sorted particles out evenly",
+          "[morton][pool]") {
+  app::ParticleSystem system{sf::Vector2u{800, 600}};
+  system.setSeed(5);
+  system.setCapacity(1000);
+  system.setOverflowPolicy(app::OverflowPolicy::RECYCLE_OLDEST);
+  system.setParticleSpeed(5000.0F);
+  system.setBoundsMode(app::BoundsMode::WRAP);
+  system.emit(800);
+  system.update(0.05F);
+  system.sortSpatially();
+  const auto sorted = system.getParticles().x;
+
+  system.setParticleSpeed(0.0F);
+  system.emit(100);
+  system.emit(300);
+  REQUIRE(system.getNumberOfParticles() == 1000);
+  REQUIRE(system.getPoolStats().recycled == 200);
+  /* Every fourth sorted particle went, all new ones stayed */
+  REQUIRE(system.getSortedCount() == 600);
+  const auto &x = system.getParticles().x;
+  for (std::size_t i = 0; i < 600; ++i) {
+    REQUIRE(x[i] == sorted[i + i / 3]);
+  }
+  for (std::size_t i = 600; i < 1000; ++i) {
+    REQUIRE(x[i] == 400.0F);
+  }
+}
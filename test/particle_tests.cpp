@@ -0,0 +1,423 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "ForceField.hpp"
+#include "KernelFeatures.hpp"
+#include "Lifetime.hpp"
+#include "ParticleKernel.hpp"
+#include "ParticleSnapshot.hpp"
+#include "ParticleStore.hpp"
+#include "ParticleSystem.hpp"
+#include "detail/Random.hpp"
+
+namespace {
+
+/* Particles scattered around and outside a 100x100 canvas, with ages
+ * around their lifetimes */
+app::ParticleStore makeStore(std::size_t count) {
+  const app::CounterRng rng{7};
+  app::ParticleStore store;
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint64_t counter = i * 8;
+    store.push(sf::Vector2f{rng.uniform(counter, -10.0F, 110.0F),
+                            rng.uniform(counter + 1, -10.0F, 110.0F)},
+               sf::Vector2f{rng.uniform(counter + 2, -1.0F, 1.0F),
+                            rng.uniform(counter + 3, -1.0F, 1.0F)},
+               sf::Color{static_cast<sf::Uint8>(rng(counter + 4)), 0, 0,
+                         static_cast<sf::Uint8>(rng(counter + 5))},
+               rng.uniform(counter + 6, 0.01F, 1.0F));
+    store.age.back() = rng.uniform(counter + 7, 0.0F, 1.0F);
+  }
+  return store;
+}
+
+/* Tinting curves, so the kernels replace whole colours */
+const app::LifetimeTable &fireTable() {
+  static const app::LifetimeTable table = [] {
+    app::LifetimeTable baked;
+    baked.bake(app::LifetimeCurves::fire());
+    return baked;
+  }();
+  return table;
+}
+
+template <typename T>
+bool sameBits(const std::vector<T> &lhs, const std::vector<T> &rhs) {
+  return lhs.size() == rhs.size() &&
+         std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) == 0;
+}
+
+}  // namespace
+
+TEST_CASE("SIMD update kernels are bit-equivalent to scalar", "[kernel]") {
+  constexpr std::size_t count = 1003; /* not a multiple of any lane width */
+  constexpr std::size_t begin = 5;
+  app::KernelParams params;
+  params.gravityX = 0.37F;
+  params.gravityY = -1.5F;
+  params.thrust = 2.0F;
+  params.maxX = 100.0F;
+  params.maxY = 100.0F;
+  params.aging = 0.05F;
+  params.lifetimeColors = fireTable().data();
+  params.lifetimeMask = fireTable().mask();
+
+  auto reference = makeStore(count);
+  std::vector<std::uint8_t> refMask(count, 2);
+  std::vector<std::uint32_t> refIndices(count, 0);
+  const std::size_t refAlive =
+      app::integrateParticles(reference, begin, count, params, refMask.data(),
+                              refIndices.data(), app::KernelIsa::SCALAR);
+  REQUIRE(refAlive > 0);
+  REQUIRE(refAlive < count - begin);
+
+  for (auto isa : {app::KernelIsa::SSE2, app::KernelIsa::AVX2}) {
+    if (!app::isKernelIsaSupported(isa)) {
+      continue;
+    }
+    auto store = makeStore(count);
+    std::vector<std::uint8_t> mask(count, 2);
+    std::vector<std::uint32_t> indices(count, 0);
+    const std::size_t alive = app::integrateParticles(
+        store, begin, count, params, mask.data(), indices.data(), isa);
+    REQUIRE(alive == refAlive);
+    REQUIRE(sameBits(store.x, reference.x));
+    REQUIRE(sameBits(store.y, reference.y));
+    REQUIRE(sameBits(store.vx, reference.vx));
+    REQUIRE(sameBits(store.vy, reference.vy));
+    REQUIRE(sameBits(store.color, reference.color));
+    REQUIRE(sameBits(store.age, reference.age));
+    REQUIRE(mask == refMask);
+    REQUIRE(std::equal(indices.begin() + begin,
+                       indices.begin() + static_cast<long>(begin + alive),
+                       refIndices.begin() + begin));
+  }
+}
+
+TEST_CASE("Every specialised kernel matches scalar on every ISA",
+          "[kernel]") {
+  constexpr std::size_t count = 3001; /* spans several field passes */
+  constexpr std::size_t begin = 3;
+  const std::vector<app::ForceField> fields{
+      app::ForceField{app::ForceFieldType::ATTRACTOR, sf::Vector2f{50, 50},
+                      2.0F, 80.0F, 0.01F},
+      app::ForceField{app::ForceFieldType::DRAG, sf::Vector2f{}, 0.5F, 0.0F,
+                      0.01F}};
+  app::KernelParams params;
+  params.gravityX = 0.37F;
+  params.gravityY = -1.5F;
+  params.thrust = 2.0F;
+  params.maxX = 100.0F;
+  params.maxY = 100.0F;
+  params.aging = 0.05F;
+  params.lifetimeColors = fireTable().data();
+  params.lifetimeMask = fireTable().mask();
+  params.fields = &fields;
+  params.deltaTime = 0.02F;
+
+  for (std::size_t index = 0; index < app::KERNEL_VARIANTS; ++index) {
+    const app::KernelFeatures features = app::kernelFeatures(index);
+    auto reference = makeStore(count);
+    std::vector<std::uint8_t> refMask(count, 2);
+    std::vector<std::uint32_t> refIndices(count, 0);
+    const std::size_t refAlive = app::selectKernel(
+        features, app::KernelIsa::SCALAR)(reference, begin, count, params,
+                                          refMask.data(), refIndices.data());
+    for (auto isa : {app::KernelIsa::SSE2, app::KernelIsa::AVX2}) {
+      if (!app::isKernelIsaSupported(isa)) {
+        continue;
+      }
+      auto store = makeStore(count);
+      std::vector<std::uint8_t> mask(count, 2);
+      std::vector<std::uint32_t> indices(count, 0);
+      const std::size_t alive = app::selectKernel(features, isa)(
+          store, begin, count, params, mask.data(), indices.data());
+      INFO("variant " << index << ", isa " << static_cast<int>(isa));
+      REQUIRE(alive == refAlive);
+      REQUIRE(sameBits(store.x, reference.x));
+      REQUIRE(sameBits(store.y, reference.y));
+      REQUIRE(sameBits(store.vx, reference.vx));
+      REQUIRE(sameBits(store.vy, reference.vy));
+      REQUIRE(sameBits(store.color, reference.color));
+      REQUIRE(sameBits(store.age, reference.age));
+      REQUIRE(mask == refMask);
+      REQUIRE(std::equal(indices.begin() + begin,
+                         indices.begin() + static_cast<long>(begin + alive),
+                         refIndices.begin() + begin));
+    }
+  }
+}
+
+TEST_CASE("Kernels without a feature match kernels with it neutral",
+          "[kernel]") {
+  constexpr std::size_t count = 517;
+  app::KernelParams params;
+  params.thrust = 2.0F;
+  params.maxX = 100.0F;
+  params.maxY = 100.0F;
+  REQUIRE(app::kernelFeaturesOf(params) == app::KernelFeatures{});
+
+  auto lean = makeStore(count);
+  auto full = makeStore(count);
+  std::vector<std::uint8_t> mask(count);
+  std::vector<std::uint32_t> indices(count);
+  const std::size_t leanAlive = app::integrateParticles(
+      lean, 0, count, params, mask.data(), indices.data(),
+      app::detectKernelIsa());
+  /* Not dissolve: particles past their lifetime expire even at no aging */
+  const app::KernelFeatures everything{false, true, false,
+                                       app::BoundsMode::CULL};
+  const std::size_t fullAlive = app::selectKernel(
+      everything, app::detectKernelIsa())(full, 0, count, params, mask.data(),
+                                          indices.data());
+  REQUIRE(leanAlive == fullAlive);
+  REQUIRE(sameBits(lean.x, full.x));
+  REQUIRE(sameBits(lean.vx, full.vx));
+  REQUIRE(sameBits(lean.color, full.color));
+}
+
+TEST_CASE("Wrapping and bouncing keep particles on the canvas", "[kernel]") {
+  constexpr std::size_t count = 1000;
+  app::KernelParams params;
+  params.thrust = 30.0F;
+  params.maxX = 100.0F;
+  params.maxY = 100.0F;
+  for (auto mode : {app::BoundsMode::WRAP, app::BoundsMode::BOUNCE}) {
+    params.bounds = mode;
+    auto store = makeStore(count);
+    /* Start everyone on the canvas */
+    for (std::size_t i = 0; i < count; ++i) {
+      store.x[i] = std::min(std::max(store.x[i], 0.0F), 100.0F);
+      store.y[i] = std::min(std::max(store.y[i], 0.0F), 100.0F);
+    }
+    const auto before = store.vx;
+    std::vector<std::uint8_t> mask(count);
+    std::vector<std::uint32_t> indices(count);
+    REQUIRE(app::integrateParticles(store, 0, count, params, mask.data(),
+                                    indices.data(),
+                                    app::detectKernelIsa()) == count);
+    std::size_t flipped{0};
+    for (std::size_t i = 0; i < count; ++i) {
+      REQUIRE(store.x[i] >= 0.0F);
+      REQUIRE(store.x[i] <= 100.0F);
+      REQUIRE(store.y[i] >= 0.0F);
+      REQUIRE(store.y[i] <= 100.0F);
+      flipped += static_cast<std::size_t>(store.vx[i] == -before[i] &&
+                                          before[i] != 0.0F);
+    }
+    REQUIRE((flipped > 0) == (mode == app::BoundsMode::BOUNCE));
+  }
+}
+
+TEST_CASE("Particles that cross several canvases in a step still land on "
+          "it",
+          "[kernel]") {
+  constexpr std::size_t count = 64;
+  app::KernelParams params;
+  params.thrust = 100.0F;
+  params.maxX = 100.0F;
+  params.maxY = 100.0F;
+  for (auto mode : {app::BoundsMode::WRAP, app::BoundsMode::BOUNCE}) {
+    params.bounds = mode;
+    app::ParticleStore store;
+    for (std::size_t i = 0; i < count; ++i) {
+      /* Up to 20 canvases either way */
+      const float speed = static_cast<float>(i) * 0.65F - 20.0F;
+      store.push(sf::Vector2f{50.0F, 25.0F}, sf::Vector2f{speed, -speed},
+                 sf::Color::White, 1.0F);
+    }
+    std::vector<std::uint8_t> mask(count);
+    std::vector<std::uint32_t> indices(count);
+    REQUIRE(app::integrateParticles(store, 0, count, params, mask.data(),
+                                    indices.data(),
+                                    app::detectKernelIsa()) == count);
+    for (std::size_t i = 0; i < count; ++i) {
+      REQUIRE(store.x[i] >= 0.0F);
+      REQUIRE(store.x[i] <= 100.0F);
+      REQUIRE(store.y[i] >= 0.0F);
+      REQUIRE(store.y[i] <= 100.0F);
+      if (mode == app::BoundsMode::WRAP) {
+        /* Where the particle ends up on a repeating canvas, where 0 and
+         * 100 are the same place */
+        const float x = 50.0F + store.vx[i] * 100.0F;
+        const float off =
+            std::abs(store.x[i] - (x - 100.0F * std::floor(x / 100.0F)));
+        REQUIRE(std::min(off, 100.0F - off) < 1e-3F);
+      }
+    }
+  }
+}
+
+TEST_CASE("Interpolation keeps particles the edges moved in place",
+          "[system]") {
+  for (auto mode : {app::BoundsMode::WRAP, app::BoundsMode::BOUNCE}) {
+    for (bool compact : {false, true}) {
+      app::ParticleSystem system{sf::Vector2u{100, 100}};
+      system.setBoundsMode(mode);
+      system.setGravity(0.0F, 0.0F);
+      /* One particle about to cross the right edge, one in the middle;
+       * both move 5px per step */
+      app::ParticleStore store;
+      store.push(sf::Vector2f{98.0F, 50.0F}, sf::Vector2f{2.5F, 0.0F},
+                 sf::Color::White, 10.0F);
+      store.push(sf::Vector2f{50.0F, 50.0F}, sf::Vector2f{2.5F, 0.0F},
+                 sf::Color::White, 10.0F);
+      system.setParticles(store);
+      system.setCompact(compact);
+      system.update(0.02F);
+
+      app::ParticleSnapshot snapshot;
+      system.snapshot(snapshot);
+      std::vector<sf::Vertex> now;
+      std::vector<sf::Vertex> halfway;
+      snapshot.interpolate(0.5F, halfway);
+      const float landed = mode == app::BoundsMode::WRAP ? 3.0F : 97.0F;
+      REQUIRE(snapshot.current(now)[0].position.x ==
+              Approx(landed).margin(0.01));
+      REQUIRE(halfway[0].position.x == Approx(landed).margin(0.01));
+      REQUIRE(halfway[1].position.x == Approx(52.5F).margin(0.01));
+    }
+  }
+}
+
+TEST_CASE("Compaction keeps survivors in order", "[store]") {
+  auto store = makeStore(10);
+  const auto expected = store.x;
+  const std::vector<std::uint32_t> survivors{1, 2, 5, 9};
+  store.compact(survivors.data(), survivors.size());
+  REQUIRE(store.size() == survivors.size());
+  for (std::size_t i = 0; i < survivors.size(); ++i) {
+    REQUIRE(store.x[i] == expected[survivors[i]]);
+  }
+}
+
+TEST_CASE("Update culls particles leaving the canvas", "[system]") {
+  app::ParticleSystem system{sf::Vector2u{100, 100}};
+  system.setSeed(1);
+  system.emit(5000);
+  REQUIRE(system.getNumberOfParticles() == 5000);
+  /* Every particle travels at most 100px/s from the center */
+  system.update(0.4F);
+  REQUIRE(system.getNumberOfParticles() == 5000);
+  system.update(1.0F);
+  REQUIRE(system.getNumberOfParticles() < 5000);
+  for (const auto &vertex : system.getVertices()) {
+    REQUIRE(vertex.position.x >= 0.0F);
+    REQUIRE(vertex.position.x <= 100.0F);
+  }
+}
+
+TEST_CASE("Emission is reproducible for a given seed", "[system]") {
+  app::ParticleSystem first{sf::Vector2u{800, 600}};
+  app::ParticleSystem second{sf::Vector2u{800, 600}};
+  first.setSeed(1234);
+  second.setSeed(1234);
+  first.emit(10000);
+  second.emit(3);
+  second.emit(9997);
+  const auto &lhs = first.getVertices();
+  const auto &rhs = second.getVertices();
+  REQUIRE(lhs.size() == rhs.size());
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    REQUIRE(lhs[i].position == rhs[i].position);
+    REQUIRE(lhs[i].color == rhs[i].color);
+  }
+}
+
+TEST_CASE("Full pool drops new particles", "[pool]") {
+  app::ParticleSystem system{sf::Vector2u{800, 600}};
+  system.setCapacity(100);
+  system.setOverflowPolicy(app::OverflowPolicy::DROP_NEW);
+  system.emit(60);
+  system.emit(60);
+  system.emit(250);
+  REQUIRE(system.getNumberOfParticles() == 100);
+  REQUIRE(system.getPoolStats().allocated == 100);
+  REQUIRE(system.getPoolStats().recycled == 0);
+  REQUIRE(system.getPoolStats().dropped == 270);
+}
+
+TEST_CASE("Full pool recycles the oldest particles", "[pool]") {
+  app::ParticleSystem system{sf::Vector2u{800, 600}};
+  system.setCapacity(100);
+  system.setOverflowPolicy(app::OverflowPolicy::RECYCLE_OLDEST);
+  system.setPosition(10.0F, 10.0F);
+  system.emit(70);
+  system.setPosition(20.0F, 20.0F);
+  system.emit(70);
+  REQUIRE(system.getNumberOfParticles() == 100);
+  REQUIRE(system.getPoolStats().allocated == 100);
+  REQUIRE(system.getPoolStats().recycled == 40);
+  /* The 30 youngest of the first batch survive, still in front */
+  const auto &vertices = system.getVertices();
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    REQUIRE(vertices[i].position.x == (i < 30 ? 10.0F : 20.0F));
+  }
+}
+
+TEST_CASE("Full pool recycles the most transparent particles", "[pool]") {
+  app::ParticleSystem system{sf::Vector2u{800, 600}};
+  system.setCapacity(100);
+  system.setOverflowPolicy(app::OverflowPolicy::RECYCLE_MOST_TRANSPARENT);
+  system.setDissolve();
+  system.setDissolutionRate(4);
+  system.setLifetime(1.0F, 1.0F);
+  system.emit(50);
+  system.update(0.05F); /* first batch fades a little */
+  system.emit(50);
+  system.update(0.05F); /* first batch twice as much as the second */
+  const sf::Uint8 older = system.getVertices().front().color.a;
+  REQUIRE(older < system.getVertices().back().color.a);
+  system.emit(30);
+  REQUIRE(system.getNumberOfParticles() == 100);
+  REQUIRE(system.getPoolStats().recycled == 30);
+  std::size_t faint{0};
+  for (const auto &vertex : system.getVertices()) {
+    faint += vertex.color.a == older ? 1 : 0;
+  }
+  REQUIRE(faint == 20);
+}
+
+TEST_CASE("Shrinking the pool evicts the oldest particles", "[pool]") {
+  app::ParticleSystem system{sf::Vector2u{800, 600}};
+  system.setPosition(10.0F, 10.0F);
+  system.emit(50);
+  system.setPosition(20.0F, 20.0F);
+  system.emit(50);
+  system.setCapacity(50);
+  REQUIRE(system.getNumberOfParticles() == 50);
+  REQUIRE(system.getVertices().front().position.x == 20.0F);
+}
+
+TEST_CASE("A lower budget culls without touching the pool", "[pool]") {
+  app::ParticleSystem system{sf::Vector2u{800, 600}};
+  system.setCapacity(200);
+  system.setOverflowPolicy(app::OverflowPolicy::DROP_NEW);
+  system.setPosition(10.0F, 10.0F);
+  system.emit(100);
+  system.setPosition(20.0F, 20.0F);
+  system.emit(100);
+  system.setBudget(150);
+  REQUIRE(system.getCapacity() == 200);
+  REQUIRE(system.getNumberOfParticles() == 150);
+  REQUIRE(system.getPoolStats().culled == 50);
+  REQUIRE(system.getVertices()[49].position.x == 10.0F);
+  REQUIRE(system.getVertices()[50].position.x == 20.0F);
+
+  /* Emission sees the budget as the limit */
+  system.emit(10);
+  REQUIRE(system.getNumberOfParticles() == 150);
+  REQUIRE(system.getPoolStats().dropped == 10);
+
+  /* A budget above the capacity leaves the capacity in charge */
+  system.setBudget(500);
+  system.emit(100);
+  REQUIRE(system.getNumberOfParticles() == 200);
+  system.setBudget(0);
+  REQUIRE(system.getNumberOfParticles() == 200);
+  REQUIRE(system.getPoolStats().culled == 50);
+}
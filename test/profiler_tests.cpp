@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "detail/Profiler.hpp"
+
+TEST_CASE("Profile ring keeps the newest events", "[profiler]") {
+  auto ring = std::make_unique<app::ProfileRing>(0);
+  constexpr std::int64_t extra = 10;
+  constexpr auto total =
+      static_cast<std::int64_t>(app::ProfileRing::CAPACITY) + extra;
+  for (std::int64_t i = 0; i < total; ++i) {
+    ring->push("phase", i, i + 1);
+  }
+  std::pmr::vector<app::ProfileEvent> events;
+  ring->read(events);
+  REQUIRE(events.size() == app::ProfileRing::CAPACITY);
+  REQUIRE(events.front().begin == extra);
+  REQUIRE(events.back().begin == total - 1);
+}
+
+TEST_CASE("Profile ring reader never sees torn events", "[profiler]") {
+  auto ring = std::make_unique<app::ProfileRing>(0);
+  constexpr std::int64_t count = 200000;
+  std::thread writer([&]() {
+    for (std::int64_t i = 0; i < count; ++i) {
+      ring->push("phase", i, 2 * i + 1);
+    }
+  });
+  bool consistent = true;
+  std::pmr::vector<app::ProfileEvent> events;
+  for (int pass = 0; pass < 200; ++pass) {
+    events.clear();
+    ring->read(events);
+    for (std::size_t i = 0; i < events.size(); ++i) {
+      consistent = consistent && events[i].end == 2 * events[i].begin + 1 &&
+                   (i == 0 || events[i].begin == events[i - 1].begin + 1);
+    }
+  }
+  writer.join();
+  REQUIRE(consistent);
+}
+
+TEST_CASE("Threads that have finished hand their rings on", "[profiler]") {
+  for (int i = 0; i < 8; ++i) {
+    std::thread worker([]() { app::Profiler::record("test::reuse", 0, 1); });
+    worker.join();
+  }
+  std::vector<std::uint32_t> threads;
+  for (const auto &event : app::Profiler::events()) {
+    if (event.name != nullptr && std::string{event.name} == "test::reuse") {
+      threads.push_back(event.thread);
+    }
+  }
+  REQUIRE(threads.size() == 8);
+  REQUIRE(std::count(threads.begin(), threads.end(), threads.front()) == 8);
+}
+
+TEST_CASE("Profiler reports percentiles and exports a Chrome trace",
+          "[profiler]") {
+  std::thread recorder([]() {
+    app::Profiler::setThreadName("recorder");
+    /* 1..100 us */
+    for (std::int64_t i = 1; i <= 100; ++i) {
+      app::Profiler::record("test::phase", 0, i * 1000);
+    }
+  });
+  recorder.join();
+
+  bool found = false;
+  for (const auto &phase : app::Profiler::summary()) {
+    if (phase.name == "test::phase") {
+      found = true;
+      REQUIRE(phase.count == 100);
+      REQUIRE(phase.p50 == Approx(50.0));
+      REQUIRE(phase.p95 == Approx(95.0));
+      REQUIRE(phase.p99 == Approx(99.0));
+    }
+  }
+  REQUIRE(found);
+
+  const std::string path = "profiler_tests_trace.json";
+  REQUIRE(app::Profiler::exportChromeTrace(path));
+  std::ifstream file{path};
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  file.close();
+  const std::string trace = contents.str();
+  std::remove(path.c_str());
+  REQUIRE(trace.rfind("{\"traceEvents\":[", 0) == 0);
+  REQUIRE(trace.find(R"("name":"test::phase","ph":"X")") != std::string::npos);
+  REQUIRE(trace.find(R"("args":{"name":"recorder"})") != std::string::npos);
+}
@@ -0,0 +1,154 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ParticleStore.hpp"
+#include "Rasterizer.hpp"
+#include "detail/ThreadPool.hpp"
+
+namespace {
+
+/* sf::BlendAlpha with the 8 bit framebuffer of a window, in floats */
+sf::Color blendReference(const sf::Color &dst, const sf::Color &src) {
+  const float alpha = static_cast<float>(src.a) / 255.0F;
+  const auto channel = [alpha](sf::Uint8 s, sf::Uint8 d) {
+    return static_cast<sf::Uint8>(std::lround(
+        static_cast<float>(s) * alpha + static_cast<float>(d) * (1 - alpha)));
+  };
+  const auto coverage = static_cast<sf::Uint8>(std::lround(
+      static_cast<float>(src.a) + static_cast<float>(dst.a) * (1 - alpha)));
+  return sf::Color{channel(src.r, dst.r), channel(src.g, dst.g),
+                   channel(src.b, dst.b), coverage};
+}
+
+/* One point after the other, no tiles, no threads */
+std::vector<sf::Color> rasterizeReference(const app::ParticleStore &store,
+                                          sf::Vector2u size,
+                                          const sf::Color &clear) {
+  std::vector<sf::Color> pixels(static_cast<std::size_t>(size.x) * size.y,
+                                clear);
+  for (std::size_t i = 0; i < store.size(); ++i) {
+    const float x = store.x[i];
+    const float y = store.y[i];
+    if (x >= 0 && y >= 0 && x < static_cast<float>(size.x) &&
+        y < static_cast<float>(size.y)) {
+      sf::Color &pixel = pixels[static_cast<std::size_t>(y) * size.x +
+                                static_cast<std::size_t>(x)];
+      pixel = blendReference(pixel, store.color[i]);
+    }
+  }
+  return pixels;
+}
+
+void push(app::ParticleStore &store, float x, float y,
+          const sf::Color &color) {
+  store.resize(store.size() + 1);
+  store.x.back() = x;
+  store.y.back() = y;
+  store.vx.back() = 0;
+  store.vy.back() = 0;
+  store.color.back() = color;
+}
+
+}  // namespace
+
+TEST_CASE("Points blend into their pixel like sf::Points", "[rasterizer]") {
+  app::ThreadPool pool{2};
+  app::Rasterizer rasterizer{sf::Vector2u{4, 3}};
+  rasterizer.setThreadPool(pool);
+  rasterizer.clear(sf::Color{10, 20, 30});
+
+  app::ParticleStore store;
+  push(store, 1.9F, 0.2F, sf::Color{200, 100, 0, 128});
+  push(store, 1.0F, 0.0F, sf::Color{0, 0, 255, 64});  /* same pixel, later */
+  push(store, 3.5F, 2.5F, sf::Color{255, 255, 255});  /* opaque */
+  push(store, 0.5F, 2.0F, sf::Color{255, 0, 0, 0});   /* transparent */
+  push(store, 4.0F, 1.0F, sf::Color::White);          /* just off the right */
+  push(store, -0.1F, 1.0F, sf::Color::White);         /* just off the left */
+  rasterizer.draw(store);
+
+  const sf::Color background{10, 20, 30};
+  const sf::Color first =
+      blendReference(background, sf::Color{200, 100, 0, 128});
+  REQUIRE(rasterizer.getPixel(1, 0) ==
+          blendReference(first, sf::Color{0, 0, 255, 64}));
+  REQUIRE(rasterizer.getPixel(3, 2) == sf::Color::White);
+  REQUIRE(rasterizer.getPixel(0, 2) == background);
+  REQUIRE(rasterizer.getPixel(3, 1) == background);
+  REQUIRE(rasterizer.getPixel(0, 1) == background);
+}
+
+TEST_CASE("Tiled parallel rasterization matches one point at a time",
+          "[rasterizer]") {
+  /* Not a multiple of the tile size, so the edge tiles are partial */
+  const sf::Vector2u size{2 * app::Rasterizer::TILE + 17,
+                          app::Rasterizer::TILE + 5};
+  std::mt19937 random{7};
+  std::uniform_real_distribution<float> x{-20.0F,
+                                          static_cast<float>(size.x) + 20};
+  std::uniform_real_distribution<float> y{-20.0F,
+                                          static_cast<float>(size.y) + 20};
+  std::uniform_int_distribution<int> byte{0, 255};
+  app::ParticleStore store;
+  for (int i = 0; i < 200000; ++i) {
+    push(store, x(random), y(random),
+         sf::Color{static_cast<sf::Uint8>(byte(random)),
+                   static_cast<sf::Uint8>(byte(random)),
+                   static_cast<sf::Uint8>(byte(random)),
+                   static_cast<sf::Uint8>(byte(random))});
+  }
+  push(store, std::numeric_limits<float>::quiet_NaN(), 3.0F, sf::Color::Red);
+  const sf::Color clear{0, 0, 0};
+  const auto expected = rasterizeReference(store, size, clear);
+
+  for (const std::size_t threads : {std::size_t{1}, std::size_t{4}}) {
+    app::ThreadPool pool{threads};
+    app::Rasterizer rasterizer{size};
+    rasterizer.setThreadPool(pool);
+    rasterizer.clear(clear);
+    rasterizer.draw(store);
+    REQUIRE(rasterizer.getPixels() == expected);
+
+    /* The vertex path of the render thread splats the same */
+    std::vector<sf::Vertex> vertices(store.size());
+    for (std::size_t i = 0; i < store.size(); ++i) {
+      vertices[i].position = {store.x[i], store.y[i]};
+      vertices[i].color = store.color[i];
+    }
+    rasterizer.clear(clear);
+    rasterizer.draw(vertices);
+    REQUIRE(rasterizer.getPixels() == expected);
+  }
+}
+
+TEST_CASE("Frames are saved as binary PPM", "[rasterizer]") {
+  app::ThreadPool pool{1};
+  app::Rasterizer rasterizer{sf::Vector2u{3, 2}};
+  rasterizer.setThreadPool(pool);
+  rasterizer.clear(sf::Color{1, 2, 3});
+  app::ParticleStore store;
+  push(store, 2.0F, 1.0F, sf::Color{250, 251, 252});
+  rasterizer.draw(store);
+
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "rasterizer_tests.ppm")
+          .string();
+  REQUIRE(rasterizer.save(path));
+  std::vector<char> bytes(std::filesystem::file_size(path));
+  {
+    std::ifstream in{path, std::ios::binary};
+    in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  }
+  const std::string header{"P6\n3 2\n255\n"};
+  REQUIRE(bytes.size() == header.size() + 3 * 2 * 3);
+  REQUIRE(std::string(bytes.begin(), bytes.begin() + 11) == header);
+  REQUIRE(bytes[header.size()] == 1);
+  REQUIRE(static_cast<unsigned char>(bytes[bytes.size() - 3]) == 250);
+  REQUIRE(static_cast<unsigned char>(bytes[bytes.size() - 1]) == 252);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,257 @@
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Command.hpp"
+#include "EmitterManager.hpp"
+#include "ParticleSystem.hpp"
+#include "Recording.hpp"
+#include "detail/ThreadPool.hpp"
+
+namespace {
+
+const sf::Vector2u CANVAS{400, 300};
+constexpr float DELTA_TIME = 0.02F;
+constexpr std::uint64_t STEPS = 120;
+
+std::string logPath(const char *name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+bool sameParticles(const app::ParticleSystem &a,
+                   const app::ParticleSystem &b) {
+  const app::ParticleStore &left = a.getParticles();
+  const app::ParticleStore &right = b.getParticles();
+  return left.x == right.x && left.y == right.y && left.vx == right.vx &&
+         left.vy == right.vy && left.color == right.color;
+}
+
+/* Drives a session the way the app does: input between steps, every
+ * change as a command. Returns the live system after the last step. */
+void recordSession(const std::string &path, std::uint64_t checkpoints,
+                   app::ParticleSystem &system) {
+  app::EmitterManager emitters;
+  system.setCapacity(6000);
+  system.setOverflowPolicy(app::OverflowPolicy::RECYCLE_OLDEST);
+  system.addForceField({app::ForceFieldType::NOISE, {}, 1.0F, 0.0F, 0.01F});
+  system.emit(500);
+
+  app::Recorder recorder;
+  REQUIRE(recorder.open(path, system, emitters, DELTA_TIME, checkpoints));
+  const auto apply = [&](const app::Command &command) {
+    app::applyCommand(command, system, emitters);
+    recorder.record(command);
+  };
+  for (std::uint64_t step = 0; step < STEPS; ++step) {
+    const float t = static_cast<float>(step);
+    apply(app::Command::setPosition({100.0F + t, 150.0F}));
+    if (step % 3 == 0) {
+      apply(app::Command::emit(200));
+    }
+    if (step == 10) {
+      app::Emitter emitter;
+      emitter.position = {300.0F, 100.0F};
+      emitter.rate = 3000.0F;
+      apply(app::Command::addEmitter(emitter));
+      apply(app::Command::setBounds(app::BoundsMode::BOUNCE));
+    }
+    if (step == 20) {
+      apply(app::Command::setSpatialSort(25, 0.3F));
+    }
+    if (step == 30) {
+      apply(app::Command::setShards(3));
+    }
+    if (step == 40) {
+      apply(app::Command::setGravity({0.0F, 30.0F}));
+      apply(app::Command::addPairForce(
+          {app::PairForceType::REPULSION, 6.0F, 2.0F}));
+      apply(app::Command::setDissolve(true));
+    }
+    if (step == 55) {
+      apply(app::Command::setCompact(true));
+    }
+    if (step == 70) {
+      apply(app::Command::setField(
+          1, {app::ForceFieldType::VORTEX, {200.0F, 150.0F}, 2.0F, 150.0F}));
+      apply(app::Command::setShape(app::Shape::SQUARE));
+      apply(app::Command::clearEmitters());
+      apply(app::Command::setBudget(800));
+    }
+    emitters.emit(system, DELTA_TIME);
+    system.update(DELTA_TIME);
+    recorder.step(system, emitters);
+  }
+  recorder.close();
+}
+
+}  // namespace
+
+TEST_CASE("A replay reproduces the recorded run bit for bit", "[recording]") {
+  app::ThreadPool pool{4};
+  const std::string path = logPath("recording_tests_replay.sfrec");
+  app::ParticleSystem live{CANVAS};
+  live.setThreadPool(pool);
+  recordSession(path, 0, live);
+
+  app::Replayer replayer;
+  std::string error;
+  REQUIRE(replayer.open(path, error));
+  REQUIRE(replayer.getSteps() == STEPS);
+  REQUIRE(replayer.getDeltaTime() == DELTA_TIME);
+  REQUIRE(replayer.getCheckpoints().empty());
+
+  /* Different canvas and seed: the log has to restore both */
+  app::ParticleSystem replayed{sf::Vector2u{10, 10}};
+  replayed.setThreadPool(pool);
+  replayed.setSeed(12345);
+  app::EmitterManager emitters;
+  REQUIRE(replayer.seek(0, replayed, emitters));
+  REQUIRE(replayed.getNumberOfParticles() == 500);
+  while (replayer.step(replayed, emitters)) {
+  }
+  REQUIRE(replayer.getStep() == STEPS);
+  REQUIRE(replayed.getNumberOfParticles() == live.getNumberOfParticles());
+  REQUIRE(sameParticles(live, replayed));
+  REQUIRE(replayed.getSeed() == live.getSeed());
+  REQUIRE(replayed.getEmitted() == live.getEmitted());
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Seeking from a checkpoint matches replaying from the start",
+          "[recording]") {
+  app::ThreadPool pool{4};
+  const std::string path = logPath("recording_tests_seek.sfrec");
+  app::ParticleSystem live{CANVAS};
+  live.setThreadPool(pool);
+  recordSession(path, 25, live);
+
+  app::Replayer replayer;
+  std::string error;
+  REQUIRE(replayer.open(path, error));
+  REQUIRE(replayer.getCheckpoints() ==
+          std::vector<std::uint64_t>{25, 50, 75, 100});
+
+  for (const std::uint64_t target : {0ULL, 25ULL, 63ULL, 100ULL, 119ULL}) {
+    app::ParticleSystem full{CANVAS};
+    full.setThreadPool(pool);
+    app::EmitterManager fullEmitters;
+    REQUIRE(replayer.seek(0, full, fullEmitters));
+    while (replayer.getStep() < target) {
+      REQUIRE(replayer.step(full, fullEmitters));
+    }
+
+    app::ParticleSystem sought{CANVAS};
+    sought.setThreadPool(pool);
+    app::EmitterManager soughtEmitters;
+    REQUIRE(replayer.seek(target, sought, soughtEmitters));
+    REQUIRE(replayer.getStep() == target);
+    REQUIRE(sameParticles(full, sought));
+    REQUIRE(soughtEmitters.size() == fullEmitters.size());
+
+    /* Both continue to the same end as the live run */
+    while (replayer.step(sought, soughtEmitters)) {
+    }
+    REQUIRE(sameParticles(live, sought));
+  }
+  std::filesystem::remove(path);
+  std::filesystem::remove(path + ".ckpt");
+}
+
+TEST_CASE("Damaged checkpoints fall back to the log", "[recording]") {
+  app::ThreadPool pool{2};
+  const std::string path = logPath("recording_tests_checkpoints.sfrec");
+  app::ParticleSystem live{CANVAS};
+  live.setThreadPool(pool);
+  recordSession(path, 25, live);
+
+  const std::string checkpoints = path + ".ckpt";
+  std::vector<char> bytes(std::filesystem::file_size(checkpoints));
+  {
+    std::ifstream in{checkpoints, std::ios::binary};
+    in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  }
+  /* Overwrites one 64-bit field of the first checkpoint's header */
+  const auto damage = [&](std::size_t offset, std::uint64_t value) {
+    std::vector<char> damaged = bytes;
+    std::memcpy(damaged.data() + offset, &value, sizeof(value));
+    std::ofstream out{checkpoints, std::ios::binary | std::ios::trunc};
+    out.write(damaged.data(), static_cast<std::streamsize>(damaged.size()));
+  };
+  constexpr std::size_t BLOCK_BYTES = 32;
+  constexpr std::size_t COUNT = 48;
+
+  app::Replayer replayer;
+  std::string error;
+  SECTION("block larger than the file") {
+    damage(BLOCK_BYTES, std::uint64_t{1} << 60U);
+    REQUIRE(replayer.open(path, error));
+    REQUIRE(replayer.getCheckpoints().empty());
+  }
+  SECTION("particle count that overflows the block size") {
+    damage(COUNT, ~std::uint64_t{0} / 7 + 2);
+    REQUIRE(replayer.open(path, error));
+    REQUIRE(replayer.getCheckpoints().size() == 4);
+  }
+  /* Either way seeking replays from the start of the log instead */
+  app::ParticleSystem sought{CANVAS};
+  sought.setThreadPool(pool);
+  app::EmitterManager emitters;
+  REQUIRE(replayer.seek(30, sought, emitters));
+  REQUIRE(replayer.getStep() == 30);
+  while (replayer.step(sought, emitters)) {
+  }
+  REQUIRE(sameParticles(live, sought));
+  std::filesystem::remove(path);
+  std::filesystem::remove(checkpoints);
+}
+
+TEST_CASE("Damaged logs are rejected when opened", "[recording]") {
+  app::ThreadPool pool{2};
+  const std::string path = logPath("recording_tests_damaged.sfrec");
+  app::ParticleSystem live{CANVAS};
+  live.setThreadPool(pool);
+  recordSession(path, 0, live);
+
+  std::vector<char> bytes(std::filesystem::file_size(path));
+  {
+    std::ifstream in{path, std::ios::binary};
+    in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  }
+  const auto write = [&path](const std::vector<char> &data) {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+  };
+  app::Replayer replayer;
+  std::string error;
+
+  SECTION("missing file") {
+    REQUIRE_FALSE(replayer.open(path + ".missing", error));
+  }
+  SECTION("wrong magic") {
+    std::vector<char> damaged = bytes;
+    damaged[0] = 'X';
+    write(damaged);
+    REQUIRE_FALSE(replayer.open(path, error));
+  }
+  SECTION("truncated state") {
+    write(std::vector<char>(bytes.begin(), bytes.begin() + 100));
+    REQUIRE_FALSE(replayer.open(path, error));
+  }
+  SECTION("unknown command") {
+    /* The last byte is the type of the end record */
+    std::vector<char> damaged = bytes;
+    damaged.back() = 0x42;
+    write(damaged);
+    REQUIRE_FALSE(replayer.open(path, error));
+    REQUIRE_FALSE(error.empty());
+  }
+  SECTION("cut inside a command") {
+    write(std::vector<char>(bytes.begin(), bytes.end() - 3));
+    REQUIRE_FALSE(replayer.open(path, error));
+  }
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,157 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "PairForce.hpp"
+#include "ParticleStore.hpp"
+#include "ParticleSystem.hpp"
+#include "SpatialGrid.hpp"
+#include "TestParticles.hpp"
+#include "detail/ThreadPool.hpp"
+
+namespace {
+
+/* Over and slightly outside a 100x80 canvas */
+constexpr app::test::Bounds AROUND_CANVAS{-5.0F, -5.0F, 105.0F, 85.0F};
+
+}  // namespace
+
+TEST_CASE("Spatial grid sorts every particle into its cell", "[grid]") {
+  const auto store = app::test::scatter(5000, 11, AROUND_CANVAS);
+  app::ThreadPool pool{4};
+  app::SpatialGrid grid;
+  grid.setCellSize(7.0F);
+  grid.setBounds(100.0F, 80.0F);
+  grid.build(store, pool);
+
+  REQUIRE(grid.getColumns() == 15);
+  REQUIRE(grid.getRows() == 12);
+  REQUIRE(grid.size() == store.size());
+  const auto &start = grid.cellStart();
+  REQUIRE(start.back() == store.size());
+
+  std::vector<int> seen(store.size(), 0);
+  for (std::size_t cell = 0; cell + 1 < start.size(); ++cell) {
+    std::uint32_t previous{0};
+    for (std::uint32_t slot = start[cell]; slot < start[cell + 1]; ++slot) {
+      const std::uint32_t index = grid.order()[slot];
+      ++seen[index];
+      REQUIRE(grid.cellOf(store.x[index], store.y[index]) == cell);
+      REQUIRE(grid.x()[slot] == store.x[index]);
+      REQUIRE(grid.vy()[slot] == store.vy[index]);
+      /* Stable: store order within a cell */
+      REQUIRE((slot == start[cell] || index > previous));
+      previous = index;
+    }
+  }
+  for (int count : seen) {
+    REQUIRE(count == 1);
+  }
+}
+
+TEST_CASE("Grid pair forces match brute force", "[grid]") {
+  const auto store = app::test::scatter(2000, 11, AROUND_CANVAS);
+  app::ThreadPool pool{4};
+  app::SpatialGrid grid;
+  /* Smaller cells than the radius make the search span several cells */
+  grid.setCellSize(3.0F);
+  grid.setBounds(100.0F, 80.0F);
+  grid.build(store, pool);
+
+  for (auto type : {app::PairForceType::REPULSION,
+                    app::PairForceType::COHESION,
+                    app::PairForceType::COLLISION}) {
+    const std::vector<app::PairForce> forces{{type, 8.0F, 0.5F}};
+    std::vector<float> dvx(store.size(), 0.0F);
+    std::vector<float> dvy(store.size(), 0.0F);
+    app::accumulatePairForces(grid, pool, forces, 0.1F, store.size(),
+                              dvx.data(), dvy.data());
+
+    for (std::size_t slot = 0; slot < store.size(); slot += 37) {
+      const std::uint32_t i = grid.order()[slot];
+      float expectX{0};
+      float expectY{0};
+      int found{0};
+      for (std::size_t j = 0; j < store.size(); ++j) {
+        const float dx = store.x[j] - store.x[i];
+        const float dy = store.y[j] - store.y[i];
+        const float dist2 = dx * dx + dy * dy;
+        if (j == i || dist2 >= 64.0F) {
+          continue;
+        }
+        const app::PairSample sample{dx, dy, store.vx[j] - store.vx[i],
+                                     store.vy[j] - store.vy[i], dist2};
+        sf::Vector2f dv;
+        switch (type) {
+          case app::PairForceType::REPULSION:
+            dv = app::RepulsionKernel{8.0F, 0.05F}(sample);
+            break;
+          case app::PairForceType::COHESION:
+            dv = app::CohesionKernel{8.0F, 0.05F}(sample);
+            break;
+          case app::PairForceType::COLLISION:
+            dv = app::CollisionKernel{8.0F, 0.5F}(sample);
+            break;
+        }
+        expectX += dv.x;
+        expectY += dv.y;
+        ++found;
+      }
+      if (type == app::PairForceType::COLLISION && found > 0) {
+        expectX /= static_cast<float>(found);
+        expectY /= static_cast<float>(found);
+      }
+      REQUIRE(dvx[slot] == Approx(expectX).margin(1e-5));
+      REQUIRE(dvy[slot] == Approx(expectY).margin(1e-5));
+    }
+  }
+}
+
+TEST_CASE("Pair forces are independent of the thread count", "[grid]") {
+  auto run = [](std::size_t threads) {
+    app::ThreadPool pool{threads};
+    app::ParticleSystem system{sf::Vector2u{200, 200}};
+    system.setThreadPool(pool);
+    system.setSeed(5);
+    system.addPairForce({app::PairForceType::REPULSION, 6.0F, 3.0F});
+    system.addPairForce({app::PairForceType::COLLISION, 2.0F, 0.8F});
+    for (int step = 0; step < 20; ++step) {
+      system.emit(3000);
+      system.update(0.02F);
+    }
+    app::ParticleSnapshot snapshot;
+    system.snapshot(snapshot);
+    return snapshot.previous;
+  };
+  const auto serial = run(1);
+  const auto parallel = run(4);
+  REQUIRE(serial.size() == parallel.size());
+  for (std::size_t i = 0; i < serial.size(); ++i) {
+    REQUIRE(serial[i] == parallel[i]);
+  }
+}
+
+TEST_CASE("Repulsion pushes a close pair apart", "[grid]") {
+  app::ThreadPool pool{1};
+  app::ParticleSystem system{sf::Vector2u{100, 100}};
+  system.setThreadPool(pool);
+  system.addPairForce({app::PairForceType::REPULSION, 8.0F, 10.0F});
+  /* Same seed, same velocity: any relative motion comes from the force */
+  system.setSeed(3);
+  system.setPosition(50.0F, 50.0F);
+  system.emit(1);
+  system.setSeed(3);
+  system.setPosition(54.0F, 50.0F);
+  system.emit(1);
+  system.setParticleSpeed(10.0F);
+  system.update(0.1F);
+
+  app::ParticleSnapshot snapshot;
+  system.snapshot(snapshot);
+  REQUIRE(snapshot.vertices.size() == 2);
+  const sf::Vector2f gap =
+      snapshot.vertices[1].position - snapshot.vertices[0].position;
+  REQUIRE(gap.x > 4.5F);
+  REQUIRE(gap.y == Approx(0.0F).margin(1e-5));
+}
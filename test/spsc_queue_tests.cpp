@@ -0,0 +1,73 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <thread>
+
+#include "Command.hpp"
+#include "detail/SpscQueue.hpp"
+
+TEST_CASE("SPSC queue is first in, first out and bounded", "[spscqueue]") {
+  app::SpscQueue<int> queue{5};
+  REQUIRE(queue.capacity() == 8);
+  int value{0};
+  REQUIRE_FALSE(queue.pop(value));
+  for (int i = 0; i < 8; ++i) {
+    REQUIRE(queue.push(i));
+  }
+  REQUIRE_FALSE(queue.push(8));
+
+  REQUIRE(queue.pop(value));
+  REQUIRE(value == 0);
+  /* Freed slots are reused across the wrap */
+  REQUIRE(queue.push(8));
+  for (int i = 1; i <= 8; ++i) {
+    REQUIRE(queue.pop(value));
+    REQUIRE(value == i);
+  }
+  REQUIRE_FALSE(queue.pop(value));
+}
+
+TEST_CASE("SPSC queue hands commands over in order across threads",
+          "[spscqueue]") {
+  app::SpscQueue<app::Command> queue{16};
+  constexpr std::uint32_t count = 200000;
+  std::atomic<bool> stop{false};     /*< Consumer gave up */
+  std::atomic<bool> finished{false}; /*< Producer pushed everything */
+  std::thread producer([&]() {
+    for (std::uint32_t i = 1; i <= count; ++i) {
+      const app::Command command =
+          i % 2 == 0 ? app::Command::emit(i)
+                     : app::Command::setDissolutionRate(i);
+      while (!queue.push(command)) {
+        if (stop) {
+          return;
+        }
+        std::this_thread::yield();
+      }
+    }
+    finished = true;
+  });
+  std::uint32_t last = 0;
+  bool ordered = true;
+  app::Command command;
+  /* A lost or reordered command fails at once rather than hanging */
+  while (ordered && last != count) {
+    const bool drained = finished;
+    if (!queue.pop(command)) {
+      if (drained) {
+        break;
+      }
+      std::this_thread::yield();
+      continue;
+    }
+    const auto expected = command.count % 2 == 0
+                              ? app::CommandType::EMIT
+                              : app::CommandType::SET_DISSOLUTION_RATE;
+    ordered = command.count == last + 1 && command.type == expected;
+    last = command.count;
+  }
+  stop = true;
+  producer.join();
+  REQUIRE(ordered);
+  REQUIRE(last == count);
+}
@@ -0,0 +1,64 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <numeric>
+#include <vector>
+
+#include "ParticleSystem.hpp"
+#include "detail/ThreadPool.hpp"
+
+TEST_CASE("parallelFor visits every index exactly once", "[threadpool]") {
+  app::ThreadPool pool{4};
+  REQUIRE(pool.concurrency() == 4);
+  std::vector<int> visits(100000, 0);
+  pool.parallelFor(0, visits.size(), 1000,
+                   [&](std::size_t begin, std::size_t end) {
+                     for (std::size_t i = begin; i < end; ++i) {
+                       ++visits[i];
+                     }
+                   });
+  REQUIRE(std::accumulate(visits.begin(), visits.end(), 0) == 100000);
+  REQUIRE(std::all_of(visits.begin(), visits.end(),
+                      [](int count) { return count == 1; }));
+}
+
+TEST_CASE("Nested parallelFor completes", "[threadpool]") {
+  app::ThreadPool pool{3};
+  std::atomic<std::size_t> total{0};
+  pool.parallelFor(0, 16, 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      pool.parallelFor(0, 1000, 10, [&](std::size_t first, std::size_t last) {
+        total += last - first;
+      });
+    }
+  });
+  REQUIRE(total == 16000);
+}
+
+TEST_CASE("Parallel update matches a single-threaded run", "[threadpool]") {
+  app::ThreadPool serial{1};
+  app::ThreadPool parallel{4};
+  app::ParticleSystem lhs{sf::Vector2u{640, 480}};
+  app::ParticleSystem rhs{sf::Vector2u{640, 480}};
+  lhs.setThreadPool(serial);
+  rhs.setThreadPool(parallel);
+  for (auto *system : {&lhs, &rhs}) {
+    system->setSeed(99);
+    system->setPosition(600.0F, 240.0F);
+    system->setGravity(0.0F, 0.5F);
+    system->setDissolve();
+    system->emit(200000);
+  }
+  for (int step = 0; step < 20; ++step) {
+    lhs.update(0.05F);
+    rhs.update(0.05F);
+  }
+  REQUIRE(lhs.getNumberOfParticles() == rhs.getNumberOfParticles());
+  REQUIRE(lhs.getNumberOfParticles() > 0);
+  REQUIRE(lhs.getNumberOfParticles() < 200000);
+  const auto &left = lhs.getVertices();
+  const auto &right = rhs.getVertices();
+  for (std::size_t i = 0; i < left.size(); ++i) {
+    REQUIRE(left[i].position == right[i].position);
+    REQUIRE(left[i].color == right[i].color);
+  }
+}
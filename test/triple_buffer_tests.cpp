@@ -0,0 +1,45 @@
+#include <catch2/catch.hpp>
+#include <thread>
+
+#include "detail/TripleBuffer.hpp"
+
+TEST_CASE("Triple buffer hands over the latest value", "[triplebuffer]") {
+  app::TripleBuffer<int> buffer;
+  REQUIRE_FALSE(buffer.update());
+  buffer.back() = 1;
+  buffer.publish();
+  buffer.back() = 2;
+  buffer.publish();
+  REQUIRE(buffer.update());
+  REQUIRE(buffer.front() == 2);
+  REQUIRE_FALSE(buffer.update());
+  REQUIRE(buffer.front() == 2);
+}
+
+TEST_CASE("Triple buffer reader never sees stale or torn values",
+          "[triplebuffer]") {
+  struct Pair {
+    int first{0};
+    int second{0};
+  };
+  app::TripleBuffer<Pair> buffer;
+  constexpr int count = 200000;
+  std::thread writer([&]() {
+    for (int i = 1; i <= count; ++i) {
+      buffer.back() = Pair{i, -i};
+      buffer.publish();
+    }
+  });
+  int last = 0;
+  bool consistent = true;
+  while (last != count) {
+    if (buffer.update()) {
+      const Pair &value = buffer.front();
+      consistent = consistent && value.first == -value.second &&
+                   value.first > last;
+      last = value.first;
+    }
+  }
+  writer.join();
+  REQUIRE(consistent);
+}